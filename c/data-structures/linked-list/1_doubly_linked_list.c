@@ -1,12 +1,23 @@
 /*
 - this implementation uses NULL as an indicator of head and tail
-- the append in this implementation assumes that the tail node is not stored: O(n)
-- for fast appends, store the tail and use insert_after(tail, new_node): O(1)
+- the node-level append assumes that the tail node is not stored: O(n)
+- the List handle stores head, tail and size, so list_append and list_length are O(1)
+- every list_* function keeps the handle correct, mixing them with node-level calls on the same list does not
+- merge_sort is the bottom-up natural merge sort of tricks/singly_merge_sort.h, prev pointers are fixed at the end
+- the pool_* functions take their nodes from a NodePool (see node_pool.h) instead of one malloc per node
+- a list built only from pool nodes is freed with pool_destroy(pool): O(slabs) instead of free_all: O(n)
+- bulk_create_nodes_from_array puts every node in one contiguous block that is already linked in array order
+- a bulk list is freed with bulk_free_all: the block is one free, nodes inserted later with create_node are freed one by one
 */
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+#include "node_pool.h"
 #include "test_helper.h"
 
 typedef struct Node {
@@ -32,11 +43,22 @@ Node* create_node(int data) {
     return node;
 }
 
-Node* create_nodes_from_array(int a[], int size) {
+// a NULL pool falls back to malloc
+Node* pool_create_node(NodePool* pool, int data) {
+    if (pool == NULL) return create_node(data);
+
+    Node* node = (Node*)pool_alloc_node(pool);
+    node->data = data;
+    node->prev = NULL;
+    node->next = NULL;
+    return node;
+}
+
+Node* pool_create_nodes_from_array(NodePool* pool, int a[], int size) {
     Node* head = NULL;
     Node* node = NULL;
     for (int i = 0; i < size; i++) {
-        Node* n = create_node(a[i]);
+        Node* n = pool_create_node(pool, a[i]);
         if (i == 0) {
             head = n;
             node = n;
@@ -49,7 +71,56 @@ Node* create_nodes_from_array(int a[], int size) {
     return head;
 }
 
+Node* create_nodes_from_array(int a[], int size) {
+    return pool_create_nodes_from_array(NULL, a, size);
+}
+
+// a NULL pool means the node was allocated with malloc
+void pool_delete_node(NodePool* pool, Node* node) {
+    if (node->prev == NULL) {  // head
+        node->next->prev = NULL;
+    } else if (node->next == NULL) {  // tail
+        node->prev->next = NULL;
+    } else {  // middle
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+    }
+
+    if (pool == NULL)
+        free(node);
+    else
+        pool_free_node(pool, node);
+}
+
 void delete_node(Node* node) {
+    pool_delete_node(NULL, node);
+}
+
+typedef struct NodeBlock {
+    Node* nodes;  // every node built by bulk_create_nodes_from_array, in array order
+    int size;
+} NodeBlock;
+
+int block_owns(const NodeBlock* block, const Node* node) {
+    uintptr_t addr = (uintptr_t)node;
+    uintptr_t start = (uintptr_t)block->nodes;
+    return addr >= start && addr < start + sizeof(Node) * block->size;
+}
+
+// one allocation for the whole list, linking is a sequential write over the block
+Node* bulk_create_nodes_from_array(NodeBlock* block, int a[], int size) {
+    block->nodes = size > 0 ? (Node*)malloc(sizeof(Node) * size) : NULL;
+    block->size = size;
+    for (int i = 0; i < size; i++) {
+        block->nodes[i].data = a[i];
+        block->nodes[i].prev = i > 0 ? &block->nodes[i - 1] : NULL;
+        block->nodes[i].next = i + 1 < size ? &block->nodes[i + 1] : NULL;
+    }
+    return block->nodes;
+}
+
+// nodes inside the block are only unlinked, their memory goes away with the block
+void bulk_delete_node(NodeBlock* block, Node* node) {
     if (node->prev == NULL) {  // head
         node->next->prev = NULL;
     } else if (node->next == NULL) {  // tail
@@ -59,7 +130,20 @@ void delete_node(Node* node) {
         node->next->prev = node->prev;
     }
 
-    free(node);
+    if (!block_owns(block, node)) free(node);
+}
+
+// pass a NULL head when no node was inserted from outside the block: O(1)
+void bulk_free_all(NodeBlock* block, Node* head) {
+    Node* node = head;
+    while (node != NULL) {
+        Node* prev_node = node;
+        node = node->next;
+        if (!block_owns(block, prev_node)) free(prev_node);
+    }
+    free(block->nodes);
+    block->nodes = NULL;
+    block->size = 0;
 }
 
 void insert_after(Node* node, Node* new_node) {
@@ -107,6 +191,165 @@ void append(Node* head, Node* new_node) {
     new_node->prev = n;
 }
 
+typedef struct List {
+    Node* head;
+    Node* tail;
+    int size;
+} List;
+
+List* list_create() {
+    List* list = (List*)malloc(sizeof(*list));
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+    return list;
+}
+
+void list_free_all(List* list) {
+    free_all(list->head);
+    free(list);
+}
+
+int list_length(const List* list) {
+    return list->size;
+}
+
+void list_append(List* list, Node* new_node) {
+    if (list->tail == NULL)
+        list->head = new_node;
+    else
+        insert_after(list->tail, new_node);
+    list->tail = new_node;
+    list->size++;
+}
+
+List* list_create_from_array(int a[], int size) {
+    List* list = list_create();
+    for (int i = 0; i < size; i++) {
+        list_append(list, create_node(a[i]));
+    }
+    return list;
+}
+
+void list_prepend(List* list, Node* new_node) {
+    if (list->head == NULL)
+        list->tail = new_node;
+    else
+        prepend(list->head, new_node);
+    list->head = new_node;
+    list->size++;
+}
+
+void list_insert_after(List* list, Node* node, Node* new_node) {
+    insert_after(node, new_node);
+    if (node == list->tail) list->tail = new_node;
+    list->size++;
+}
+
+// unlike delete_node this also handles a list with a single node
+void list_delete_node(List* list, Node* node) {
+    if (node == list->head) list->head = node->next;
+    if (node == list->tail) list->tail = node->prev;
+    if (node->prev != NULL) node->prev->next = node->next;
+    if (node->next != NULL) node->next->prev = node->prev;
+    free(node);
+    list->size--;
+}
+
+// the sorting helpers only follow next, the prev pointers are rebuilt in one pass at the end of the sort
+static Node* merge_two_sorted(Node* head1, Node* head2) {
+    Node sentinel;
+
+    Node* n = &sentinel;
+    while (head1 && head2) {
+        if (head1->data <= head2->data) {
+            n->next = head1;
+            head1 = head1->next;
+        } else {
+            n->next = head2;
+            head2 = head2->next;
+        }
+        n = n->next;
+    }
+
+    n->next = head1 ? head1 : head2;
+
+    return sentinel.next;
+}
+
+// detaches the natural run starting at *rest, a strictly decreasing run is reversed
+static Node* take_run(Node** rest) {
+    Node* head = *rest;
+    Node* n = head;
+
+    if (n->next != NULL && n->next->data < n->data) {
+        Node* reversed = NULL;
+        while (n != NULL && (reversed == NULL || n->data < reversed->data)) {
+            Node* next = n->next;
+            n->next = reversed;
+            reversed = n;
+            n = next;
+        }
+        *rest = n;
+        return reversed;
+    }
+
+    while (n->next != NULL && n->next->data >= n->data) {
+        n = n->next;
+    }
+    *rest = n->next;
+    n->next = NULL;
+    return head;
+}
+
+#define MERGE_SORT_SLOTS 64
+
+// same engine as tricks/singly_merge_sort.h, sorts a NULL terminated chain of next pointers
+static Node* merge_sort_next(Node* head) {
+    Node* pending[MERGE_SORT_SLOTS] = {NULL};  // pending[i] holds the merge of 2^i runs
+    Node* rest = head;
+
+    while (rest != NULL) {
+        Node* run = take_run(&rest);
+        int i = 0;
+        while (i < MERGE_SORT_SLOTS - 1 && pending[i] != NULL) {
+            run = merge_two_sorted(pending[i], run);
+            pending[i] = NULL;
+            i++;
+        }
+        pending[i] = run;
+    }
+
+    Node* sorted = NULL;
+    for (int i = 0; i < MERGE_SORT_SLOTS; i++) {
+        if (pending[i] != NULL) sorted = merge_two_sorted(pending[i], sorted);
+    }
+    return sorted;
+}
+
+// stable, in place, O(1) extra memory, returns the new head
+Node* merge_sort(Node* head) {
+    head = merge_sort_next(head);
+
+    Node* prev = NULL;
+    for (Node* n = head; n != NULL; n = n->next) {  // the final prev fix-up pass
+        n->prev = prev;
+        prev = n;
+    }
+    return head;
+}
+
+void list_merge_sort(List* list) {
+    list->head = merge_sort_next(list->head);
+
+    Node* prev = NULL;
+    for (Node* n = list->head; n != NULL; n = n->next) {  // the fix-up pass also finds the new tail
+        n->prev = prev;
+        prev = n;
+    }
+    list->tail = prev;
+}
+
 /*
 ###############################
 ###          tests          ###
@@ -301,6 +544,288 @@ void test_append() {
     passed();
 }
 
+void test_pool_create_nodes_from_array() {
+    print_test_func_name();
+
+    NodePool* pool = pool_create(sizeof(Node), 2);  // tiny slabs so the list spans several of them
+    int arr[] = {1, 2, 3};
+    Node* head = pool_create_nodes_from_array(pool, arr, sizeof(arr) / sizeof(*arr));
+
+    assert(head->prev == NULL);
+    assert(head->data == 1);
+    assert(head->next->data == 2 && head->next->prev == head);
+    assert(head->next->next->data == 3 && head->next->next->prev == head->next);
+    assert(head->next->next->next == NULL);
+    assert(pool->slab_count == 2);
+
+    pool_destroy(pool);  // frees the whole list
+    passed();
+}
+
+void test_pool_delete_node_recycles_node() {
+    print_test_func_name();
+
+    NodePool* pool = pool_create(sizeof(Node), 0);
+    int arr[] = {1, 2, 3};
+    Node* head = pool_create_nodes_from_array(pool, arr, sizeof(arr) / sizeof(*arr));
+
+    Node* deleted = head->next;
+    pool_delete_node(pool, deleted);
+    assert(head->next->data == 3 && head->next->prev == head);
+
+    Node* new_node = pool_create_node(pool, 10);
+    assert(new_node == deleted);  // taken from the free list
+    insert_after(head, new_node);
+    assert(head->next == new_node && new_node->next->prev == new_node);
+
+    pool_destroy(pool);
+    passed();
+}
+
+void test_bulk_create_nodes_from_array() {
+    print_test_func_name();
+
+    NodeBlock block;
+    int arr[] = {1, 2, 3};
+    Node* head = bulk_create_nodes_from_array(&block, arr, sizeof(arr) / sizeof(*arr));
+
+    assert(head == &block.nodes[0] && head->prev == NULL);
+    assert(head->data == 1 && head->next == &block.nodes[1]);
+    assert(head->next->data == 2 && head->next->prev == head);
+    assert(head->next->next->data == 3 && head->next->next->prev == head->next);
+    assert(head->next->next->next == NULL);
+
+    bulk_free_all(&block, NULL);  // nothing was inserted: a single free
+    assert(block.nodes == NULL);
+    passed();
+}
+
+void test_bulk_insert_and_delete() {
+    print_test_func_name();
+
+    NodeBlock block;
+    int arr[] = {1, 2, 3};
+    Node* head = bulk_create_nodes_from_array(&block, arr, sizeof(arr) / sizeof(*arr));
+
+    // inserts come from the regular allocator
+    insert_after(head, create_node(10));
+    append(head, create_node(20));
+    assert(!block_owns(&block, head->next) && block_owns(&block, head->next->next));
+
+    bulk_delete_node(&block, head->next);  // malloc'd node: freed
+    assert(head->next->data == 2 && head->next->prev == head);
+    bulk_delete_node(&block, head->next);  // block node: only unlinked
+    assert(head->next->data == 3 && head->next->prev == head);
+    assert(head->next->next->data == 20 && head->next->next->prev == head->next);
+
+    bulk_free_all(&block, head);
+    passed();
+}
+
+void test_list_append_and_length() {
+    print_test_func_name();
+
+    List* list = list_create();
+    assert(list_length(list) == 0 && list->head == NULL && list->tail == NULL);
+
+    list_append(list, create_node(1));
+    assert(list->head == list->tail && list->head->data == 1);
+
+    list_append(list, create_node(2));
+    list_append(list, create_node(3));
+    assert(list_length(list) == 3);
+    assert(list->head->data == 1 && list->tail->data == 3);
+    assert(list->tail->prev->data == 2 && list->tail->next == NULL);
+
+    list_free_all(list);
+    passed();
+}
+
+void test_list_prepend_and_insert_after() {
+    print_test_func_name();
+
+    List* list = list_create();
+    list_prepend(list, create_node(2));  // prepend to an empty list also sets the tail
+    assert(list->head == list->tail);
+
+    list_prepend(list, create_node(1));
+    list_insert_after(list, list->tail, create_node(4));
+    list_insert_after(list, list->head->next, create_node(3));
+
+    int expected[] = {1, 2, 3, 4};
+    Node* n = list->tail;
+    for (int i = 3; i >= 0; i--, n = n->prev) assert(n->data == expected[i]);  // walk backwards
+    assert(n == NULL);
+    assert(list->head->prev == NULL && list->tail->next == NULL && list_length(list) == 4);
+
+    list_free_all(list);
+    passed();
+}
+
+void test_list_delete_node() {
+    print_test_func_name();
+
+    int arr[] = {1, 2, 3};
+    List* list = list_create_from_array(arr, sizeof(arr) / sizeof(*arr));
+
+    list_delete_node(list, list->tail);
+    assert(list->tail->data == 2 && list->tail->next == NULL);
+
+    list_delete_node(list, list->head);
+    assert(list->head == list->tail && list->head->prev == NULL);
+
+    list_delete_node(list, list->head);  // the last node
+    assert(list->head == NULL && list->tail == NULL && list_length(list) == 0);
+
+    list_append(list, create_node(5));  // the handle is still usable once emptied
+    assert(list->head == list->tail && list_length(list) == 1);
+
+    list_free_all(list);
+    passed();
+}
+
+void test_merge_sort() {
+    print_test_func_name();
+
+    int arr[] = {5, 1, 4, 2, 8, 0, 2, 9, 7, 3};
+    int size = sizeof(arr) / sizeof(*arr);
+    Node* head = create_nodes_from_array(arr, size);
+
+    head = merge_sort(head);
+
+    int expected[] = {0, 1, 2, 2, 3, 4, 5, 7, 8, 9};
+    Node* n = head;
+    Node* prev = NULL;
+    for (int i = 0; i < size; i++, prev = n, n = n->next) {
+        assert(n->data == expected[i]);
+        assert(n->prev == prev);
+    }
+    assert(n == NULL);
+
+    free_all(head);
+    passed();
+}
+
+void test_list_merge_sort() {
+    print_test_func_name();
+
+    int arr[] = {3, 1, 3, 2, 1, 3, 2, 2, 1};
+    int size = sizeof(arr) / sizeof(*arr);
+    List* list = list_create_from_array(arr, size);
+    Node* original[9];
+    Node* n = list->head;
+    for (int i = 0; i < size; i++, n = n->next) original[i] = n;
+
+    list_merge_sort(list);
+
+    int last_index[4] = {-1, -1, -1, -1};  // equal values keep their original order
+    for (n = list->head; n != NULL; n = n->next) {
+        int index = 0;
+        while (original[index] != n) index++;
+        assert(index > last_index[n->data]);
+        last_index[n->data] = index;
+        if (n->next != NULL) assert(n->data <= n->next->data && n->next->prev == n);
+    }
+    assert(list->head->prev == NULL && list->tail->data == 3 && list->tail->next == NULL);
+
+    list_free_all(list);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+/* harness cases, see bench_run in test_helper.h: a List of 0..size-1 is built once per size */
+#define BENCH_CHURN_OPS 1000
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    int* arr;
+    List* list;
+    Node* middle;
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) state->arr[i] = i;
+    state->list = list_create_from_array(state->arr, size);
+    state->middle = find_kth(state->list->head, size / 2);
+    bench_common_init(&state->common);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    list_free_all(b->list);
+    free(b->arr);
+    free(b);
+}
+
+static long long bench_build_and_free(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    Node* head = create_nodes_from_array(b->arr, size);
+    b->common.sink += head->data;
+    free_all(head);
+    return size;
+}
+
+static long long bench_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += search(b->list->head, key)->data;
+    return 1;
+}
+
+static long long bench_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int k = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += find_kth(b->list->head, k)->data;
+    return 1;
+}
+
+static long long bench_insert_after_and_delete_node(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    for (int i = 0; i < BENCH_CHURN_OPS; i++) {
+        insert_after(b->middle, create_node(size + i));
+        delete_node(b->middle->next);
+    }
+    return BENCH_CHURN_OPS;
+}
+
+static long long bench_list_append_and_delete_head(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    for (int i = 0; i < BENCH_CHURN_OPS; i++) {
+        list_append(b->list, create_node(size + i));
+        list_delete_node(b->list, b->list->head);
+    }
+    return BENCH_CHURN_OPS;
+}
+
+// gives the nodes new random values, in their current order
+static void bench_shuffle_data(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    Node* n = b->list->head;
+    for (int i = 0; i < size; i++, n = n->next) n->data = (int)(bench_random(&b->common.seed) >> 1);
+}
+
+static long long bench_list_merge_sort(void* state, int size) {
+    list_merge_sort(((BenchState*)state)->list);
+    return size;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"create_nodes_from_array+free_all", bench_setup, NULL, bench_build_and_free, bench_teardown},
+    {"search", bench_setup, NULL, bench_search, bench_teardown},
+    {"find_kth", bench_setup, NULL, bench_find_kth, bench_teardown},
+    {"insert_after+delete_node", bench_setup, NULL, bench_insert_after_and_delete_node, bench_teardown},
+    {"list_append+list_delete_node(head)", bench_setup, NULL, bench_list_append_and_delete_head, bench_teardown},
+    {"list_merge_sort (random)", bench_setup, bench_shuffle_data, bench_list_merge_sort, bench_teardown},
+};
+
 int main(int argc, char** argv) {
     int should_run_tests = has_test_flag(argc, argv);
     if (should_run_tests) {
@@ -315,6 +840,20 @@ int main(int argc, char** argv) {
         test_search();
         test_prepend();
         test_append();
+        test_pool_create_nodes_from_array();
+        test_pool_delete_node_recycles_node();
+        test_bulk_create_nodes_from_array();
+        test_bulk_insert_and_delete();
+        test_list_append_and_length();
+        test_list_prepend_and_insert_after();
+        test_list_delete_node();
+        test_merge_sort();
+        test_list_merge_sort();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
     }
 
     return 0;
@@ -1,12 +1,25 @@
 /*
 - this implementation includes sentinel nodes on both ends
-- the append in this implementation assumes that the tail node is not stored: O(n)
-- for fast appends, store the tail and use insert_after(tail, new_node): O(1)
+- the node-level append assumes that the tail node is not stored: O(n)
+- the List handle stores both sentinels and the size, so list_append and list_length are O(1)
+- every list_* function keeps the handle correct, mixing them with node-level calls on the same list does not
+- list_merge_sort is the bottom-up natural merge sort of tricks/singly_merge_sort.h, prev pointers are fixed at the end
+- list_find_kth_batch answers many find_kth at once: the queries are sorted, the front half is walked once from the
+  head and the back half once from the tail (see tricks/singly_find_kth_batch.c for the singly version)
+- the pool_* functions take their nodes from a NodePool (see node_pool.h) instead of one malloc per node
+- a list built only from pool nodes is freed with pool_destroy(pool): O(slabs) instead of free_all: O(n)
+- bulk_create_nodes_from_array puts every node (sentinels included) in one contiguous block that is already linked in array order
+- a bulk list is freed with bulk_free_all: the block is one free, nodes inserted later with create_node are freed one by one
 */
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+#include "node_pool.h"
 #include "test_helper.h"
 
 typedef struct Node {
@@ -33,14 +46,24 @@ Node* create_node(int data) {
     return node;
 }
 
-Node* create_nodes_from_array(int a[], int size) {
-    Node* dummy_head = create_node(0);
-    Node* dummy_tail = create_node(0);
-    Node* tail = NULL;
+// a NULL pool falls back to malloc
+Node* pool_create_node(NodePool* pool, int data) {
+    if (pool == NULL) return create_node(data);
+
+    Node* node = (Node*)pool_alloc_node(pool);
+    node->data = data;
+    node->prev = NULL;
+    node->next = NULL;
+    return node;
+}
+
+Node* pool_create_nodes_from_array(NodePool* pool, int a[], int size) {
+    Node* dummy_head = pool_create_node(pool, 0);
+    Node* dummy_tail = pool_create_node(pool, 0);
     Node* head = NULL;
     Node* node = NULL;
     for (int i = 0; i < size; i++) {
-        Node* n = create_node(a[i]);
+        Node* n = pool_create_node(pool, a[i]);
 
         int is_tail = i == size - 1;
         int is_head = i == 0;
@@ -67,11 +90,70 @@ Node* create_nodes_from_array(int a[], int size) {
     return head;
 }
 
+Node* create_nodes_from_array(int a[], int size) {
+    return pool_create_nodes_from_array(NULL, a, size);
+}
+
 // assumes that node is NOT a sentinel node
-void delete_node(Node* node) {
+// a NULL pool means the node was allocated with malloc
+void pool_delete_node(NodePool* pool, Node* node) {
     node->prev->next = node->next;  // using sentinels simplifies this
     node->next->prev = node->prev;
-    free(node);
+    if (pool == NULL)
+        free(node);
+    else
+        pool_free_node(pool, node);
+}
+
+// assumes that node is NOT a sentinel node
+void delete_node(Node* node) {
+    pool_delete_node(NULL, node);
+}
+
+typedef struct NodeBlock {
+    Node* nodes;  // every node built by bulk_create_nodes_from_array, in array order
+    int size;
+} NodeBlock;
+
+int block_owns(const NodeBlock* block, const Node* node) {
+    uintptr_t addr = (uintptr_t)node;
+    uintptr_t start = (uintptr_t)block->nodes;
+    return addr >= start && addr < start + sizeof(Node) * block->size;
+}
+
+// one allocation for the whole list, the sentinels are the first and the last node of the block
+Node* bulk_create_nodes_from_array(NodeBlock* block, int a[], int size) {
+    int block_size = size + 2;
+    block->nodes = (Node*)malloc(sizeof(Node) * block_size);
+    block->size = block_size;
+    for (int i = 0; i < block_size; i++) {
+        int is_sentinel = i == 0 || i == block_size - 1;
+        block->nodes[i].data = is_sentinel ? 0 : a[i - 1];
+        block->nodes[i].prev = i > 0 ? &block->nodes[i - 1] : NULL;
+        block->nodes[i].next = i + 1 < block_size ? &block->nodes[i + 1] : NULL;
+    }
+    return size > 0 ? &block->nodes[1] : NULL;
+}
+
+// assumes that node is NOT a sentinel node
+// nodes inside the block are only unlinked, their memory goes away with the block
+void bulk_delete_node(NodeBlock* block, Node* node) {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    if (!block_owns(block, node)) free(node);
+}
+
+// head is any real node of the list, pass NULL when no node was inserted from outside the block: O(1)
+void bulk_free_all(NodeBlock* block, Node* head) {
+    Node* node = head != NULL ? block->nodes : NULL;  // the dummy head never moves
+    while (node != NULL) {
+        Node* prev_node = node;
+        node = node->next;
+        if (!block_owns(block, prev_node)) free(prev_node);
+    }
+    free(block->nodes);
+    block->nodes = NULL;
+    block->size = 0;
 }
 
 // assumes that node is NOT sentinel node
@@ -124,6 +206,209 @@ void append(Node* head, Node* new_node) {
     n->prev = new_node;
 }
 
+// the handle owns the sentinels, so an empty list is simply dummy_head <-> dummy_tail
+typedef struct List {
+    Node* dummy_head;
+    Node* dummy_tail;
+    int size;
+} List;
+
+List* list_create() {
+    List* list = (List*)malloc(sizeof(*list));
+    list->dummy_head = create_node(0);
+    list->dummy_tail = create_node(0);
+    list->dummy_head->next = list->dummy_tail;
+    list->dummy_tail->prev = list->dummy_head;
+    list->size = 0;
+    return list;
+}
+
+void list_free_all(List* list) {
+    Node* node = list->dummy_head;
+    while (node != NULL) {
+        Node* prev_node = node;
+        node = node->next;
+        free(prev_node);
+    }
+    free(list);
+}
+
+int list_length(const List* list) {
+    return list->size;
+}
+
+// first and last real node, NULL for an empty list
+Node* list_head(const List* list) {
+    return list->size > 0 ? list->dummy_head->next : NULL;
+}
+
+Node* list_tail(const List* list) {
+    return list->size > 0 ? list->dummy_tail->prev : NULL;
+}
+
+// thanks to the sentinels every insertion is an insert_after, even into an empty list
+void list_insert_after(List* list, Node* node, Node* new_node) {
+    insert_after(node, new_node);
+    list->size++;
+}
+
+void list_append(List* list, Node* new_node) {
+    list_insert_after(list, list->dummy_tail->prev, new_node);
+}
+
+void list_prepend(List* list, Node* new_node) {
+    list_insert_after(list, list->dummy_head, new_node);
+}
+
+List* list_create_from_array(int a[], int size) {
+    List* list = list_create();
+    for (int i = 0; i < size; i++) {
+        list_append(list, create_node(a[i]));
+    }
+    return list;
+}
+
+// assumes that node is NOT a sentinel node
+void list_delete_node(List* list, Node* node) {
+    delete_node(node);
+    list->size--;
+}
+
+// the sorting helpers only follow next, the prev pointers are rebuilt in one pass at the end of the sort
+static Node* merge_two_sorted(Node* head1, Node* head2) {
+    Node sentinel;
+
+    Node* n = &sentinel;
+    while (head1 && head2) {
+        if (head1->data <= head2->data) {
+            n->next = head1;
+            head1 = head1->next;
+        } else {
+            n->next = head2;
+            head2 = head2->next;
+        }
+        n = n->next;
+    }
+
+    n->next = head1 ? head1 : head2;
+
+    return sentinel.next;
+}
+
+// detaches the natural run starting at *rest, a strictly decreasing run is reversed
+static Node* take_run(Node** rest) {
+    Node* head = *rest;
+    Node* n = head;
+
+    if (n->next != NULL && n->next->data < n->data) {
+        Node* reversed = NULL;
+        while (n != NULL && (reversed == NULL || n->data < reversed->data)) {
+            Node* next = n->next;
+            n->next = reversed;
+            reversed = n;
+            n = next;
+        }
+        *rest = n;
+        return reversed;
+    }
+
+    while (n->next != NULL && n->next->data >= n->data) {
+        n = n->next;
+    }
+    *rest = n->next;
+    n->next = NULL;
+    return head;
+}
+
+#define MERGE_SORT_SLOTS 64
+
+// same engine as tricks/singly_merge_sort.h, sorts a NULL terminated chain of next pointers
+static Node* merge_sort_next(Node* head) {
+    Node* pending[MERGE_SORT_SLOTS] = {NULL};  // pending[i] holds the merge of 2^i runs
+    Node* rest = head;
+
+    while (rest != NULL) {
+        Node* run = take_run(&rest);
+        int i = 0;
+        while (i < MERGE_SORT_SLOTS - 1 && pending[i] != NULL) {
+            run = merge_two_sorted(pending[i], run);
+            pending[i] = NULL;
+            i++;
+        }
+        pending[i] = run;
+    }
+
+    Node* sorted = NULL;
+    for (int i = 0; i < MERGE_SORT_SLOTS; i++) {
+        if (pending[i] != NULL) sorted = merge_two_sorted(pending[i], sorted);
+    }
+    return sorted;
+}
+
+// stable, in place, O(1) extra memory
+// the real nodes are cut loose from the sentinels, sorted, and reattached by the prev fix-up pass
+void list_merge_sort(List* list) {
+    if (list->size < 2) return;
+
+    list->dummy_tail->prev->next = NULL;
+    Node* head = merge_sort_next(list->dummy_head->next);
+
+    Node* prev = list->dummy_head;
+    prev->next = head;
+    for (Node* n = head; n != NULL; n = n->next) {
+        n->prev = prev;
+        prev = n;
+    }
+    prev->next = list->dummy_tail;
+    list->dummy_tail->prev = prev;
+}
+
+typedef struct KthQuery {
+    int k;
+    int index;  // into ks and out
+} KthQuery;
+
+static int compare_queries(const void* a, const void* b) {
+    int x = ((const KthQuery*)a)->k, y = ((const KthQuery*)b)->k;
+    return (x > y) - (x < y);
+}
+
+// out[i] is the node at index ks[i] (from 0), NULL when ks[i] is out of range: O(min(n, max walk) + q*log(q))
+// ks below size / 2 are reached going up from the head, the others going down from the tail
+void list_find_kth_batch(const List* list, const int* ks, Node** out, int q) {
+    KthQuery* queries = (KthQuery*)malloc(sizeof(KthQuery) * (q > 0 ? q : 1));
+    for (int i = 0; i < q; i++) queries[i] = (KthQuery){ks[i], i};
+    qsort(queries, q, sizeof(KthQuery), compare_queries);
+
+    int half = list->size / 2;
+    int front_end = 0;  // queries[0..front_end) are below half
+    Node* node = list->dummy_head->next;
+    int position = 0;
+    for (; front_end < q && queries[front_end].k < half; front_end++) {
+        int k = queries[front_end].k;
+        Node* found = NULL;
+        if (k >= 0) {
+            for (; position < k; position++) node = node->next;
+            found = node;
+        }
+        out[queries[front_end].index] = found;
+    }
+
+    node = list->dummy_tail->prev;
+    position = list->size - 1;
+    for (int i = q - 1; i >= front_end; i--) {
+        int k = queries[i].k;
+        Node* found = NULL;
+        if (k < list->size) {
+            for (; position > k; position--) node = node->prev;
+            found = node;
+        }
+        out[queries[i].index] = found;
+    }
+
+    free(queries);
+}
+
 /*
 ###############################
 ###          tests          ###
@@ -338,6 +623,333 @@ void test_append() {
     passed();
 }
 
+void test_pool_create_nodes_from_array() {
+    print_test_func_name();
+
+    NodePool* pool = pool_create(sizeof(Node), 2);  // tiny slabs so the list spans several of them
+    int arr[] = {1, 2, 3};
+    Node* head = pool_create_nodes_from_array(pool, arr, sizeof(arr) / sizeof(*arr));
+
+    assert(head->prev->data == 0 && head->prev->prev == NULL);  // check sentinel
+    assert(head->data == 1);
+    assert(head->next->data == 2 && head->next->prev == head);
+    assert(head->next->next->data == 3);
+    assert(head->next->next->next->next == NULL);  // check sentinel
+    assert(pool->slab_count == 3);                 // 3 nodes + 2 sentinels
+
+    pool_destroy(pool);  // frees the whole list, sentinels included
+    passed();
+}
+
+void test_pool_delete_node_recycles_node() {
+    print_test_func_name();
+
+    NodePool* pool = pool_create(sizeof(Node), 0);
+    int arr[] = {1, 2, 3};
+    Node* head = pool_create_nodes_from_array(pool, arr, sizeof(arr) / sizeof(*arr));
+
+    Node* deleted = head->next;
+    pool_delete_node(pool, deleted);
+    assert(head->next->data == 3 && head->next->prev == head);
+
+    Node* new_node = pool_create_node(pool, 10);
+    assert(new_node == deleted);  // taken from the free list
+    insert_after(head, new_node);
+    assert(head->next == new_node && new_node->next->prev == new_node);
+
+    pool_destroy(pool);
+    passed();
+}
+
+void test_bulk_create_nodes_from_array() {
+    print_test_func_name();
+
+    NodeBlock block;
+    int arr[] = {1, 2, 3};
+    Node* head = bulk_create_nodes_from_array(&block, arr, sizeof(arr) / sizeof(*arr));
+
+    assert(head == &block.nodes[1]);
+    assert(head->prev == &block.nodes[0] && head->prev->data == 0);  // check sentinel
+    assert(head->data == 1);
+    assert(head->next->data == 2 && head->next->prev == head);
+    assert(head->next->next->data == 3 && head->next->next->prev == head->next);
+    Node* dummy_tail = head->next->next->next;
+    assert(dummy_tail == &block.nodes[4] && dummy_tail->next == NULL);  // check sentinel
+
+    bulk_free_all(&block, NULL);  // nothing was inserted: a single free
+    assert(block.nodes == NULL);
+    passed();
+}
+
+void test_bulk_insert_and_delete() {
+    print_test_func_name();
+
+    NodeBlock block;
+    int arr[] = {1, 2, 3};
+    Node* head = bulk_create_nodes_from_array(&block, arr, sizeof(arr) / sizeof(*arr));
+
+    // inserts come from the regular allocator
+    insert_after(head, create_node(10));
+    append(head, create_node(20));
+    assert(!block_owns(&block, head->next) && block_owns(&block, head->next->next));
+
+    bulk_delete_node(&block, head->next);  // malloc'd node: freed
+    assert(head->next->data == 2 && head->next->prev == head);
+    bulk_delete_node(&block, head->next);  // block node: only unlinked
+    assert(head->next->data == 3 && head->next->prev == head);
+    assert(head->next->next->data == 20 && head->next->next->next == &block.nodes[4]);
+
+    bulk_free_all(&block, head);
+    passed();
+}
+
+void test_list_append_and_length() {
+    print_test_func_name();
+
+    List* list = list_create();
+    assert(list_length(list) == 0 && list_head(list) == NULL && list_tail(list) == NULL);
+
+    list_append(list, create_node(1));
+    assert(list_head(list) == list_tail(list) && list_head(list)->data == 1);
+
+    list_append(list, create_node(2));
+    list_append(list, create_node(3));
+    assert(list_length(list) == 3);
+    assert(list_head(list)->data == 1 && list_tail(list)->data == 3);
+    assert(list_tail(list)->next == list->dummy_tail && list->dummy_tail->prev->data == 3);
+
+    list_free_all(list);
+    passed();
+}
+
+void test_list_prepend_and_insert_after() {
+    print_test_func_name();
+
+    List* list = list_create();
+    list_prepend(list, create_node(2));
+    list_prepend(list, create_node(1));
+    list_insert_after(list, list_tail(list), create_node(4));
+    list_insert_after(list, list_head(list)->next, create_node(3));
+
+    int expected[] = {1, 2, 3, 4};
+    Node* n = list_head(list);
+    for (int i = 0; i < 4; i++, n = n->next) {
+        assert(n->data == expected[i]);
+        assert(n->prev->next == n && n->next->prev == n);
+    }
+    assert(n == list->dummy_tail && list_length(list) == 4);
+
+    list_free_all(list);
+    passed();
+}
+
+void test_list_delete_node() {
+    print_test_func_name();
+
+    int arr[] = {1, 2, 3};
+    List* list = list_create_from_array(arr, sizeof(arr) / sizeof(*arr));
+
+    list_delete_node(list, list_tail(list));
+    assert(list_tail(list)->data == 2 && list_length(list) == 2);
+
+    list_delete_node(list, list_head(list));
+    list_delete_node(list, list_head(list));  // the last node
+    assert(list_head(list) == NULL && list_length(list) == 0);
+    assert(list->dummy_head->next == list->dummy_tail && list->dummy_tail->prev == list->dummy_head);
+
+    list_append(list, create_node(5));  // the handle is still usable once emptied
+    assert(list_head(list) == list_tail(list) && list_length(list) == 1);
+
+    list_free_all(list);
+    passed();
+}
+
+void test_list_merge_sort() {
+    print_test_func_name();
+
+    int arr[] = {3, 1, 3, 2, 1, 3, 2, 2, 1};
+    int size = sizeof(arr) / sizeof(*arr);
+    List* list = list_create_from_array(arr, size);
+    Node* original[9];
+    Node* n = list_head(list);
+    for (int i = 0; i < size; i++, n = n->next) original[i] = n;
+
+    list_merge_sort(list);
+
+    int last_index[4] = {-1, -1, -1, -1};  // equal values keep their original order
+    int count = 0;
+    for (n = list_head(list); n != list->dummy_tail; n = n->next, count++) {
+        int index = 0;
+        while (original[index] != n) index++;
+        assert(index > last_index[n->data]);
+        last_index[n->data] = index;
+        assert(n->prev->next == n && n->next->prev == n);
+    }
+    assert(count == size);
+    assert(list_head(list)->data == 1 && list_tail(list)->data == 3);
+
+    List* empty = list_create();
+    list_merge_sort(empty);
+    assert(empty->dummy_head->next == empty->dummy_tail);
+    list_free_all(empty);
+
+    list_free_all(list);
+    passed();
+}
+
+void test_list_find_kth_batch() {
+    print_test_func_name();
+
+    int arr[] = {10, 11, 12, 13, 14, 15, 16};
+    List* list = list_create_from_array(arr, 7);
+    int ks[] = {6, 0, 3, 2, 3, 7, -1, 4, 100};
+    Node* out[9];
+    list_find_kth_batch(list, ks, out, 9);
+    for (int i = 0; i < 9; i++) {
+        if (ks[i] < 0 || ks[i] >= 7)
+            assert(out[i] == NULL);
+        else
+            assert(out[i] == find_kth(list_head(list), ks[i]));
+    }
+
+    int random_ks[200];
+    Node* random_out[200];
+    uint32_t seed = 3;
+    for (int i = 0; i < 200; i++) random_ks[i] = (int)(bench_random(&seed) % 9) - 1;
+    list_find_kth_batch(list, random_ks, random_out, 200);
+    for (int i = 0; i < 200; i++) {
+        Node* expected = random_ks[i] >= 0 && random_ks[i] < 7 ? find_kth(list_head(list), random_ks[i]) : NULL;
+        assert(random_out[i] == expected);
+    }
+
+    List* empty = list_create();
+    list_find_kth_batch(empty, ks, out, 3);
+    assert(out[0] == NULL && out[1] == NULL && out[2] == NULL);
+    list_free_all(empty);
+
+    list_free_all(list);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+/* harness cases, see bench_run in test_helper.h: a List of 0..size-1 is built once per size */
+#define BENCH_CHURN_OPS 1000
+#define BENCH_KTH_QUERIES 64
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    int* arr;
+    List* list;
+    Node* middle;
+    int ks[BENCH_KTH_QUERIES];
+    Node* out[BENCH_KTH_QUERIES];
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) state->arr[i] = i;
+    state->list = list_create_from_array(state->arr, size);
+    state->middle = find_kth(list_head(state->list), size / 2);
+    bench_common_init(&state->common);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    list_free_all(b->list);
+    free(b->arr);
+    free(b);
+}
+
+static long long bench_build_and_free(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    Node* head = create_nodes_from_array(b->arr, size);
+    b->common.sink += head->data;
+    free_all(head);
+    return size;
+}
+
+static long long bench_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += search(list_head(b->list), key)->data;
+    return 1;
+}
+
+static long long bench_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int k = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += find_kth(list_head(b->list), k)->data;
+    return 1;
+}
+
+static long long bench_insert_after_and_delete_node(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    for (int i = 0; i < BENCH_CHURN_OPS; i++) {
+        insert_after(b->middle, create_node(size + i));
+        delete_node(b->middle->next);
+    }
+    return BENCH_CHURN_OPS;
+}
+
+static long long bench_list_append_and_delete_head(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    for (int i = 0; i < BENCH_CHURN_OPS; i++) {
+        list_append(b->list, create_node(size + i));
+        list_delete_node(b->list, list_head(b->list));
+    }
+    return BENCH_CHURN_OPS;
+}
+
+// gives the nodes new random values, in their current order
+static void bench_shuffle_data(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    Node* n = list_head(b->list);
+    for (int i = 0; i < size; i++, n = n->next) n->data = (int)(bench_random(&b->common.seed) >> 1);
+}
+
+static long long bench_list_merge_sort(void* state, int size) {
+    list_merge_sort(((BenchState*)state)->list);
+    return size;
+}
+
+static void bench_new_kth_queries(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    for (int i = 0; i < BENCH_KTH_QUERIES; i++) b->ks[i] = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+}
+
+static long long bench_repeated_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    (void)size;
+    for (int i = 0; i < BENCH_KTH_QUERIES; i++) b->out[i] = find_kth(list_head(b->list), b->ks[i]);
+    return BENCH_KTH_QUERIES;
+}
+
+static long long bench_list_find_kth_batch(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    (void)size;
+    list_find_kth_batch(b->list, b->ks, b->out, BENCH_KTH_QUERIES);
+    return BENCH_KTH_QUERIES;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"create_nodes_from_array+free_all", bench_setup, NULL, bench_build_and_free, bench_teardown},
+    {"search", bench_setup, NULL, bench_search, bench_teardown},
+    {"find_kth", bench_setup, NULL, bench_find_kth, bench_teardown},
+    {"insert_after+delete_node", bench_setup, NULL, bench_insert_after_and_delete_node, bench_teardown},
+    {"list_append+list_delete_node(head)", bench_setup, NULL, bench_list_append_and_delete_head, bench_teardown},
+    {"list_merge_sort (random)", bench_setup, bench_shuffle_data, bench_list_merge_sort, bench_teardown},
+    {"repeated find_kth (q=64, per query)", bench_setup, bench_new_kth_queries, bench_repeated_find_kth, bench_teardown},
+    {"list_find_kth_batch (q=64, per query)", bench_setup, bench_new_kth_queries, bench_list_find_kth_batch,
+     bench_teardown},
+};
+
 int main(int argc, char** argv) {
     int should_run_tests = has_test_flag(argc, argv);
     if (should_run_tests) {
@@ -352,6 +964,20 @@ int main(int argc, char** argv) {
         test_search();
         test_prepend();
         test_append();
+        test_pool_create_nodes_from_array();
+        test_pool_delete_node_recycles_node();
+        test_bulk_create_nodes_from_array();
+        test_bulk_insert_and_delete();
+        test_list_append_and_length();
+        test_list_prepend_and_insert_after();
+        test_list_delete_node();
+        test_list_merge_sort();
+        test_list_find_kth_batch();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
     }
 
     return 0;
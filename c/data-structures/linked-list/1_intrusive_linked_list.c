@@ -0,0 +1,322 @@
+/*
+- tests of intrusive_list.h: the doubly (dlink_*) and sentinel (dlist_*) intrusive lists
+- the records embed their DLink, container_of turns a link back into its record
+- the benchmark of intrusive against separately allocated records is in tricks/singly_intrusive.c, the harness
+  cases here time the dlist operations
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "intrusive_list.h"
+#include "test_helper.h"
+
+typedef struct Record {
+    char name[8];
+    DLink link;  // deliberately not first, container_of must subtract its offset
+    int id;
+} Record;
+
+static Record* records_create(int size) {
+    Record* records = (Record*)malloc(sizeof(Record) * size);
+    for (int i = 0; i < size; i++) records[i] = (Record){"r", {NULL, NULL}, i};
+    return records;
+}
+
+// links records[0..size) in order as a NULL-terminated dlink list, returns the head
+static DLink* records_link(Record* records, int size) {
+    for (int i = 0; i < size; i++) {
+        records[i].link.prev = i > 0 ? &records[i - 1].link : NULL;
+        records[i].link.next = i + 1 < size ? &records[i + 1].link : NULL;
+    }
+    return size > 0 ? &records[0].link : NULL;
+}
+
+// checks the ids forwards and the prev pointers backwards
+static void assert_dlink_ids(DLink* head, const int* expected, int size) {
+    int i = 0;
+    DLink* last = NULL;
+    dlink_foreach_entry(r, head, Record, link) {
+        assert(i < size && r->id == expected[i]);
+        assert(r->link.prev == last);
+        last = &r->link;
+        i++;
+    }
+    assert(i == size);
+}
+
+static void assert_dlist_ids(DList* list, const int* expected, int size) {
+    int i = 0;
+    DLink* last = &list->dummy_head;
+    dlist_foreach_entry(r, list, Record, link) {
+        assert(i < size && r->id == expected[i]);
+        assert(r->link.prev == last);
+        last = &r->link;
+        i++;
+    }
+    assert(i == size && dlist_length(list) == size);
+    assert(list->dummy_tail.prev == last);
+}
+
+static int compare_by_id(const DLink* a, const DLink* b) {
+    int x = container_of(a, Record, link)->id, y = container_of(b, Record, link)->id;
+    return (x > y) - (x < y);
+}
+
+void test_dlink_insert_and_delete() {
+    print_test_func_name();
+
+    Record* records = records_create(6);
+    DLink* head = records_link(records, 3);  // 0 1 2
+
+    dlink_insert_after(&records[0].link, &records[3].link);  // 0 3 1 2
+    dlink_insert_after(&records[2].link, &records[4].link);  // 0 3 1 2 4
+    assert_dlink_ids(head, (int[]){0, 3, 1, 2, 4}, 5);
+    assert(container_of(records[4].link.prev, Record, link)->id == 2);
+
+    head = dlink_delete(head, &records[1].link);  // middle
+    head = dlink_delete(head, &records[0].link);  // head
+    assert(head == &records[3].link);
+    head = dlink_delete(head, &records[4].link);  // tail
+    assert_dlink_ids(head, (int[]){3, 2}, 2);
+
+    head = dlink_delete(head, &records[3].link);
+    head = dlink_delete(head, &records[2].link);
+    assert(head == NULL);
+
+    free(records);
+    passed();
+}
+
+void test_dlink_splice_after() {
+    print_test_func_name();
+
+    Record* records = records_create(6);
+    DLink* head = records_link(records, 3);  // 0 1 2
+    records_link(records + 3, 3);            // 3 4 5
+    dlink_splice_after(&records[1].link, &records[3].link, &records[5].link);
+    assert_dlink_ids(head, (int[]){0, 1, 3, 4, 5, 2}, 6);
+
+    free(records);
+    passed();
+}
+
+void test_dlink_merge_two_sorted() {
+    print_test_func_name();
+
+    Record* records = records_create(6);
+    Record* odd[] = {&records[1], &records[3], &records[5]};
+    Record* even[] = {&records[0], &records[2], &records[4]};
+    for (int i = 0; i < 3; i++) {
+        odd[i]->link = (DLink){i > 0 ? &odd[i - 1]->link : NULL, i < 2 ? &odd[i + 1]->link : NULL};
+        even[i]->link = (DLink){i > 0 ? &even[i - 1]->link : NULL, i < 2 ? &even[i + 1]->link : NULL};
+    }
+
+    DLink* head = dlink_merge_two_sorted(&records[1].link, &records[0].link, compare_by_id);
+    assert_dlink_ids(head, (int[]){0, 1, 2, 3, 4, 5}, 6);
+    assert(dlink_merge_two_sorted(NULL, NULL, compare_by_id) == NULL);
+
+    free(records);
+    passed();
+}
+
+void test_dlink_reverse_sublist() {
+    print_test_func_name();
+
+    Record* records = records_create(7);
+    DLink* head = records_link(records, 7);
+    head = dlink_reverse_sublist(head, 2, 5);
+    assert_dlink_ids(head, (int[]){0, 4, 3, 2, 1, 5, 6}, 7);
+    head = dlink_reverse_sublist(head, 1, 7);
+    assert_dlink_ids(head, (int[]){6, 5, 1, 2, 3, 4, 0}, 7);
+    head = dlink_reverse_sublist(head, 1, 1);
+    assert_dlink_ids(head, (int[]){6, 5, 1, 2, 3, 4, 0}, 7);
+
+    free(records);
+    passed();
+}
+
+void test_dlist_insert_and_delete() {
+    print_test_func_name();
+
+    DList list;
+    dlist_init(&list);
+    assert(dlist_first(&list) == NULL && dlist_last(&list) == NULL && dlist_find_kth(&list, 0) == NULL);
+
+    Record* records = records_create(5);
+    dlist_append(&list, &records[1].link);
+    dlist_append(&list, &records[2].link);
+    dlist_prepend(&list, &records[0].link);
+    dlist_insert_after(&list, &records[2].link, &records[4].link);
+    dlist_insert_after(&list, &records[2].link, &records[3].link);
+    assert_dlist_ids(&list, (int[]){0, 1, 2, 3, 4}, 5);
+    assert(container_of(dlist_find_kth(&list, 3), Record, link)->id == 3);
+    assert(dlist_find_kth(&list, 5) == NULL);
+
+    dlist_delete(&list, &records[0].link);
+    dlist_delete(&list, &records[4].link);
+    dlist_delete(&list, &records[2].link);
+    assert_dlist_ids(&list, (int[]){1, 3}, 2);
+    assert(dlist_first(&list) == &records[1].link && dlist_last(&list) == &records[3].link);
+
+    int count = 0;
+    dlist_foreach(link, &list) count++;
+    assert(count == 2);
+
+    free(records);
+    passed();
+}
+
+void test_dlist_splice_after() {
+    print_test_func_name();
+
+    Record* records = records_create(5);
+    DList list, other;
+    dlist_init(&list);
+    dlist_init(&other);
+    for (int i = 0; i < 2; i++) dlist_append(&list, &records[i].link);
+    for (int i = 2; i < 5; i++) dlist_append(&other, &records[i].link);
+
+    dlist_splice_after(&list, &records[0].link, &other);
+    assert_dlist_ids(&list, (int[]){0, 2, 3, 4, 1}, 5);
+    assert_dlist_ids(&other, NULL, 0);
+
+    dlist_splice_after(&list, &records[1].link, &other);  // an empty other changes nothing
+    assert_dlist_ids(&list, (int[]){0, 2, 3, 4, 1}, 5);
+
+    free(records);
+    passed();
+}
+
+void test_dlist_merge() {
+    print_test_func_name();
+
+    Record* records = records_create(7);
+    DList list, other;
+    dlist_init(&list);
+    dlist_init(&other);
+    for (int i = 0; i < 7; i++) dlist_append(i % 3 == 0 ? &list : &other, &records[i].link);  // 0 3 6 | 1 2 4 5
+
+    dlist_merge(&list, &other, compare_by_id);
+    assert_dlist_ids(&list, (int[]){0, 1, 2, 3, 4, 5, 6}, 7);
+    assert_dlist_ids(&other, NULL, 0);
+
+    dlist_merge(&other, &list, compare_by_id);  // into an empty list
+    assert_dlist_ids(&other, (int[]){0, 1, 2, 3, 4, 5, 6}, 7);
+
+    free(records);
+    passed();
+}
+
+void test_dlist_reverse_sublist() {
+    print_test_func_name();
+
+    Record* records = records_create(6);
+    DList list;
+    dlist_init(&list);
+    for (int i = 0; i < 6; i++) dlist_append(&list, &records[i].link);
+
+    dlist_reverse_sublist(&list, 2, 4);
+    assert_dlist_ids(&list, (int[]){0, 3, 2, 1, 4, 5}, 6);
+    dlist_reverse_sublist(&list, 1, 6);
+    assert_dlist_ids(&list, (int[]){5, 4, 1, 2, 3, 0}, 6);
+
+    free(records);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+/* harness cases, see bench_run in test_helper.h: a DList of size records with ids 0..size-1 is built once per size */
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    Record* records;
+    DList list;
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    bench_common_init(&state->common);
+    state->records = records_create(size);
+    dlist_init(&state->list);
+    for (int i = 0; i < size; i++) dlist_append(&state->list, &state->records[i].link);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    free(((BenchState*)state)->records);
+    free(state);
+}
+
+static long long bench_search_by_id(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int id = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    dlist_foreach_entry(r, &b->list, Record, link) {
+        if (r->id == id) {
+            b->common.sink += r->id;
+            break;
+        }
+    }
+    return 1;
+}
+
+static long long bench_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int k = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += container_of(dlist_find_kth(&b->list, k), Record, link)->id;
+    return 1;
+}
+
+// moves a random record to the back: the length stays the same
+static long long bench_delete_and_append(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    DLink* link = &b->records[bench_random(&b->common.seed) % (uint32_t)size].link;
+    dlist_delete(&b->list, link);
+    dlist_append(&b->list, link);
+    return 1;
+}
+
+// the middle half, one op per link up to k (the walk to s included)
+static long long bench_reverse_sublist(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int s = size / 4 + 1, k = size - size / 4;
+    dlist_reverse_sublist(&b->list, s, k);
+    return k;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"dlist search by id", bench_setup, NULL, bench_search_by_id, bench_teardown},
+    {"dlist_find_kth", bench_setup, NULL, bench_find_kth, bench_teardown},
+    {"dlist_delete+dlist_append", bench_setup, NULL, bench_delete_and_append, bench_teardown},
+    {"dlist_reverse_sublist (middle half)", bench_setup, NULL, bench_reverse_sublist, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_dlink_insert_and_delete();
+        test_dlink_splice_after();
+        test_dlink_merge_two_sorted();
+        test_dlink_reverse_sublist();
+        test_dlist_insert_and_delete();
+        test_dlist_splice_after();
+        test_dlist_merge();
+        test_dlist_reverse_sublist();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+    }
+
+    return 0;
+}
@@ -1,12 +1,22 @@
 /*
 - this implementation uses NULL as an indicator of head and tail
-- the append in this implementation assumes that the tail node is not stored: O(n)
-- for fast appends, store the tail and use insert_after(tail, new_node): O(1)
+- the node-level append assumes that the tail node is not stored: O(n)
+- the List handle stores head, tail and size, so list_append and list_length are O(1)
+- every list_* function keeps the handle correct, mixing them with node-level calls on the same list does not
+- the pool_* functions take their nodes from a NodePool (see node_pool.h) instead of one malloc per node
+- a list built only from pool nodes is freed with pool_destroy(pool): O(slabs) instead of free_all: O(n)
+- bulk_create_nodes_from_array puts every node in one contiguous block that is already linked in array order
+- a bulk list is freed with bulk_free_all: the block is one free, nodes inserted later with create_node are freed one by one
 */
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+#include "node_pool.h"
 #include "test_helper.h"
 
 typedef struct Node {
@@ -30,11 +40,21 @@ Node* create_node(int data) {
     return node;
 }
 
-Node* create_nodes_from_array(int a[], int size) {
+// a NULL pool falls back to malloc
+Node* pool_create_node(NodePool* pool, int data) {
+    if (pool == NULL) return create_node(data);
+
+    Node* node = (Node*)pool_alloc_node(pool);
+    node->data = data;
+    node->next = NULL;
+    return node;
+}
+
+Node* pool_create_nodes_from_array(NodePool* pool, int a[], int size) {
     Node* head = NULL;
     Node* node = NULL;
     for (int i = 0; i < size; i++) {
-        Node* n = create_node(a[i]);
+        Node* n = pool_create_node(pool, a[i]);
         if (i == 0) {
             head = n;
             node = n;
@@ -46,18 +66,78 @@ Node* create_nodes_from_array(int a[], int size) {
     return head;
 }
 
+Node* create_nodes_from_array(int a[], int size) {
+    return pool_create_nodes_from_array(NULL, a, size);
+}
+
+// a NULL pool means the node was allocated with malloc
+int pool_delete_after(NodePool* pool, Node* node) {
+    if (node->next == NULL) {
+        return -1;
+    }
+
+    Node* node_to_del = node->next;
+    node->next = node->next->next;
+    if (pool == NULL)
+        free(node_to_del);
+    else
+        pool_free_node(pool, node_to_del);
+
+    return 0;
+}
+
 int delete_after(Node* node) {
+    return pool_delete_after(NULL, node);
+}
+
+typedef struct NodeBlock {
+    Node* nodes;  // every node built by bulk_create_nodes_from_array, in array order
+    int size;
+} NodeBlock;
+
+int block_owns(const NodeBlock* block, const Node* node) {
+    uintptr_t addr = (uintptr_t)node;
+    uintptr_t start = (uintptr_t)block->nodes;
+    return addr >= start && addr < start + sizeof(Node) * block->size;
+}
+
+// one allocation for the whole list, linking is a sequential write over the block
+Node* bulk_create_nodes_from_array(NodeBlock* block, int a[], int size) {
+    block->nodes = size > 0 ? (Node*)malloc(sizeof(Node) * size) : NULL;
+    block->size = size;
+    for (int i = 0; i < size; i++) {
+        block->nodes[i].data = a[i];
+        block->nodes[i].next = i + 1 < size ? &block->nodes[i + 1] : NULL;
+    }
+    return block->nodes;
+}
+
+// nodes inside the block are only unlinked, their memory goes away with the block
+int bulk_delete_after(NodeBlock* block, Node* node) {
     if (node->next == NULL) {
         return -1;
     }
 
     Node* node_to_del = node->next;
     node->next = node->next->next;
-    free(node_to_del);
+    if (!block_owns(block, node_to_del)) free(node_to_del);
 
     return 0;
 }
 
+// pass a NULL head when no node was inserted from outside the block: O(1)
+void bulk_free_all(NodeBlock* block, Node* head) {
+    Node* node = head;
+    while (node != NULL) {
+        Node* prev_node = node;
+        node = node->next;
+        if (!block_owns(block, prev_node)) free(prev_node);
+    }
+    free(block->nodes);
+    block->nodes = NULL;
+    block->size = 0;
+}
+
 void insert_after(Node* node, Node* new_node) {
     if (node->next != NULL) new_node->next = node->next;
     node->next = new_node;
@@ -104,6 +184,77 @@ void append(Node* head, Node* new_node) {
     n->next = new_node;
 }
 
+typedef struct List {
+    Node* head;
+    Node* tail;
+    int size;
+} List;
+
+List* list_create() {
+    List* list = (List*)malloc(sizeof(*list));
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+    return list;
+}
+
+void list_free_all(List* list) {
+    free_all(list->head);
+    free(list);
+}
+
+int list_length(const List* list) {
+    return list->size;
+}
+
+void list_append(List* list, Node* new_node) {
+    if (list->tail == NULL)
+        list->head = new_node;
+    else
+        insert_after(list->tail, new_node);
+    list->tail = new_node;
+    list->size++;
+}
+
+List* list_create_from_array(int a[], int size) {
+    List* list = list_create();
+    for (int i = 0; i < size; i++) {
+        list_append(list, create_node(a[i]));
+    }
+    return list;
+}
+
+void list_prepend(List* list, Node* new_node) {
+    prepend_and_swap_ptr(&list->head, &new_node);
+    if (list->tail == NULL) list->tail = new_node;
+    list->size++;
+}
+
+void list_insert_after(List* list, Node* node, Node* new_node) {
+    insert_after(node, new_node);
+    if (node == list->tail) list->tail = new_node;
+    list->size++;
+}
+
+int list_delete_after(List* list, Node* node) {
+    if (node->next == list->tail) list->tail = node;
+    if (delete_after(node) != 0) return -1;
+    list->size--;
+    return 0;
+}
+
+// delete_after cannot remove the head since it has no predecessor
+int list_delete_head(List* list) {
+    if (list->head == NULL) return -1;
+
+    Node* node_to_del = list->head;
+    list->head = node_to_del->next;
+    if (list->head == NULL) list->tail = NULL;
+    free(node_to_del);
+    list->size--;
+    return 0;
+}
+
 /*
 ###############################
 ###          tests          ###
@@ -260,6 +411,342 @@ void test_append() {
     passed();
 }
 
+void test_pool_create_nodes_from_array() {
+    print_test_func_name();
+
+    NodePool* pool = pool_create(sizeof(Node), 2);  // tiny slabs so the list spans several of them
+    int arr[] = {1, 2, 3, 4, 5};
+    Node* head = pool_create_nodes_from_array(pool, arr, sizeof(arr) / sizeof(*arr));
+
+    Node* n = head;
+    for (int i = 0; i < 5; i++) {
+        assert(n->data == arr[i]);
+        n = n->next;
+    }
+    assert(n == NULL);
+    assert(pool->slab_count == 3);
+
+    pool_destroy(pool);  // frees the whole list
+    passed();
+}
+
+void test_pool_delete_after_recycles_node() {
+    print_test_func_name();
+
+    NodePool* pool = pool_create(sizeof(Node), 0);
+    int arr[] = {1, 2, 3};
+    Node* head = pool_create_nodes_from_array(pool, arr, sizeof(arr) / sizeof(*arr));
+
+    Node* deleted = head->next;
+    assert(pool_delete_after(pool, head) == 0);
+    assert(head->next->data == 3);
+
+    Node* new_node = pool_create_node(pool, 10);
+    assert(new_node == deleted);  // taken from the free list
+    insert_after(head, new_node);
+    assert(head->next->data == 10 && head->next->next->data == 3);
+
+    assert(pool_delete_after(pool, head->next->next) == -1);
+
+    pool_destroy(pool);
+    passed();
+}
+
+void test_bulk_create_nodes_from_array() {
+    print_test_func_name();
+
+    NodeBlock block;
+    int arr[] = {1, 2, 3};
+    Node* head = bulk_create_nodes_from_array(&block, arr, sizeof(arr) / sizeof(*arr));
+
+    assert(head == &block.nodes[0]);
+    assert(head->data == 1 && head->next == &block.nodes[1]);
+    assert(head->next->data == 2 && head->next->next == &block.nodes[2]);
+    assert(head->next->next->data == 3 && head->next->next->next == NULL);
+
+    bulk_free_all(&block, NULL);  // nothing was inserted: a single free
+    assert(block.nodes == NULL);
+    passed();
+}
+
+void test_bulk_insert_and_delete() {
+    print_test_func_name();
+
+    NodeBlock block;
+    int arr[] = {1, 2, 3};
+    Node* head = bulk_create_nodes_from_array(&block, arr, sizeof(arr) / sizeof(*arr));
+
+    // inserts come from the regular allocator
+    insert_after(head, create_node(10));
+    append(head, create_node(20));
+    assert(!block_owns(&block, head->next) && block_owns(&block, head->next->next));
+
+    assert(bulk_delete_after(&block, head) == 0);  // malloc'd node: freed
+    assert(head->next->data == 2);
+    assert(bulk_delete_after(&block, head) == 0);  // block node: only unlinked
+    assert(head->next->data == 3 && head->next->next->data == 20);
+
+    bulk_free_all(&block, head);
+    passed();
+}
+
+void test_list_append_and_length() {
+    print_test_func_name();
+
+    List* list = list_create();
+    assert(list_length(list) == 0 && list->head == NULL && list->tail == NULL);
+
+    list_append(list, create_node(1));
+    assert(list->head == list->tail && list->head->data == 1);
+
+    list_append(list, create_node(2));
+    list_append(list, create_node(3));
+    assert(list_length(list) == 3);
+    assert(list->head->data == 1 && list->tail->data == 3 && list->tail->next == NULL);
+    assert(find_kth(list->head, 2) == list->tail);
+
+    list_free_all(list);
+    passed();
+}
+
+void test_list_prepend_and_insert_after() {
+    print_test_func_name();
+
+    List* list = list_create();
+    list_prepend(list, create_node(2));  // prepend to an empty list also sets the tail
+    assert(list->head == list->tail);
+
+    list_prepend(list, create_node(1));
+    list_insert_after(list, list->tail, create_node(4));
+    list_insert_after(list, list->head->next, create_node(3));
+
+    int expected[] = {1, 2, 3, 4};
+    Node* n = list->head;
+    for (int i = 0; i < 4; i++, n = n->next) assert(n->data == expected[i]);
+    assert(n == NULL);
+    assert(list->tail->data == 4 && list_length(list) == 4);
+
+    list_free_all(list);
+    passed();
+}
+
+void test_list_delete() {
+    print_test_func_name();
+
+    int arr[] = {1, 2, 3};
+    List* list = list_create_from_array(arr, sizeof(arr) / sizeof(*arr));
+    assert(list->tail->data == 3 && list_length(list) == 3);
+
+    assert(list_delete_after(list, list->tail) == -1);
+    assert(list_delete_after(list, list->head->next) == 0);  // deletes the tail
+    assert(list->tail->data == 2 && list->tail->next == NULL && list_length(list) == 2);
+
+    assert(list_delete_head(list) == 0);
+    assert(list->head == list->tail && list->head->data == 2);
+    assert(list_delete_head(list) == 0);
+    assert(list->head == NULL && list->tail == NULL && list_length(list) == 0);
+    assert(list_delete_head(list) == -1);
+
+    list_append(list, create_node(5));  // the handle is still usable once emptied
+    assert(list->head == list->tail && list_length(list) == 1);
+
+    list_free_all(list);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_LIST_SIZE 1000000
+#define BENCH_POOL_CHURN 4000000
+
+// builds a list, churns it with delete_after/insert_after pairs, traverses it and frees it
+void bench_list_churn(const char* name, NodePool* pool, int use_pool) {
+    int* arr = (int*)malloc(sizeof(int) * BENCH_LIST_SIZE);
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) arr[i] = i;
+    char label[64];
+
+    long long start = now_ns();
+    Node* head = pool_create_nodes_from_array(pool, arr, BENCH_LIST_SIZE);
+    long long end = now_ns();
+    snprintf(label, sizeof(label), "%s build", name);
+    print_bench_result(label, end - start, BENCH_LIST_SIZE);
+
+    // interleave deletes from many positions so the recycled nodes end up scattered; the cursor always has a
+    // successor, so every delete succeeds and the list keeps its size
+    Node* cursor = head;
+    start = now_ns();
+    for (int i = 0; i < BENCH_POOL_CHURN; i++) {
+        pool_delete_after(pool, cursor);
+        insert_after(cursor, pool_create_node(pool, i));
+        Node* next = cursor->next->next;
+        cursor = next != NULL && next->next != NULL ? next : head;
+    }
+    end = now_ns();
+    snprintf(label, sizeof(label), "%s churn (delete+insert)", name);
+    print_bench_result(label, end - start, BENCH_POOL_CHURN);
+
+    start = now_ns();
+    Node* found = search(head, -1);
+    end = now_ns();
+    snprintf(label, sizeof(label), "%s traverse", name);
+    print_bench_result(label, end - start, BENCH_LIST_SIZE);
+    bench_keep(found != NULL);
+    assert(found == NULL);
+
+    start = now_ns();
+    if (use_pool)
+        pool_destroy(pool);
+    else
+        free_all(head);
+    end = now_ns();
+    snprintf(label, sizeof(label), "%s free", name);
+    print_bench_result(label, end - start, BENCH_LIST_SIZE);
+
+    free(arr);
+}
+
+void bench_bulk_build_and_traverse() {
+    print_test_func_name();
+
+    int* arr = (int*)malloc(sizeof(int) * BENCH_LIST_SIZE);
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) arr[i] = i;
+
+    long long start = now_ns();
+    Node* head = create_nodes_from_array(arr, BENCH_LIST_SIZE);
+    long long end = now_ns();
+    print_bench_result("malloc build", end - start, BENCH_LIST_SIZE);
+
+    start = now_ns();
+    Node* found_node = search(head, -1);
+    end = now_ns();
+    print_bench_result("malloc traverse", end - start, BENCH_LIST_SIZE);
+    bench_keep(found_node != NULL);
+    assert(found_node == NULL);
+
+    start = now_ns();
+    free_all(head);
+    end = now_ns();
+    print_bench_result("malloc free", end - start, BENCH_LIST_SIZE);
+
+    NodeBlock block;
+    start = now_ns();
+    head = bulk_create_nodes_from_array(&block, arr, BENCH_LIST_SIZE);
+    end = now_ns();
+    print_bench_result("bulk build", end - start, BENCH_LIST_SIZE);
+
+    start = now_ns();
+    found_node = search(head, -1);
+    end = now_ns();
+    print_bench_result("bulk traverse", end - start, BENCH_LIST_SIZE);
+    bench_keep(found_node != NULL);
+    assert(found_node == NULL);
+
+    start = now_ns();
+    bulk_free_all(&block, NULL);
+    end = now_ns();
+    print_bench_result("bulk free", end - start, BENCH_LIST_SIZE);
+
+    // the reference point: a plain linear scan over the source array
+    volatile int found = -1;
+    start = now_ns();
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+        if (arr[i] == -1) {
+            found = i;
+            break;
+        }
+    }
+    end = now_ns();
+    print_bench_result("array scan", end - start, BENCH_LIST_SIZE);
+    (void)found;
+
+    free(arr);
+}
+
+void bench_pool_vs_malloc() {
+    print_test_func_name();
+    bench_list_churn("malloc", NULL, 0);
+    bench_list_churn("pool", pool_create(sizeof(Node), 0), 1);
+}
+
+/* harness cases, see bench_run in test_helper.h: a List of 0..size-1 is built once per size */
+#define BENCH_CHURN_OPS 1000
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    int* arr;
+    List* list;
+    Node* middle;
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) state->arr[i] = i;
+    state->list = list_create_from_array(state->arr, size);
+    state->middle = find_kth(state->list->head, size / 2);
+    bench_common_init(&state->common);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    list_free_all(b->list);
+    free(b->arr);
+    free(b);
+}
+
+static long long bench_build_and_free(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    Node* head = create_nodes_from_array(b->arr, size);
+    b->common.sink += head->data;
+    free_all(head);
+    return size;
+}
+
+static long long bench_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += search(b->list->head, key)->data;
+    return 1;
+}
+
+static long long bench_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int k = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += find_kth(b->list->head, k)->data;
+    return 1;
+}
+
+static long long bench_insert_and_delete_after(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    for (int i = 0; i < BENCH_CHURN_OPS; i++) {
+        insert_after(b->middle, create_node(size + i));
+        delete_after(b->middle);
+    }
+    return BENCH_CHURN_OPS;
+}
+
+static long long bench_list_append_and_delete_head(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    for (int i = 0; i < BENCH_CHURN_OPS; i++) {
+        list_append(b->list, create_node(size + i));
+        list_delete_head(b->list);
+    }
+    return BENCH_CHURN_OPS;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"create_nodes_from_array+free_all", bench_setup, NULL, bench_build_and_free, bench_teardown},
+    {"search", bench_setup, NULL, bench_search, bench_teardown},
+    {"find_kth", bench_setup, NULL, bench_find_kth, bench_teardown},
+    {"insert_after+delete_after", bench_setup, NULL, bench_insert_and_delete_after, bench_teardown},
+    {"list_append+list_delete_head", bench_setup, NULL, bench_list_append_and_delete_head, bench_teardown},
+};
+
 int main(int argc, char** argv) {
     int should_run_tests = has_test_flag(argc, argv);
     if (should_run_tests) {
@@ -272,6 +759,22 @@ int main(int argc, char** argv) {
         test_prepend();
         test_prepend_and_swap_ptr();
         test_append();
+        test_pool_create_nodes_from_array();
+        test_pool_delete_after_recycles_node();
+        test_bulk_create_nodes_from_array();
+        test_bulk_insert_and_delete();
+        test_list_append_and_length();
+        test_list_prepend_and_insert_after();
+        test_list_delete();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) {
+            bench_pool_vs_malloc();
+            bench_bulk_build_and_traverse();
+        }
     }
 
     return 0;
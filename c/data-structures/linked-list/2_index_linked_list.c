@@ -0,0 +1,905 @@
+/*
+- index-linked versions of 1_singly_linked_list.c (idx_*) and 1_doubly_linked_list_sentinel.c (idxd_*)
+- every node lives in one growable array (an arena) and links are uint32_t indices into it: 8 bytes per singly
+  node and 12 per doubly node instead of 16 and 24 with pointers, and no malloc header per node
+- IDX_NIL plays the role of NULL; an index stays valid when the arena grows, a pointer into it does not, so keep
+  indices and use idx_node / idxd_node only for short accesses
+- freed slots go on a free list threaded through their next field and are reused first
+- the arena is the pool and the bulk block of the pointer versions at once: many lists can share one arena and
+  freeing the arena frees all of them in O(1)
+- nothing inside an arena is a pointer, so idx_arena_clone / idxd_arena_clone copy it with one memcpy and every
+  index (and every list handle) is valid in the copy
+- the list handles hold indices only and are plain values
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "test_helper.h"
+
+#define IDX_NIL UINT32_MAX
+#define IDX_DEFAULT_CAPACITY 16
+
+typedef struct IdxNode {
+    int data;
+    uint32_t next;
+} IdxNode;
+
+typedef struct IdxArena {
+    IdxNode* nodes;
+    uint32_t size;  // slots handed out at least once
+    uint32_t capacity;
+    uint32_t free_head;  // freed slots, linked through next
+} IdxArena;
+
+IdxArena* idx_arena_create(uint32_t capacity) {
+    IdxArena* arena = (IdxArena*)malloc(sizeof(*arena));
+    arena->capacity = capacity > 0 ? capacity : IDX_DEFAULT_CAPACITY;
+    arena->nodes = (IdxNode*)malloc(sizeof(IdxNode) * arena->capacity);
+    arena->size = 0;
+    arena->free_head = IDX_NIL;
+    return arena;
+}
+
+// frees every list of the arena at once
+void idx_arena_destroy(IdxArena* arena) {
+    free(arena->nodes);
+    free(arena);
+}
+
+IdxArena* idx_arena_clone(const IdxArena* arena) {
+    IdxArena* clone = (IdxArena*)malloc(sizeof(*clone));
+    *clone = *arena;
+    clone->nodes = (IdxNode*)malloc(sizeof(IdxNode) * arena->capacity);
+    memcpy(clone->nodes, arena->nodes, sizeof(IdxNode) * arena->size);
+    return clone;
+}
+
+static inline IdxNode* idx_node(const IdxArena* arena, uint32_t index) {
+    return &arena->nodes[index];
+}
+
+uint32_t idx_create_node(IdxArena* arena, int data) {
+    uint32_t index = arena->free_head;
+    if (index != IDX_NIL) {
+        arena->free_head = arena->nodes[index].next;
+    } else {
+        if (arena->size == arena->capacity) {
+            assert(arena->capacity <= (IDX_NIL - 1) / 2);
+            arena->capacity *= 2;
+            arena->nodes = (IdxNode*)realloc(arena->nodes, sizeof(IdxNode) * arena->capacity);
+        }
+        index = arena->size++;
+    }
+    arena->nodes[index] = (IdxNode){data, IDX_NIL};
+    return index;
+}
+
+void idx_free_node(IdxArena* arena, uint32_t index) {
+    arena->nodes[index].next = arena->free_head;
+    arena->free_head = index;
+}
+
+uint32_t idx_create_nodes_from_array(IdxArena* arena, int a[], int size) {
+    uint32_t head = IDX_NIL;
+    uint32_t node = IDX_NIL;
+    for (int i = 0; i < size; i++) {
+        uint32_t n = idx_create_node(arena, a[i]);
+        if (i == 0)
+            head = n;
+        else
+            arena->nodes[node].next = n;
+        node = n;
+    }
+    return head;
+}
+
+// returns every slot of the list to the free list: O(n), destroying the arena is O(1)
+void idx_free_all(IdxArena* arena, uint32_t head) {
+    while (head != IDX_NIL) {
+        uint32_t next = arena->nodes[head].next;
+        idx_free_node(arena, head);
+        head = next;
+    }
+}
+
+int idx_delete_after(IdxArena* arena, uint32_t node) {
+    uint32_t node_to_del = arena->nodes[node].next;
+    if (node_to_del == IDX_NIL) {
+        return -1;
+    }
+
+    arena->nodes[node].next = arena->nodes[node_to_del].next;
+    idx_free_node(arena, node_to_del);
+    return 0;
+}
+
+void idx_insert_after(IdxArena* arena, uint32_t node, uint32_t new_node) {
+    arena->nodes[new_node].next = arena->nodes[node].next;
+    arena->nodes[node].next = new_node;
+}
+
+uint32_t idx_find_kth(const IdxArena* arena, uint32_t head, int k) {
+    uint32_t node = head;
+    for (int i = 0; i < k; i++) {
+        node = arena->nodes[node].next;
+    }
+    return node;
+}
+
+uint32_t idx_search(const IdxArena* arena, uint32_t head, int key) {
+    for (uint32_t n = head; n != IDX_NIL; n = arena->nodes[n].next) {
+        if (arena->nodes[n].data == key) return n;
+    }
+    return IDX_NIL;
+}
+
+// returns the new head
+uint32_t idx_prepend(IdxArena* arena, uint32_t head, uint32_t new_node) {
+    arena->nodes[new_node].next = head;
+    return new_node;
+}
+
+void idx_append(IdxArena* arena, uint32_t head, uint32_t new_node) {
+    uint32_t n = head;
+    while (arena->nodes[n].next != IDX_NIL) {
+        n = arena->nodes[n].next;
+    }
+    arena->nodes[n].next = new_node;
+}
+
+typedef struct IdxList {
+    uint32_t head;
+    uint32_t tail;
+    int size;
+} IdxList;
+
+IdxList idx_list_create() {
+    return (IdxList){IDX_NIL, IDX_NIL, 0};
+}
+
+void idx_list_free_all(IdxArena* arena, IdxList* list) {
+    idx_free_all(arena, list->head);
+    *list = idx_list_create();
+}
+
+int idx_list_length(const IdxList* list) {
+    return list->size;
+}
+
+void idx_list_append(IdxArena* arena, IdxList* list, uint32_t new_node) {
+    if (list->tail == IDX_NIL)
+        list->head = new_node;
+    else
+        idx_insert_after(arena, list->tail, new_node);
+    list->tail = new_node;
+    list->size++;
+}
+
+IdxList idx_list_create_from_array(IdxArena* arena, int a[], int size) {
+    IdxList list = idx_list_create();
+    for (int i = 0; i < size; i++) {
+        idx_list_append(arena, &list, idx_create_node(arena, a[i]));
+    }
+    return list;
+}
+
+void idx_list_prepend(IdxArena* arena, IdxList* list, uint32_t new_node) {
+    list->head = idx_prepend(arena, list->head, new_node);
+    if (list->tail == IDX_NIL) list->tail = new_node;
+    list->size++;
+}
+
+void idx_list_insert_after(IdxArena* arena, IdxList* list, uint32_t node, uint32_t new_node) {
+    idx_insert_after(arena, node, new_node);
+    if (node == list->tail) list->tail = new_node;
+    list->size++;
+}
+
+int idx_list_delete_after(IdxArena* arena, IdxList* list, uint32_t node) {
+    if (arena->nodes[node].next == list->tail) list->tail = node;
+    if (idx_delete_after(arena, node) != 0) return -1;
+    list->size--;
+    return 0;
+}
+
+int idx_list_delete_head(IdxArena* arena, IdxList* list) {
+    if (list->head == IDX_NIL) return -1;
+
+    uint32_t node_to_del = list->head;
+    list->head = arena->nodes[node_to_del].next;
+    if (list->head == IDX_NIL) list->tail = IDX_NIL;
+    idx_free_node(arena, node_to_del);
+    list->size--;
+    return 0;
+}
+
+/*
+- the doubly version with sentinels: dummy_tail is the only node whose next is IDX_NIL, so the node-level
+  walks stop at it without knowing the list
+*/
+typedef struct IdxDNode {
+    int data;
+    uint32_t prev;
+    uint32_t next;
+} IdxDNode;
+
+typedef struct IdxDArena {
+    IdxDNode* nodes;
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t free_head;
+} IdxDArena;
+
+IdxDArena* idxd_arena_create(uint32_t capacity) {
+    IdxDArena* arena = (IdxDArena*)malloc(sizeof(*arena));
+    arena->capacity = capacity > 0 ? capacity : IDX_DEFAULT_CAPACITY;
+    arena->nodes = (IdxDNode*)malloc(sizeof(IdxDNode) * arena->capacity);
+    arena->size = 0;
+    arena->free_head = IDX_NIL;
+    return arena;
+}
+
+void idxd_arena_destroy(IdxDArena* arena) {
+    free(arena->nodes);
+    free(arena);
+}
+
+IdxDArena* idxd_arena_clone(const IdxDArena* arena) {
+    IdxDArena* clone = (IdxDArena*)malloc(sizeof(*clone));
+    *clone = *arena;
+    clone->nodes = (IdxDNode*)malloc(sizeof(IdxDNode) * arena->capacity);
+    memcpy(clone->nodes, arena->nodes, sizeof(IdxDNode) * arena->size);
+    return clone;
+}
+
+static inline IdxDNode* idxd_node(const IdxDArena* arena, uint32_t index) {
+    return &arena->nodes[index];
+}
+
+uint32_t idxd_create_node(IdxDArena* arena, int data) {
+    uint32_t index = arena->free_head;
+    if (index != IDX_NIL) {
+        arena->free_head = arena->nodes[index].next;
+    } else {
+        if (arena->size == arena->capacity) {
+            assert(arena->capacity <= (IDX_NIL - 1) / 2);
+            arena->capacity *= 2;
+            arena->nodes = (IdxDNode*)realloc(arena->nodes, sizeof(IdxDNode) * arena->capacity);
+        }
+        index = arena->size++;
+    }
+    arena->nodes[index] = (IdxDNode){data, IDX_NIL, IDX_NIL};
+    return index;
+}
+
+void idxd_free_node(IdxDArena* arena, uint32_t index) {
+    arena->nodes[index].next = arena->free_head;
+    arena->free_head = index;
+}
+
+// assumes that node is NOT the dummy tail
+void idxd_insert_after(IdxDArena* arena, uint32_t node, uint32_t new_node) {
+    IdxDNode* nodes = arena->nodes;
+    uint32_t next = nodes[node].next;
+    nodes[new_node].next = next;
+    nodes[new_node].prev = node;
+    nodes[next].prev = new_node;
+    nodes[node].next = new_node;
+}
+
+// assumes that node is NOT a sentinel node, its slot is recycled
+void idxd_delete_node(IdxDArena* arena, uint32_t node) {
+    IdxDNode* nodes = arena->nodes;
+    nodes[nodes[node].prev].next = nodes[node].next;
+    nodes[nodes[node].next].prev = nodes[node].prev;
+    idxd_free_node(arena, node);
+}
+
+// k from the real node head, assumes that the list has more than k nodes after it
+uint32_t idxd_find_kth(const IdxDArena* arena, uint32_t head, int k) {
+    uint32_t node = head;
+    for (int i = 0; i < k; i++) {
+        node = arena->nodes[node].next;
+    }
+    return node;
+}
+
+// IDX_NIL if no real node from head on holds key
+uint32_t idxd_search(const IdxDArena* arena, uint32_t head, int key) {
+    for (uint32_t n = head; arena->nodes[n].next != IDX_NIL; n = arena->nodes[n].next) {
+        if (arena->nodes[n].data == key) return n;
+    }
+    return IDX_NIL;
+}
+
+// head is a real node: new_node goes between it and its predecessor
+void idxd_prepend(IdxDArena* arena, uint32_t head, uint32_t new_node) {
+    idxd_insert_after(arena, arena->nodes[head].prev, new_node);
+}
+
+void idxd_append(IdxDArena* arena, uint32_t head, uint32_t new_node) {
+    uint32_t n = head;
+    while (arena->nodes[n].next != IDX_NIL) {  // iterates until n is dummy_tail
+        n = arena->nodes[n].next;
+    }
+    idxd_insert_after(arena, arena->nodes[n].prev, new_node);
+}
+
+typedef struct IdxDList {
+    uint32_t dummy_head;
+    uint32_t dummy_tail;
+    int size;
+} IdxDList;
+
+IdxDList idxd_list_create(IdxDArena* arena) {
+    IdxDList list = {idxd_create_node(arena, 0), idxd_create_node(arena, 0), 0};
+    arena->nodes[list.dummy_head].next = list.dummy_tail;
+    arena->nodes[list.dummy_tail].prev = list.dummy_head;
+    return list;
+}
+
+// recycles every slot, the sentinels included
+void idxd_list_free_all(IdxDArena* arena, IdxDList* list) {
+    uint32_t node = list->dummy_head;
+    while (node != IDX_NIL) {
+        uint32_t next = arena->nodes[node].next;
+        idxd_free_node(arena, node);
+        node = next;
+    }
+    list->size = 0;
+    list->dummy_head = list->dummy_tail = IDX_NIL;
+}
+
+int idxd_list_length(const IdxDList* list) {
+    return list->size;
+}
+
+// first and last real node, IDX_NIL for an empty list
+uint32_t idxd_list_head(const IdxDArena* arena, const IdxDList* list) {
+    return list->size > 0 ? arena->nodes[list->dummy_head].next : IDX_NIL;
+}
+
+uint32_t idxd_list_tail(const IdxDArena* arena, const IdxDList* list) {
+    return list->size > 0 ? arena->nodes[list->dummy_tail].prev : IDX_NIL;
+}
+
+void idxd_list_insert_after(IdxDArena* arena, IdxDList* list, uint32_t node, uint32_t new_node) {
+    idxd_insert_after(arena, node, new_node);
+    list->size++;
+}
+
+void idxd_list_append(IdxDArena* arena, IdxDList* list, uint32_t new_node) {
+    idxd_list_insert_after(arena, list, arena->nodes[list->dummy_tail].prev, new_node);
+}
+
+void idxd_list_prepend(IdxDArena* arena, IdxDList* list, uint32_t new_node) {
+    idxd_list_insert_after(arena, list, list->dummy_head, new_node);
+}
+
+IdxDList idxd_list_create_from_array(IdxDArena* arena, int a[], int size) {
+    IdxDList list = idxd_list_create(arena);
+    for (int i = 0; i < size; i++) {
+        idxd_list_append(arena, &list, idxd_create_node(arena, a[i]));
+    }
+    return list;
+}
+
+void idxd_list_delete_node(IdxDArena* arena, IdxDList* list, uint32_t node) {
+    idxd_delete_node(arena, node);
+    list->size--;
+}
+
+// the sorting helpers only follow next, the prev indices are rebuilt in one pass at the end of the sort
+static uint32_t idxd_merge_two_sorted(IdxDNode* nodes, uint32_t head1, uint32_t head2) {
+    uint32_t head = IDX_NIL;
+    uint32_t* link = &head;  // the next field to write, like a sentinel
+    while (head1 != IDX_NIL && head2 != IDX_NIL) {
+        uint32_t* taken = nodes[head1].data <= nodes[head2].data ? &head1 : &head2;
+        *link = *taken;
+        link = &nodes[*taken].next;
+        *taken = nodes[*taken].next;
+    }
+
+    *link = head1 != IDX_NIL ? head1 : head2;
+
+    return head;
+}
+
+// detaches the natural run starting at *rest, a strictly decreasing run is reversed
+static uint32_t idxd_take_run(IdxDNode* nodes, uint32_t* rest) {
+    uint32_t head = *rest;
+    uint32_t n = head;
+
+    if (nodes[n].next != IDX_NIL && nodes[nodes[n].next].data < nodes[n].data) {
+        uint32_t reversed = IDX_NIL;
+        while (n != IDX_NIL && (reversed == IDX_NIL || nodes[n].data < nodes[reversed].data)) {
+            uint32_t next = nodes[n].next;
+            nodes[n].next = reversed;
+            reversed = n;
+            n = next;
+        }
+        *rest = n;
+        return reversed;
+    }
+
+    while (nodes[n].next != IDX_NIL && nodes[nodes[n].next].data >= nodes[n].data) {
+        n = nodes[n].next;
+    }
+    *rest = nodes[n].next;
+    nodes[n].next = IDX_NIL;
+    return head;
+}
+
+#define MERGE_SORT_SLOTS 64
+
+// stable, in place, O(1) extra memory: the natural merge sort of 1_doubly_linked_list_sentinel.c on indices
+void idxd_list_merge_sort(IdxDArena* arena, IdxDList* list) {
+    if (list->size < 2) return;
+
+    IdxDNode* nodes = arena->nodes;
+    nodes[nodes[list->dummy_tail].prev].next = IDX_NIL;
+    uint32_t pending[MERGE_SORT_SLOTS];  // pending[i] holds the merge of 2^i runs
+    for (int i = 0; i < MERGE_SORT_SLOTS; i++) pending[i] = IDX_NIL;
+    uint32_t rest = nodes[list->dummy_head].next;
+
+    while (rest != IDX_NIL) {
+        uint32_t run = idxd_take_run(nodes, &rest);
+        int i = 0;
+        while (i < MERGE_SORT_SLOTS - 1 && pending[i] != IDX_NIL) {
+            run = idxd_merge_two_sorted(nodes, pending[i], run);
+            pending[i] = IDX_NIL;
+            i++;
+        }
+        pending[i] = run;
+    }
+
+    uint32_t head = IDX_NIL;
+    for (int i = 0; i < MERGE_SORT_SLOTS; i++) {
+        if (pending[i] != IDX_NIL) head = idxd_merge_two_sorted(nodes, pending[i], head);
+    }
+
+    uint32_t prev = list->dummy_head;
+    nodes[prev].next = head;
+    for (uint32_t n = head; n != IDX_NIL; n = nodes[n].next) {
+        nodes[n].prev = prev;
+        prev = n;
+    }
+    nodes[prev].next = list->dummy_tail;
+    nodes[list->dummy_tail].prev = prev;
+}
+
+/*
+###############################
+###          tests          ###
+###############################
+*/
+static void assert_idx_list(const IdxArena* arena, const IdxList* list, const int* expected, int size) {
+    int i = 0;
+    uint32_t last = IDX_NIL;
+    for (uint32_t n = list->head; n != IDX_NIL; n = idx_node(arena, n)->next) {
+        assert(i < size && idx_node(arena, n)->data == expected[i]);
+        last = n;
+        i++;
+    }
+    assert(i == size && idx_list_length(list) == size && list->tail == last);
+}
+
+// walks both directions
+static void assert_idxd_list(const IdxDArena* arena, const IdxDList* list, const int* expected, int size) {
+    int i = 0;
+    uint32_t prev = list->dummy_head;
+    for (uint32_t n = idxd_node(arena, list->dummy_head)->next; n != list->dummy_tail; n = idxd_node(arena, n)->next) {
+        assert(i < size && idxd_node(arena, n)->data == expected[i]);
+        assert(idxd_node(arena, n)->prev == prev);
+        prev = n;
+        i++;
+    }
+    assert(i == size && idxd_list_length(list) == size && idxd_node(arena, list->dummy_tail)->prev == prev);
+}
+
+void test_node_sizes() {
+    print_test_func_name();
+
+    assert(sizeof(IdxNode) == 8);
+    assert(sizeof(IdxDNode) == 12);
+
+    passed();
+}
+
+void test_idx_nodes() {
+    print_test_func_name();
+
+    IdxArena* arena = idx_arena_create(2);  // small, so that building grows it
+    int arr[] = {1, 2, 3, 4, 5};
+    uint32_t head = idx_create_nodes_from_array(arena, arr, 5);
+    assert(arena->capacity >= 5);
+
+    assert(idx_node(arena, idx_find_kth(arena, head, 0))->data == 1);
+    assert(idx_node(arena, idx_find_kth(arena, head, 4))->data == 5);
+    assert(idx_search(arena, head, 3) == idx_find_kth(arena, head, 2));
+    assert(idx_search(arena, head, 9) == IDX_NIL);
+
+    idx_insert_after(arena, idx_search(arena, head, 2), idx_create_node(arena, 20));  // 1 2 20 3 4 5
+    assert(idx_delete_after(arena, idx_search(arena, head, 5)) == -1);
+    assert(idx_delete_after(arena, idx_search(arena, head, 3)) == 0);  // 1 2 20 3 5
+    head = idx_prepend(arena, head, idx_create_node(arena, 0));        // 0 1 2 20 3 5
+    idx_append(arena, head, idx_create_node(arena, 6));                // 0 1 2 20 3 5 6
+
+    int expected[] = {0, 1, 2, 20, 3, 5, 6};
+    for (int i = 0; i < 7; i++) assert(idx_node(arena, idx_find_kth(arena, head, i))->data == expected[i]);
+    assert(idx_node(arena, idx_find_kth(arena, head, 6))->next == IDX_NIL);
+    assert(arena->size == 7);  // the slot of 4 was reused for 0
+
+    idx_free_all(arena, head);
+    idx_arena_destroy(arena);
+    passed();
+}
+
+void test_idx_list() {
+    print_test_func_name();
+
+    IdxArena* arena = idx_arena_create(0);
+    IdxList list = idx_list_create();
+    assert(idx_list_delete_head(arena, &list) == -1);
+
+    idx_list_append(arena, &list, idx_create_node(arena, 2));
+    idx_list_prepend(arena, &list, idx_create_node(arena, 1));
+    idx_list_append(arena, &list, idx_create_node(arena, 4));
+    idx_list_insert_after(arena, &list, list.tail, idx_create_node(arena, 5));
+    idx_list_insert_after(arena, &list, idx_search(arena, list.head, 2), idx_create_node(arena, 3));
+    assert_idx_list(arena, &list, (int[]){1, 2, 3, 4, 5}, 5);
+
+    assert(idx_list_delete_after(arena, &list, idx_search(arena, list.head, 4)) == 0);  // the tail
+    assert(idx_list_delete_after(arena, &list, list.tail) == -1);
+    assert(idx_list_delete_head(arena, &list) == 0);
+    assert_idx_list(arena, &list, (int[]){2, 3, 4}, 3);
+
+    IdxList other = idx_list_create_from_array(arena, (int[]){7, 8}, 2);  // lists share the arena
+    assert(arena->size == 5);                                             // both freed slots were reused
+    assert_idx_list(arena, &other, (int[]){7, 8}, 2);
+
+    idx_list_free_all(arena, &list);
+    assert(list.head == IDX_NIL && idx_list_length(&list) == 0);
+    idx_list_free_all(arena, &other);
+    idx_arena_destroy(arena);
+    passed();
+}
+
+void test_idx_arena_clone() {
+    print_test_func_name();
+
+    IdxArena* arena = idx_arena_create(0);
+    IdxList list = idx_list_create_from_array(arena, (int[]){1, 2, 3}, 3);
+    idx_list_delete_head(arena, &list);
+
+    IdxArena* clone = idx_arena_clone(arena);
+    assert_idx_list(clone, &list, (int[]){2, 3}, 2);  // the same handle works on the copy
+    idx_list_append(clone, &list, idx_create_node(clone, 4));
+    assert(idx_node(clone, list.tail)->data == 4 && list.tail == 0);  // the free list was copied too
+    assert(arena->free_head == 0 && arena->size == 3);                  // the original is untouched
+
+    idx_arena_destroy(arena);
+    idx_arena_destroy(clone);
+    passed();
+}
+
+void test_idxd_nodes() {
+    print_test_func_name();
+
+    IdxDArena* arena = idxd_arena_create(1);
+    IdxDList list = idxd_list_create_from_array(arena, (int[]){1, 2, 3}, 3);
+    uint32_t head = idxd_list_head(arena, &list);
+
+    assert(idxd_node(arena, idxd_find_kth(arena, head, 2))->data == 3);
+    assert(idxd_search(arena, head, 2) == idxd_find_kth(arena, head, 1));
+    assert(idxd_search(arena, head, 0) == IDX_NIL);  // the sentinels are never matched
+
+    idxd_prepend(arena, head, idxd_create_node(arena, 0));
+    idxd_append(arena, head, idxd_create_node(arena, 4));
+    idxd_insert_after(arena, idxd_search(arena, head, 2), idxd_create_node(arena, 22));
+    idxd_delete_node(arena, idxd_search(arena, head, 3));
+    list.size += 2;  // node-level calls do not maintain the handle
+    assert_idxd_list(arena, &list, (int[]){0, 1, 2, 22, 4}, 5);
+
+    idxd_list_free_all(arena, &list);
+    idxd_arena_destroy(arena);
+    passed();
+}
+
+void test_idxd_list() {
+    print_test_func_name();
+
+    IdxDArena* arena = idxd_arena_create(0);
+    IdxDList list = idxd_list_create(arena);
+    assert(idxd_list_head(arena, &list) == IDX_NIL && idxd_list_tail(arena, &list) == IDX_NIL);
+
+    idxd_list_append(arena, &list, idxd_create_node(arena, 2));
+    idxd_list_prepend(arena, &list, idxd_create_node(arena, 1));
+    idxd_list_insert_after(arena, &list, idxd_list_tail(arena, &list), idxd_create_node(arena, 3));
+    assert_idxd_list(arena, &list, (int[]){1, 2, 3}, 3);
+
+    uint32_t two = idxd_search(arena, idxd_list_head(arena, &list), 2);
+    idxd_list_delete_node(arena, &list, two);
+    idxd_list_delete_node(arena, &list, idxd_list_head(arena, &list));
+    assert_idxd_list(arena, &list, (int[]){3}, 1);
+    assert(idxd_list_head(arena, &list) == idxd_list_tail(arena, &list));
+
+    uint32_t size = arena->size;
+    uint32_t recycled = idxd_create_node(arena, 9);
+    assert(recycled < size && arena->size == size);  // a freed slot, the arena did not grow
+    idxd_free_node(arena, recycled);
+
+    idxd_list_free_all(arena, &list);
+    idxd_arena_destroy(arena);
+    passed();
+}
+
+void test_idxd_list_merge_sort() {
+    print_test_func_name();
+
+    IdxDArena* arena = idxd_arena_create(0);
+    int arr[] = {5, 1, 4, 2, 8, 0, 2, 9, 7, 3};
+    IdxDList list = idxd_list_create_from_array(arena, arr, 10);
+    uint32_t first_two = idxd_search(arena, idxd_list_head(arena, &list), 2);
+
+    idxd_list_merge_sort(arena, &list);
+    assert_idxd_list(arena, &list, (int[]){0, 1, 2, 2, 3, 4, 5, 7, 8, 9}, 10);
+    assert(idxd_find_kth(arena, idxd_list_head(arena, &list), 2) == first_two);  // stable
+
+    IdxDArena* clone = idxd_arena_clone(arena);
+    assert_idxd_list(clone, &list, (int[]){0, 1, 2, 2, 3, 4, 5, 7, 8, 9}, 10);
+
+    idxd_arena_destroy(clone);
+    idxd_arena_destroy(arena);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_LIST_SIZE 1000000
+
+// the pointer nodes of 1_singly_linked_list.c and 1_doubly_linked_list_sentinel.c, allocated one by one
+typedef struct PtrNode {
+    int data;
+    struct PtrNode* next;
+} PtrNode;
+
+typedef struct PtrDNode {
+    int data;
+    struct PtrDNode* prev;
+    struct PtrDNode* next;
+} PtrDNode;
+
+// bytes currently allocated from the heap, 0 where the allocator cannot tell
+static long long heap_in_use() {
+#ifdef __GLIBC__
+    struct mallinfo2 info = mallinfo2();
+    return (long long)(info.uordblks + info.hblkhd);  // small chunks + large mmapped blocks
+#else
+    return 0;
+#endif
+}
+
+// heap bytes per node, then a full traversal with the nodes linked in allocation order and in shuffled order
+// (a shuffled list is what a long-lived list looks like after many inserts and deletes)
+void bench_singly_footprint_and_traversal() {
+    print_test_func_name();
+
+    int* order = (int*)malloc(sizeof(int) * BENCH_LIST_SIZE);
+    PtrNode** ptr_nodes = (PtrNode**)malloc(sizeof(PtrNode*) * BENCH_LIST_SIZE);
+    char label[64];
+
+    long long before = heap_in_use();
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+        ptr_nodes[i] = (PtrNode*)malloc(sizeof(PtrNode));
+        ptr_nodes[i]->data = i;
+    }
+    printf("%-40s %12.2f bytes/node\n", "pointer Node (malloc)", (double)(heap_in_use() - before) / BENCH_LIST_SIZE);
+
+    before = heap_in_use();
+    IdxArena* arena = idx_arena_create(BENCH_LIST_SIZE);
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) idx_create_node(arena, i);
+    printf("%-40s %12.2f bytes/node\n", "IdxNode (arena)", (double)(heap_in_use() - before) / BENCH_LIST_SIZE);
+
+    const char* layouts[] = {"in order", "shuffled"};
+    for (int layout = 0; layout < 2; layout++) {
+        for (int i = 0; i < BENCH_LIST_SIZE; i++) order[i] = i;
+        uint32_t seed = BENCH_RANDOM_SEED;
+        if (layout == 1) bench_shuffle(order, BENCH_LIST_SIZE, &seed);
+        for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+            int next = i + 1 < BENCH_LIST_SIZE ? order[i + 1] : -1;
+            ptr_nodes[order[i]]->next = next >= 0 ? ptr_nodes[next] : NULL;
+            idx_node(arena, order[i])->next = next >= 0 ? (uint32_t)next : IDX_NIL;
+        }
+
+        long long start = now_ns();
+        int count = 0;
+        for (PtrNode* n = ptr_nodes[order[0]]; n != NULL; n = n->next) count += n->data == -1;
+        snprintf(label, sizeof(label), "pointer Node traverse %s", layouts[layout]);
+        print_bench_result(label, now_ns() - start, BENCH_LIST_SIZE);
+
+        start = now_ns();
+        count += idx_search(arena, order[0], -1) != IDX_NIL;
+        snprintf(label, sizeof(label), "IdxNode traverse %s", layouts[layout]);
+        print_bench_result(label, now_ns() - start, BENCH_LIST_SIZE);
+        assert(count == 0);
+    }
+
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) free(ptr_nodes[i]);
+    free(ptr_nodes);
+    free(order);
+    idx_arena_destroy(arena);
+}
+
+void bench_doubly_footprint_and_traversal() {
+    print_test_func_name();
+
+    long long before = heap_in_use();
+    PtrDNode* dummy_head = (PtrDNode*)calloc(1, sizeof(PtrDNode));
+    PtrDNode* dummy_tail = (PtrDNode*)calloc(1, sizeof(PtrDNode));
+    dummy_head->next = dummy_tail;
+    dummy_tail->prev = dummy_head;
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+        PtrDNode* node = (PtrDNode*)malloc(sizeof(*node));
+        *node = (PtrDNode){i, dummy_tail->prev, dummy_tail};
+        dummy_tail->prev->next = node;
+        dummy_tail->prev = node;
+    }
+    printf("%-40s %12.2f bytes/node\n", "pointer sentinel Node (malloc)",
+           (double)(heap_in_use() - before) / BENCH_LIST_SIZE);
+
+    before = heap_in_use();
+    IdxDArena* arena = idxd_arena_create(BENCH_LIST_SIZE + 2);
+    IdxDList list = idxd_list_create(arena);
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) idxd_list_append(arena, &list, idxd_create_node(arena, i));
+    printf("%-40s %12.2f bytes/node\n", "IdxDNode (arena)", (double)(heap_in_use() - before) / BENCH_LIST_SIZE);
+
+    long long start = now_ns();
+    int count = 0;
+    for (PtrDNode* n = dummy_head->next; n != dummy_tail; n = n->next) count += n->data == -1;
+    print_bench_result("pointer sentinel forward", now_ns() - start, BENCH_LIST_SIZE);
+    start = now_ns();
+    for (PtrDNode* n = dummy_tail->prev; n != dummy_head; n = n->prev) count += n->data == -1;
+    print_bench_result("pointer sentinel backward", now_ns() - start, BENCH_LIST_SIZE);
+
+    start = now_ns();
+    count += idxd_search(arena, idxd_list_head(arena, &list), -1) != IDX_NIL;
+    print_bench_result("IdxDNode forward", now_ns() - start, BENCH_LIST_SIZE);
+    start = now_ns();
+    const IdxDNode* nodes = arena->nodes;
+    for (uint32_t n = nodes[list.dummy_tail].prev; n != list.dummy_head; n = nodes[n].prev) count += nodes[n].data == -1;
+    print_bench_result("IdxDNode backward", now_ns() - start, BENCH_LIST_SIZE);
+    assert(count == 0);
+
+    start = now_ns();
+    IdxDArena* clone = idxd_arena_clone(arena);
+    print_bench_result("IdxDArena clone (memcpy)", now_ns() - start, BENCH_LIST_SIZE);
+
+    for (PtrDNode* n = dummy_head; n != NULL;) {
+        PtrDNode* next = n->next;
+        free(n);
+        n = next;
+    }
+    idxd_arena_destroy(clone);
+    idxd_arena_destroy(arena);
+}
+
+// harness cases: an IdxList and an IdxDList of 0..size-1 in their own arenas are built once per size
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    IdxArena* arena;
+    IdxList list;
+    IdxDArena* darena;
+    IdxDList dlist;
+} BenchState;
+
+static void* bench_setup(int size) {
+    int* arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) arr[i] = i;
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    bench_common_init(&state->common);
+    state->arena = idx_arena_create((uint32_t)size + 1);
+    state->list = idx_list_create_from_array(state->arena, arr, size);
+    state->darena = idxd_arena_create((uint32_t)size + 2);
+    state->dlist = idxd_list_create_from_array(state->darena, arr, size);
+    free(arr);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    idx_arena_destroy(b->arena);
+    idxd_arena_destroy(b->darena);
+    free(b);
+}
+
+static long long bench_idx_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += idx_node(b->arena, idx_search(b->arena, b->list.head, key))->data;
+    return 1;
+}
+
+static long long bench_idx_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int k = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += idx_node(b->arena, idx_find_kth(b->arena, b->list.head, k))->data;
+    return 1;
+}
+
+// the append reuses the slot the previous delete freed: the length and the arena size stay the same
+static long long bench_idx_append_and_delete_head(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    idx_list_append(b->arena, &b->list, idx_create_node(b->arena, size));
+    idx_list_delete_head(b->arena, &b->list);
+    return 1;
+}
+
+static long long bench_idxd_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += idxd_node(b->darena, idxd_search(b->darena, idxd_list_head(b->darena, &b->dlist), key))->data;
+    return 1;
+}
+
+static void bench_shuffle_data(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    uint32_t n = idxd_list_head(b->darena, &b->dlist);
+    for (int i = 0; i < size; i++, n = idxd_node(b->darena, n)->next) {
+        idxd_node(b->darena, n)->data = (int)(bench_random(&b->common.seed) >> 1);
+    }
+}
+
+static long long bench_idxd_list_merge_sort(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    idxd_list_merge_sort(b->darena, &b->dlist);
+    return size;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"idx_search", bench_setup, NULL, bench_idx_search, bench_teardown},
+    {"idx_find_kth", bench_setup, NULL, bench_idx_find_kth, bench_teardown},
+    {"idx_list_append+idx_list_delete_head", bench_setup, NULL, bench_idx_append_and_delete_head, bench_teardown},
+    {"idxd_search", bench_setup, NULL, bench_idxd_search, bench_teardown},
+    {"idxd_list_merge_sort (random)", bench_setup, bench_shuffle_data, bench_idxd_list_merge_sort, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_node_sizes();
+        test_idx_nodes();
+        test_idx_list();
+        test_idx_arena_clone();
+        test_idxd_nodes();
+        test_idxd_list();
+        test_idxd_list_merge_sort();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) {
+            bench_singly_footprint_and_traversal();
+            bench_doubly_footprint_and_traversal();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,451 @@
+/*
+- a singly linked list whose nodes carry a jump pointer to the node distance steps ahead, so that search and
+  find_kth can __builtin_prefetch it while they work on the current node: with distance d, d cache misses are in
+  flight at once instead of one, which hides the latency of lists far larger than the LLC
+- jump pointers are hints only: every walk follows next, a jump is only ever passed to __builtin_prefetch, which does
+  not fault. A wrong or stale jump costs a useless prefetch, never a wrong result
+- the index is built lazily: the first search or find_kth after creation, after jump_list_set_distance or after
+  too many edits rebuilds every jump in one O(n) pass
+- insert_after and delete_after repair locally in O(1): a new node inherits the jump of its predecessor (one step
+  short), the predecessor of a deleted node takes over its jump. Jumps that pointed to a deleted node are left
+  stale, and distances drift by one per edit; after size / JUMP_REBUILD_RATIO edits the next walk rebuilds
+- interval N gives only every Nth node a jump (the others hold NULL): cheaper to build, but only one node in N is
+  prefetched, so interval 1 is the one that hides latency; distance 0 turns prefetching off
+- a node is 24 bytes instead of 16 for the jump
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_helper.h"
+
+#define JUMP_DEFAULT_DISTANCE 16
+#define JUMP_REBUILD_RATIO 8
+
+typedef struct Node {
+    int data;
+    struct Node* next;
+    struct Node* jump;  // a prefetch hint, see the header comment
+} Node;
+
+typedef struct JumpList {
+    Node* head;
+    int size;
+    int distance;  // 0: no jumps, no prefetching
+    int interval;  // every interval-th node carries a jump
+    int built;     // the jumps are valid up to the drift of edits
+    int edits;     // inserts and deletes since the last build
+} JumpList;
+
+Node* create_node(int data) {
+    Node* node = (Node*)malloc(sizeof(*node));
+    node->data = data;
+    node->next = NULL;
+    node->jump = NULL;
+    return node;
+}
+
+void free_all(Node* head) {
+    while (head != NULL) {
+        Node* next = head->next;
+        free(head);
+        head = next;
+    }
+}
+
+// plain walks without jumps, for comparison
+Node* search(Node* head, int key) {
+    for (Node* n = head; n != NULL; n = n->next) {
+        if (n->data == key) return n;
+    }
+    return NULL;
+}
+
+Node* find_kth(Node* head, int k) {
+    Node* node = head;
+    for (int i = 0; i < k && node != NULL; i++) node = node->next;
+    return node;
+}
+
+JumpList* jump_list_create(int distance, int interval) {
+    JumpList* list = (JumpList*)malloc(sizeof(*list));
+    list->head = NULL;
+    list->size = 0;
+    list->distance = distance;
+    list->interval = interval > 0 ? interval : 1;
+    list->built = 0;
+    list->edits = 0;
+    return list;
+}
+
+// the jumps are built on the first walk
+JumpList* jump_list_create_from_array(int a[], int size, int distance, int interval) {
+    JumpList* list = jump_list_create(distance, interval);
+    Node sentinel = {0, NULL, NULL};
+    Node* node = &sentinel;
+    for (int i = 0; i < size; i++) {
+        node->next = create_node(a[i]);
+        node = node->next;
+    }
+    list->head = sentinel.next;
+    list->size = size;
+    return list;
+}
+
+void jump_list_free_all(JumpList* list) {
+    free_all(list->head);
+    free(list);
+}
+
+int jump_list_length(const JumpList* list) {
+    return list->size;
+}
+
+// one pass with a lead pointer distance nodes ahead
+void jump_list_build(JumpList* list) {
+    Node* lead = list->head;
+    for (int i = 0; i < list->distance && lead != NULL; i++) lead = lead->next;
+
+    int i = 0;
+    for (Node* n = list->head; n != NULL; n = n->next, i++) {
+        n->jump = list->distance > 0 && i % list->interval == 0 ? lead : NULL;
+        if (lead != NULL) lead = lead->next;
+    }
+    list->built = 1;
+    list->edits = 0;
+}
+
+// distance 0 turns prefetching off, the next walk rebuilds (clears the jumps for 0)
+void jump_list_set_distance(JumpList* list, int distance) {
+    list->distance = distance;
+    list->built = 0;
+}
+
+static inline void jump_list_prepare(JumpList* list) {
+    if (!list->built || (list->distance > 0 && list->edits > list->size / JUMP_REBUILD_RATIO)) {
+        jump_list_build(list);
+    }
+}
+
+// node NULL inserts a new head
+void jump_list_insert_after(JumpList* list, Node* node, Node* new_node) {
+    if (node == NULL) {
+        new_node->next = list->head;
+        new_node->jump = NULL;
+        list->head = new_node;
+    } else {
+        new_node->next = node->next;
+        new_node->jump = node->jump;
+        node->next = new_node;
+    }
+    list->size++;
+    list->edits++;
+}
+
+// node NULL deletes the head; returns -1 if there is nothing to delete
+int jump_list_delete_after(JumpList* list, Node* node) {
+    Node** link = node == NULL ? &list->head : &node->next;
+    Node* node_to_del = *link;
+    if (node_to_del == NULL) return -1;
+
+    *link = node_to_del->next;
+    if (node != NULL && (node->jump == node_to_del || node->jump == NULL)) node->jump = node_to_del->jump;
+    free(node_to_del);
+    list->size--;
+    list->edits++;
+    return 0;
+}
+
+Node* jump_list_search(JumpList* list, int key) {
+    jump_list_prepare(list);
+    for (Node* n = list->head; n != NULL; n = n->next) {
+        __builtin_prefetch(n->jump);
+        if (n->data == key) return n;
+    }
+    return NULL;
+}
+
+// k from 0, NULL if the list has k nodes or less
+Node* jump_list_find_kth(JumpList* list, int k) {
+    jump_list_prepare(list);
+    Node* node = list->head;
+    for (int i = 0; i < k && node != NULL; i++) {
+        __builtin_prefetch(node->jump);
+        node = node->next;
+    }
+    return node;
+}
+
+/*
+###############################
+###          tests          ###
+###############################
+*/
+// every jump is exactly distance ahead (NULL past the tail) on the nodes of the interval, NULL elsewhere
+static void assert_exact_jumps(const JumpList* list) {
+    int i = 0;
+    for (Node* n = list->head; n != NULL; n = n->next, i++) {
+        Node* expected = list->distance > 0 && i % list->interval == 0 ? find_kth(n, list->distance) : NULL;
+        assert(n->jump == expected);
+    }
+    assert(i == list->size);
+}
+
+static void assert_values(JumpList* list, const int* expected, int size) {
+    assert(jump_list_length(list) == size);
+    for (int i = 0; i < size; i++) assert(jump_list_find_kth(list, i)->data == expected[i]);
+    assert(jump_list_find_kth(list, size) == NULL);
+}
+
+void test_build_is_lazy() {
+    print_test_func_name();
+
+    int arr[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    JumpList* list = jump_list_create_from_array(arr, 10, 3, 1);
+    assert(!list->built && list->head->jump == NULL);
+
+    assert(jump_list_search(list, 7)->data == 7);
+    assert(list->built);
+    assert_exact_jumps(list);
+    assert(list->head->jump->data == 3 && find_kth(list->head, 7)->jump == NULL);
+    assert(jump_list_search(list, 10) == NULL);
+
+    jump_list_free_all(list);
+    passed();
+}
+
+void test_distance_and_interval() {
+    print_test_func_name();
+
+    int arr[100];
+    for (int i = 0; i < 100; i++) arr[i] = i;
+    JumpList* list = jump_list_create_from_array(arr, 100, 8, 4);
+    assert(jump_list_find_kth(list, 50)->data == 50);
+    assert_exact_jumps(list);
+    assert(list->head->jump->data == 8 && list->head->next->jump == NULL);
+
+    jump_list_set_distance(list, 1);
+    assert(!list->built);
+    assert(jump_list_search(list, 99)->data == 99);
+    assert_exact_jumps(list);
+
+    jump_list_set_distance(list, 0);  // no prefetching, the walks still work
+    assert(jump_list_search(list, 42)->data == 42 && jump_list_find_kth(list, 99)->data == 99);
+    assert(list->head->jump == NULL);
+
+    JumpList* empty = jump_list_create(4, 1);
+    assert(jump_list_search(empty, 1) == NULL && jump_list_find_kth(empty, 0) == NULL);
+    jump_list_free_all(empty);
+
+    jump_list_free_all(list);
+    passed();
+}
+
+void test_insert_and_delete_repair() {
+    print_test_func_name();
+
+    int arr[64];
+    for (int i = 0; i < 64; i++) arr[i] = 10 * i;
+    JumpList* list = jump_list_create_from_array(arr, 64, 2, 1);
+    jump_list_build(list);
+
+    Node* node = jump_list_search(list, 20);
+    jump_list_insert_after(list, node, create_node(25));
+    assert(node->next->jump == node->jump);  // inherits its predecessor's, one step short
+    jump_list_insert_after(list, NULL, create_node(-10));
+    Node* before = jump_list_search(list, 40);
+    Node* deleted_jump = before->next->jump;
+    assert(jump_list_delete_after(list, before) == 0);  // deletes 50
+    assert(before->jump->data == 60 && deleted_jump->data == 70);  // the jump of 50 is not taken: 40 has its own
+    assert(jump_list_delete_after(list, NULL) == 0);  // deletes -10
+    assert(jump_list_delete_after(list, find_kth(list->head, 63)) == -1);
+    int expected[64] = {0, 10, 20, 25, 30, 40};
+    for (int i = 6; i < 64; i++) expected[i] = 10 * i;
+    assert_values(list, expected, 64);
+    assert(list->edits == 4 && list->built);  // within 64 / JUMP_REBUILD_RATIO: no rebuild yet
+
+    // the drift is repaired by the rebuild that follows more than size / JUMP_REBUILD_RATIO edits
+    for (int i = 0; i < 5; i++) jump_list_insert_after(list, list->head, create_node(5));
+    assert(list->edits == 9);
+    assert(jump_list_search(list, 5) != NULL && list->edits == 0);
+    assert_exact_jumps(list);
+
+    jump_list_free_all(list);
+    passed();
+}
+
+// random edits against an array model, with jumps that point to freed nodes in between rebuilds
+void test_random_edits() {
+    print_test_func_name();
+
+    int model[512];
+    int size = 256;
+    for (int i = 0; i < size; i++) model[i] = i;
+    JumpList* list = jump_list_create_from_array(model, size, 5, 1);
+    uint32_t seed = 7;
+
+    for (int step = 0; step < 2000; step++) {
+        int pos = (int)(bench_random(&seed) % (uint32_t)size);
+        if (bench_random(&seed) % 2 == 0 && size < 512) {
+            int value = 1000 + step;
+            jump_list_insert_after(list, pos == 0 ? NULL : jump_list_find_kth(list, pos - 1), create_node(value));
+            for (int i = size; i > pos; i--) model[i] = model[i - 1];
+            model[pos] = value;
+            size++;
+        } else if (size > 1) {
+            jump_list_delete_after(list, pos == 0 ? NULL : jump_list_find_kth(list, pos - 1));
+            for (int i = pos; i < size - 1; i++) model[i] = model[i + 1];
+            size--;
+        }
+        assert(jump_list_search(list, model[size / 2]) == jump_list_find_kth(list, size / 2));
+    }
+    assert_values(list, model, size);
+
+    jump_list_free_all(list);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_LIST_SIZE 16000000  // 384 MB of nodes, more than the LLC
+#define BENCH_WALKS 2
+
+// nodes allocated one by one, then linked in shuffled order
+static JumpList* create_shuffled_list(int size, int distance, int interval) {
+    Node** nodes = (Node**)malloc(sizeof(Node*) * size);
+    for (int i = 0; i < size; i++) nodes[i] = create_node(i);
+    uint32_t seed = BENCH_RANDOM_SEED;
+
+    JumpList* list = jump_list_create(distance, interval);
+    list->head = (Node*)bench_link_scattered((void**)nodes, size, offsetof(Node, next), &seed);
+    list->size = size;
+    free(nodes);
+    return list;
+}
+
+// full walks (a search that misses, find_kth of the last node) per node, for a range of distances
+void bench_prefetch_distance() {
+    print_test_func_name();
+
+    JumpList* list = create_shuffled_list(BENCH_LIST_SIZE, 0, 1);
+    long long total = (long long)BENCH_WALKS * BENCH_LIST_SIZE;
+    char label[64];
+
+    int misses = 0;
+    long long start = now_ns();
+    for (int r = 0; r < BENCH_WALKS; r++) misses += search(list->head, -1 - r) == NULL;
+    print_bench_result("search without jumps", now_ns() - start, total);
+    bench_keep(misses);
+    assert(misses == BENCH_WALKS);
+
+    int hits = 0;
+    start = now_ns();
+    for (int r = 0; r < BENCH_WALKS; r++) hits += find_kth(list->head, BENCH_LIST_SIZE - 1 - r) != NULL;
+    print_bench_result("find_kth without jumps", now_ns() - start, total);
+    bench_keep(hits);
+    assert(hits == BENCH_WALKS);
+
+    int distances[] = {1, 2, 4, 8, 16, 32, 64};
+    for (int d = 0; d < 7; d++) {
+        jump_list_set_distance(list, distances[d]);
+        start = now_ns();
+        jump_list_build(list);
+        snprintf(label, sizeof(label), "d=%d build", distances[d]);
+        print_bench_result(label, now_ns() - start, BENCH_LIST_SIZE);
+
+        misses = 0;
+        start = now_ns();
+        for (int r = 0; r < BENCH_WALKS; r++) misses += jump_list_search(list, -1 - r) == NULL;
+        snprintf(label, sizeof(label), "d=%d jump_list_search", distances[d]);
+        print_bench_result(label, now_ns() - start, total);
+        bench_keep(misses);
+        assert(misses == BENCH_WALKS);
+
+        hits = 0;
+        start = now_ns();
+        for (int r = 0; r < BENCH_WALKS; r++) hits += jump_list_find_kth(list, BENCH_LIST_SIZE - 1 - r) != NULL;
+        snprintf(label, sizeof(label), "d=%d jump_list_find_kth", distances[d]);
+        print_bench_result(label, now_ns() - start, total);
+        bench_keep(hits);
+        assert(hits == BENCH_WALKS);
+    }
+
+    list->interval = 4;  // the same distance, a quarter of the prefetches
+    jump_list_set_distance(list, JUMP_DEFAULT_DISTANCE);
+    jump_list_build(list);
+    misses = 0;
+    start = now_ns();
+    for (int r = 0; r < BENCH_WALKS; r++) misses += jump_list_search(list, -1 - r) == NULL;
+    snprintf(label, sizeof(label), "d=%d interval=4 jump_list_search", JUMP_DEFAULT_DISTANCE);
+    print_bench_result(label, now_ns() - start, total);
+    bench_keep(misses);
+    assert(misses == BENCH_WALKS);
+
+    jump_list_free_all(list);
+}
+
+// harness cases: a search for a random key on shuffled lists, with and without jumps
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    JumpList* list;
+} BenchState;
+
+static void* bench_setup_distance(int size, int distance) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->list = create_shuffled_list(size, distance, 1);
+    bench_common_init(&state->common);
+    return state;
+}
+
+static void* bench_setup_plain(int size) {
+    return bench_setup_distance(size, 0);
+}
+
+static void* bench_setup_jumps(int size) {
+    return bench_setup_distance(size, JUMP_DEFAULT_DISTANCE);
+}
+
+static void bench_teardown(void* state) {
+    jump_list_free_all(((BenchState*)state)->list);
+    free(state);
+}
+
+static long long bench_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->common.sink += jump_list_search(b->list, (int)(bench_random(&b->common.seed) % (uint32_t)size))->data;
+    return 1;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"search (shuffled, no jumps)", bench_setup_plain, NULL, bench_search, bench_teardown},
+    {"jump_list_search (shuffled, d=16)", bench_setup_jumps, NULL, bench_search, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_build_is_lazy();
+        test_distance_and_interval();
+        test_insert_and_delete_repair();
+        test_random_edits();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_prefetch_distance();
+    }
+
+    return 0;
+}
@@ -0,0 +1,622 @@
+/*
+- a file format for the singly list of 1_singly_linked_list.c that is used in place: list_map mmaps the file and
+  search, find_kth and traversal run directly on the mapped pages, nothing is deserialized or allocated per node
+- links are byte offsets from the start of the file (0 ends the list), so the file means the same wherever it
+  is mapped
+- the header holds a magic, a version, the node size, the node count, the offset of the head and a checksum of
+  the node area; list_map rejects files whose header does not match (wrong format, version or layout)
+- LIST_MAP_VERIFY also checks the checksum and walks the links once with bounds checks: O(n) but sequential;
+  without it mapping is O(1) and a corrupted file can crash the traversal
+- LIST_MAP_COW maps the file privately and writable: insert_after and delete_after work on the mapping, the file
+  never changes; new nodes come from spare_nodes slots reserved right behind the file's pages, so their links
+  are offsets like any other. mapped_save writes the result to a new file
+- files are native endian and native layout, the version field also catches a byte-swapped header
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "test_helper.h"
+
+#define LIST_FILE_MAGIC "LLSTFILE"
+#define LIST_FILE_VERSION 1
+
+#define LIST_MAP_VERIFY 1
+#define LIST_MAP_COW 2
+
+typedef struct Node {
+    int data;
+    struct Node* next;
+} Node;
+
+Node* create_node(int data) {
+    Node* node = (Node*)malloc(sizeof(*node));
+    node->data = data;
+    node->next = NULL;
+    return node;
+}
+
+Node* create_nodes_from_array(int a[], int size) {
+    Node* head = NULL;
+    Node* node = NULL;
+    for (int i = 0; i < size; i++) {
+        Node* n = create_node(a[i]);
+        if (i == 0)
+            head = n;
+        else
+            node->next = n;
+        node = n;
+    }
+    return head;
+}
+
+void free_all(Node* head) {
+    while (head != NULL) {
+        Node* next = head->next;
+        free(head);
+        head = next;
+    }
+}
+
+Node* search(Node* head, int key) {
+    for (Node* n = head; n != NULL; n = n->next) {
+        if (n->data == key) return n;
+    }
+    return NULL;
+}
+
+typedef struct ListFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t node_size;  // sizeof(FileNode) of the writer
+    uint64_t node_count;
+    uint64_t head;      // offset of the first node, 0 for an empty list
+    uint64_t checksum;  // of the node area, see list_checksum
+    uint64_t reserved[3];
+} ListFileHeader;  // 64 bytes, the node area starts right after it
+
+typedef struct FileNode {
+    int32_t data;
+    uint32_t reserved;
+    uint64_t next;  // offset from the start of the file, 0 ends the list
+} FileNode;
+
+typedef struct MappedList {
+    char* base;
+    size_t mapped_size;  // file pages + spare pages
+    size_t file_size;
+    int flags;
+    uint64_t node_count;
+    uint64_t head;
+    uint64_t spare_next;  // offset of the next unused spare slot
+    uint64_t spare_end;
+    uint64_t free_head;  // spare or file slots unlinked by delete_after, reused first
+} MappedList;
+
+// word-wise FNV-1a variant: one multiply per 8 bytes, the node area is a whole number of words
+static uint64_t list_checksum(const void* data, size_t size) {
+    const uint64_t* words = (const uint64_t*)data;
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size / sizeof(uint64_t); i++) {
+        hash ^= words[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static int write_all(int fd, const void* data, size_t size) {
+    const char* p = (const char*)data;
+    while (size > 0) {
+        ssize_t written = write(fd, p, size);
+        if (written < 0) return -1;
+        p += written;
+        size -= (size_t)written;
+    }
+    return 0;
+}
+
+// next_data yields the data of the nodes in list order, returns 0 past the end
+typedef int (*NextData)(void* iterator, int* data);
+
+// nodes are written in list order, so every link points to the following slot and a traversal is sequential
+static int write_list_file(const char* path, NextData next_data, void* iterator, uint64_t count) {
+    size_t area_size = sizeof(FileNode) * count;
+    FileNode* nodes = (FileNode*)malloc(area_size > 0 ? area_size : 1);
+    int data;
+    for (uint64_t i = 0; i < count; i++) {
+        int more = next_data(iterator, &data);
+        assert(more);
+        (void)more;
+        uint64_t next = i + 1 < count ? sizeof(ListFileHeader) + sizeof(FileNode) * (i + 1) : 0;
+        nodes[i] = (FileNode){data, 0, next};
+    }
+
+    ListFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LIST_FILE_MAGIC, sizeof(header.magic));
+    header.version = LIST_FILE_VERSION;
+    header.node_size = sizeof(FileNode);
+    header.node_count = count;
+    header.head = count > 0 ? sizeof(ListFileHeader) : 0;
+    header.checksum = list_checksum(nodes, area_size);
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int result = fd < 0 ? -1 : 0;
+    if (result == 0) result = write_all(fd, &header, sizeof(header));
+    if (result == 0) result = write_all(fd, nodes, area_size);
+    if (fd >= 0 && close(fd) != 0) result = -1;
+    free(nodes);
+    return result;
+}
+
+static int next_node_data(void* iterator, int* data) {
+    Node** node = (Node**)iterator;
+    if (*node == NULL) return 0;
+    *data = (*node)->data;
+    *node = (*node)->next;
+    return 1;
+}
+
+// returns 0, or -1 if the file cannot be written
+int list_save(Node* head, const char* path) {
+    uint64_t count = 0;
+    for (Node* n = head; n != NULL; n = n->next) count++;
+    Node* iterator = head;
+    return write_list_file(path, next_node_data, &iterator, count);
+}
+
+static inline FileNode* mapped_node(const MappedList* list, uint64_t offset) {
+    return offset != 0 ? (FileNode*)(list->base + offset) : NULL;
+}
+
+static inline uint64_t mapped_offset(const MappedList* list, const FileNode* node) {
+    return node != NULL ? (uint64_t)((const char*)node - list->base) : 0;
+}
+
+FileNode* mapped_head(const MappedList* list) {
+    return mapped_node(list, list->head);
+}
+
+FileNode* mapped_next(const MappedList* list, const FileNode* node) {
+    return mapped_node(list, node->next);
+}
+
+uint64_t mapped_length(const MappedList* list) {
+    return list->node_count;
+}
+
+static int valid_node_offset(uint64_t offset, uint64_t end) {
+    return offset >= sizeof(ListFileHeader) && offset <= end - sizeof(FileNode) &&
+           (offset - sizeof(ListFileHeader)) % sizeof(FileNode) == 0;
+}
+
+// checksum plus a bounded walk: exactly node_count nodes, every link inside the node area
+static int verify_mapped(const MappedList* list, const ListFileHeader* header) {
+    size_t area_size = list->file_size - sizeof(ListFileHeader);
+    if (list_checksum(list->base + sizeof(ListFileHeader), area_size) != header->checksum) return 0;
+
+    uint64_t offset = header->head;
+    for (uint64_t i = 0; i < header->node_count; i++) {
+        if (!valid_node_offset(offset, list->file_size)) return 0;
+        offset = mapped_node(list, offset)->next;
+    }
+    return offset == 0;
+}
+
+void list_unmap(MappedList* list) {
+    munmap(list->base, list->mapped_size);
+    free(list);
+}
+
+// flags: LIST_MAP_VERIFY, LIST_MAP_COW; spare_nodes is the number of nodes insert_after can add (COW only)
+// returns NULL if the file cannot be mapped or is not a list file of this version
+MappedList* list_map(const char* path, int flags, size_t spare_nodes) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ListFileHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    MappedList* list = (MappedList*)calloc(1, sizeof(*list));
+    list->file_size = (size_t)st.st_size;
+    list->flags = flags;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t file_pages = (list->file_size + page - 1) / page * page;
+    if (!(flags & LIST_MAP_COW)) spare_nodes = 0;
+    list->mapped_size = file_pages + (sizeof(FileNode) * spare_nodes + page - 1) / page * page;
+
+    int prot = flags & LIST_MAP_COW ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* base = MAP_FAILED;
+    if (spare_nodes > 0) {
+        // reserve file + spare pages in one anonymous block, then put the file over its beginning
+        base = mmap(NULL, list->mapped_size, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base != MAP_FAILED && mmap(base, list->file_size, prot, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            munmap(base, list->mapped_size);
+            base = MAP_FAILED;
+        }
+    } else {
+        base = mmap(NULL, list->file_size, prot, flags & LIST_MAP_COW ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+        list->mapped_size = list->file_size;
+    }
+    close(fd);  // the mapping keeps the file
+    if (base == MAP_FAILED) {
+        free(list);
+        return NULL;
+    }
+    list->base = (char*)base;
+
+    const ListFileHeader* header = (const ListFileHeader*)list->base;
+    int ok = memcmp(header->magic, LIST_FILE_MAGIC, sizeof(header->magic)) == 0 &&
+             header->version == LIST_FILE_VERSION && header->node_size == sizeof(FileNode) &&
+             list->file_size == sizeof(ListFileHeader) + sizeof(FileNode) * header->node_count;
+    if (ok && (flags & LIST_MAP_VERIFY)) ok = verify_mapped(list, header);
+    if (!ok) {
+        list_unmap(list);
+        return NULL;
+    }
+
+    list->node_count = header->node_count;
+    list->head = header->head;
+    list->spare_next = file_pages;
+    list->spare_end = file_pages + sizeof(FileNode) * spare_nodes;
+    return list;
+}
+
+FileNode* mapped_find_kth(const MappedList* list, uint64_t k) {
+    FileNode* node = mapped_head(list);
+    for (uint64_t i = 0; i < k && node != NULL; i++) node = mapped_next(list, node);
+    return node;
+}
+
+FileNode* mapped_search(const MappedList* list, int key) {
+    for (FileNode* n = mapped_head(list); n != NULL; n = mapped_next(list, n)) {
+        if (n->data == key) return n;
+    }
+    return NULL;
+}
+
+// COW only; returns NULL when the spare slots are used up
+FileNode* mapped_create_node(MappedList* list, int data) {
+    assert(list->flags & LIST_MAP_COW);
+    uint64_t offset = list->free_head;
+    if (offset != 0) {
+        list->free_head = mapped_node(list, offset)->next;
+    } else {
+        if (list->spare_next + sizeof(FileNode) > list->spare_end) return NULL;
+        offset = list->spare_next;
+        list->spare_next += sizeof(FileNode);
+    }
+    FileNode* node = mapped_node(list, offset);
+    *node = (FileNode){data, 0, 0};
+    return node;
+}
+
+// COW only; node NULL inserts a new head
+void mapped_insert_after(MappedList* list, FileNode* node, FileNode* new_node) {
+    assert(list->flags & LIST_MAP_COW);
+    if (node == NULL) {
+        new_node->next = list->head;
+        list->head = mapped_offset(list, new_node);
+    } else {
+        new_node->next = node->next;
+        node->next = mapped_offset(list, new_node);
+    }
+    list->node_count++;
+}
+
+// COW only; node NULL deletes the head; returns -1 if there is nothing to delete
+int mapped_delete_after(MappedList* list, FileNode* node) {
+    assert(list->flags & LIST_MAP_COW);
+    uint64_t* link = node == NULL ? &list->head : &node->next;
+    if (*link == 0) return -1;
+
+    FileNode* node_to_del = mapped_node(list, *link);
+    *link = node_to_del->next;
+    node_to_del->next = list->free_head;
+    list->free_head = mapped_offset(list, node_to_del);
+    list->node_count--;
+    return 0;
+}
+
+typedef struct MappedIterator {
+    const MappedList* list;
+    const FileNode* node;
+} MappedIterator;
+
+static int next_mapped_data(void* iterator, int* data) {
+    MappedIterator* it = (MappedIterator*)iterator;
+    if (it->node == NULL) return 0;
+    *data = it->node->data;
+    it->node = mapped_next(it->list, it->node);
+    return 1;
+}
+
+// writes the mapped list (with its copy-on-write changes) as a new compact file; path must not be the mapped file
+int mapped_save(const MappedList* list, const char* path) {
+    MappedIterator iterator = {list, mapped_head(list)};
+    return write_list_file(path, next_mapped_data, &iterator, list->node_count);
+}
+
+/*
+###############################
+###          tests          ###
+###############################
+*/
+static void temp_path(char* path, size_t size, const char* name) {
+    snprintf(path, size, "/tmp/mapped_list_%d_%s.bin", (int)getpid(), name);
+}
+
+static void assert_mapped(const MappedList* list, const int* expected, int size) {
+    int i = 0;
+    for (FileNode* n = mapped_head(list); n != NULL; n = mapped_next(list, n)) {
+        assert(i < size && n->data == expected[i]);
+        i++;
+    }
+    assert(i == size && mapped_length(list) == (uint64_t)size);
+}
+
+void test_save_and_map() {
+    print_test_func_name();
+
+    char path[128];
+    temp_path(path, sizeof(path), "basic");
+    int arr[] = {4, 8, 15, 16, 23, 42};
+    Node* head = create_nodes_from_array(arr, 6);
+    assert(list_save(head, path) == 0);
+    free_all(head);
+
+    for (int flags = 0; flags <= LIST_MAP_VERIFY; flags++) {
+        MappedList* list = list_map(path, flags, 0);
+        assert(list != NULL);
+        assert_mapped(list, arr, 6);
+        assert(mapped_find_kth(list, 3)->data == 16 && mapped_find_kth(list, 6) == NULL);
+        assert(mapped_search(list, 23) == mapped_find_kth(list, 4) && mapped_search(list, 5) == NULL);
+        list_unmap(list);
+    }
+
+    assert(list_save(NULL, path) == 0);  // an empty list is a header only
+    MappedList* list = list_map(path, LIST_MAP_VERIFY, 0);
+    assert(list != NULL && mapped_head(list) == NULL && mapped_length(list) == 0);
+    list_unmap(list);
+
+    unlink(path);
+    passed();
+}
+
+// flips one byte of the file at offset
+static void corrupt(const char* path, long offset) {
+    FILE* f = fopen(path, "r+b");
+    fseek(f, offset, SEEK_SET);
+    int c = fgetc(f);
+    fseek(f, offset, SEEK_SET);
+    fputc(c ^ 0x40, f);
+    fclose(f);
+}
+
+void test_map_rejects_bad_files() {
+    print_test_func_name();
+
+    char path[128];
+    temp_path(path, sizeof(path), "bad");
+    int arr[] = {1, 2, 3};
+    Node* head = create_nodes_from_array(arr, 3);
+
+    assert(list_map("/nonexistent/list.bin", 0, 0) == NULL);
+
+    list_save(head, path);
+    corrupt(path, 0);  // magic
+    assert(list_map(path, 0, 0) == NULL);
+
+    list_save(head, path);
+    corrupt(path, offsetof(ListFileHeader, version));
+    assert(list_map(path, 0, 0) == NULL);
+
+    list_save(head, path);
+    corrupt(path, sizeof(ListFileHeader) + sizeof(FileNode) + offsetof(FileNode, data));  // a node's data
+    MappedList* list = list_map(path, 0, 0);  // only the header is checked
+    assert(list != NULL);
+    list_unmap(list);
+    assert(list_map(path, LIST_MAP_VERIFY, 0) == NULL);
+
+    list_save(head, path);
+    int truncated = truncate(path, sizeof(ListFileHeader) + sizeof(FileNode));
+    assert(truncated == 0);
+    assert(list_map(path, 0, 0) == NULL);
+
+    free_all(head);
+    unlink(path);
+    passed();
+}
+
+void test_copy_on_write() {
+    print_test_func_name();
+
+    char path[128], saved[128];
+    temp_path(path, sizeof(path), "cow");
+    temp_path(saved, sizeof(saved), "cow_saved");
+    int arr[] = {1, 2, 3};
+    Node* head = create_nodes_from_array(arr, 3);
+    list_save(head, path);
+    free_all(head);
+
+    MappedList* list = list_map(path, LIST_MAP_COW | LIST_MAP_VERIFY, 2);
+    assert(list != NULL);
+    mapped_insert_after(list, mapped_search(list, 2), mapped_create_node(list, 25));
+    mapped_insert_after(list, NULL, mapped_create_node(list, 0));
+    assert(mapped_create_node(list, 9) == NULL);  // both spare slots are used
+    assert_mapped(list, (int[]){0, 1, 2, 25, 3}, 5);
+
+    assert(mapped_delete_after(list, mapped_search(list, 1)) == 0);  // a node of the file
+    assert(mapped_delete_after(list, mapped_search(list, 3)) == -1);
+    mapped_insert_after(list, mapped_search(list, 3), mapped_create_node(list, 4));  // reuses the slot of 2
+    mapped_search(list, 1)->data = 10;
+    assert_mapped(list, (int[]){0, 10, 25, 3, 4}, 5);
+
+    assert(mapped_save(list, saved) == 0);
+    list_unmap(list);
+
+    MappedList* original = list_map(path, LIST_MAP_VERIFY, 0);  // the file did not change
+    assert_mapped(original, arr, 3);
+    list_unmap(original);
+    MappedList* copy = list_map(saved, LIST_MAP_VERIFY, 0);
+    assert_mapped(copy, (int[]){0, 10, 25, 3, 4}, 5);
+    list_unmap(copy);
+
+    unlink(path);
+    unlink(saved);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_LIST_SIZE 4000000
+
+// startup = everything until the list is usable plus one full traversal (which is when a mapping is paged in)
+// the rebuild path reads the flat int array and calls create_nodes_from_array
+// the page cache is warm for both: this compares the work after the bytes are in memory, not disk speed
+void bench_startup() {
+    print_test_func_name();
+
+    char array_path[128], list_path[128];
+    temp_path(array_path, sizeof(array_path), "bench_array");
+    temp_path(list_path, sizeof(list_path), "bench_list");
+    int* arr = (int*)malloc(sizeof(int) * BENCH_LIST_SIZE);
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) arr[i] = i;
+    FILE* f = fopen(array_path, "wb");
+    fwrite(arr, sizeof(int), BENCH_LIST_SIZE, f);
+    fclose(f);
+    Node* head = create_nodes_from_array(arr, BENCH_LIST_SIZE);
+    list_save(head, list_path);
+    free_all(head);
+    free(arr);
+
+    long long start = now_ns();
+    f = fopen(array_path, "rb");
+    arr = (int*)malloc(sizeof(int) * BENCH_LIST_SIZE);
+    size_t read = fread(arr, sizeof(int), BENCH_LIST_SIZE, f);
+    fclose(f);
+    head = create_nodes_from_array(arr, (int)read);
+    Node* found = search(head, -1);
+    print_bench_result("read array + rebuild + traverse", now_ns() - start, BENCH_LIST_SIZE);
+    bench_keep(found != NULL);
+    assert(found == NULL);
+    free_all(head);
+    free(arr);
+
+    const char* names[] = {"list_map + traverse", "list_map(VERIFY) + traverse", "list_map(COW) + traverse"};
+    int flags[] = {0, LIST_MAP_VERIFY, LIST_MAP_COW};
+    for (int i = 0; i < 3; i++) {
+        start = now_ns();
+        MappedList* list = list_map(list_path, flags[i], 0);
+        FileNode* mapped_found = mapped_search(list, -1);
+        print_bench_result(names[i], now_ns() - start, BENCH_LIST_SIZE);
+        bench_keep(mapped_found != NULL);
+        assert(mapped_found == NULL);
+        list_unmap(list);
+    }
+
+    unlink(array_path);
+    unlink(list_path);
+}
+
+// harness cases: a list of 0..size-1 is saved to a file once per size, the search cases map it once
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    char path[128];
+    Node* head;
+    MappedList* list;
+} BenchState;
+
+static void* bench_setup(int size) {
+    int* arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) arr[i] = i;
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    bench_common_init(&state->common);
+    temp_path(state->path, sizeof(state->path), "bench_case");
+    state->head = create_nodes_from_array(arr, size);
+    list_save(state->head, state->path);
+    state->list = list_map(state->path, 0, 0);
+    free(arr);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    list_unmap(b->list);
+    unlink(b->path);
+    free_all(b->head);
+    free(b);
+}
+
+// one op per node; the page cache is warm, so this is the work after the bytes are in memory
+static long long bench_list_save(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    list_save(b->head, b->path);
+    return size;
+}
+
+// one op per node: the traversal is when the mapping is paged in
+static long long bench_map_and_traverse(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    MappedList* list = list_map(b->path, 0, 0);
+    b->common.sink += mapped_search(list, -1) == NULL;
+    list_unmap(list);
+    return size;
+}
+
+static long long bench_mapped_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += mapped_search(b->list, key)->data;
+    return 1;
+}
+
+static long long bench_mapped_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    uint64_t k = bench_random(&b->common.seed) % (uint32_t)size;
+    b->common.sink += mapped_find_kth(b->list, k)->data;
+    return 1;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"list_save (per node)", bench_setup, NULL, bench_list_save, bench_teardown},
+    {"list_map+traverse (per node)", bench_setup, NULL, bench_map_and_traverse, bench_teardown},
+    {"mapped_search", bench_setup, NULL, bench_mapped_search, bench_teardown},
+    {"mapped_find_kth", bench_setup, NULL, bench_mapped_find_kth, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_save_and_map();
+        test_map_rejects_bad_files();
+        test_copy_on_write();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_startup();
+    }
+
+    return 0;
+}
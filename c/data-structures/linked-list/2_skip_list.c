@@ -0,0 +1,570 @@
+/*
+- an indexable skip list: the bottom level is a plain singly linked list of int data nodes
+- every node also gets a random number of express links, each link stores its span: how many bottom level
+  nodes it skips over
+- summing spans while descending gives the position of a node, so find_kth, insert_at, delete_kth and
+  delete_kth_from_end are expected O(log n)
+- the list is positional like 1_singly_linked_list.c: insert_at places the data at an index, the order of the
+  values is up to the caller
+- search is a bottom level walk: O(n); when the values are kept in ascending order (insert_sorted),
+  search_sorted descends the express links instead: expected O(log n)
+- levels are drawn from a private xorshift generator; skiplist_create_seeded makes runs reproducible
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_helper.h"
+
+#define SKIPLIST_MAX_LEVEL 32
+
+typedef struct SkipLink {
+    struct SkipNode* next;
+    int span;  // bottom level steps from this node to next
+} SkipLink;
+
+typedef struct SkipNode {
+    int data;
+    int level;
+    SkipLink links[];  // links[0] is the bottom level
+} SkipNode;
+
+typedef struct SkipList {
+    SkipNode* head;  // sentinel with SKIPLIST_MAX_LEVEL links, position -1
+    int level;
+    int size;
+    uint64_t rng_state;
+} SkipList;
+
+SkipNode* skiplist_create_node(int data, int level) {
+    SkipNode* node = (SkipNode*)malloc(sizeof(*node) + sizeof(SkipLink) * level);
+    node->data = data;
+    node->level = level;
+    for (int i = 0; i < level; i++) {
+        node->links[i].next = NULL;
+        node->links[i].span = 0;
+    }
+    return node;
+}
+
+// the same seed always yields the same levels, hence the same shape and timings
+SkipList* skiplist_create_seeded(uint64_t seed) {
+    SkipList* list = (SkipList*)malloc(sizeof(*list));
+    list->head = skiplist_create_node(0, SKIPLIST_MAX_LEVEL);
+    list->level = 1;
+    list->size = 0;
+    list->rng_state = seed != 0 ? seed : 0x9E3779B97F4A7C15ULL;  // xorshift must not start at 0
+    return list;
+}
+
+SkipList* skiplist_create() {
+    return skiplist_create_seeded((uint64_t)now_ns() ^ (uint64_t)(uintptr_t)&skiplist_create);
+}
+
+void skiplist_free_all(SkipList* list) {
+    SkipNode* node = list->head;
+    while (node != NULL) {
+        SkipNode* prev_node = node;
+        node = node->links[0].next;
+        free(prev_node);
+    }
+    free(list);
+}
+
+static uint64_t next_random(SkipList* list) {
+    uint64_t x = list->rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    list->rng_state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// each extra level with probability 1/2
+static int random_level(SkipList* list) {
+    uint64_t bits = next_random(list);
+    int level = 1;
+    while ((bits & 1) && level < SKIPLIST_MAX_LEVEL) {
+        level++;
+        bits >>= 1;
+    }
+    return level;
+}
+
+// linear: remembers the last node of every level instead of descending for each insert
+SkipList* skiplist_create_from_array_seeded(int a[], int size, uint64_t seed) {
+    SkipList* list = skiplist_create_seeded(seed);
+    SkipNode* last[SKIPLIST_MAX_LEVEL];
+    int last_pos[SKIPLIST_MAX_LEVEL];
+    for (int i = 0; i < SKIPLIST_MAX_LEVEL; i++) {
+        last[i] = list->head;
+        last_pos[i] = -1;
+    }
+
+    for (int pos = 0; pos < size; pos++) {
+        int level = random_level(list);
+        SkipNode* node = skiplist_create_node(a[pos], level);
+        for (int i = 0; i < level; i++) {
+            last[i]->links[i].next = node;
+            last[i]->links[i].span = pos - last_pos[i];
+            last[i] = node;
+            last_pos[i] = pos;
+        }
+        if (level > list->level) list->level = level;
+    }
+    list->size = size;
+    return list;
+}
+
+SkipList* skiplist_create_from_array(int a[], int size) {
+    return skiplist_create_from_array_seeded(a, size, (uint64_t)now_ns());
+}
+
+SkipNode* skiplist_find_kth(const SkipList* list, int k) {
+    if (k < 0 || k >= list->size) return NULL;
+
+    SkipNode* node = list->head;
+    int pos = -1;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (node->links[i].next != NULL && pos + node->links[i].span <= k) {
+            pos += node->links[i].span;
+            node = node->links[i].next;
+        }
+        if (pos == k) return node;
+    }
+    return node;
+}
+
+// fills update[i] with the last node at level i before position index, and pos[i] with its position
+static void find_predecessors(const SkipList* list, int index, SkipNode* update[], int pos[]) {
+    SkipNode* node = list->head;
+    int p = -1;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (node->links[i].next != NULL && p + node->links[i].span < index) {
+            p += node->links[i].span;
+            node = node->links[i].next;
+        }
+        update[i] = node;
+        pos[i] = p;
+    }
+}
+
+// index is in [0, size], inserting at size is an append
+int skiplist_insert_at(SkipList* list, int index, int data) {
+    if (index < 0 || index > list->size) return -1;
+
+    SkipNode* update[SKIPLIST_MAX_LEVEL];
+    int pos[SKIPLIST_MAX_LEVEL];
+    find_predecessors(list, index, update, pos);
+
+    int level = random_level(list);
+    for (int i = list->level; i < level; i++) {  // new levels start at the head and reach the end
+        update[i] = list->head;
+        pos[i] = -1;
+        list->head->links[i].span = list->size + 1;
+    }
+    if (level > list->level) list->level = level;
+
+    SkipNode* node = skiplist_create_node(data, level);
+    for (int i = 0; i < level; i++) {
+        SkipLink* link = &update[i]->links[i];
+        int before = index - pos[i];  // span from update[i] to the new node
+        node->links[i].next = link->next;
+        node->links[i].span = link->span - before + 1;
+        link->next = node;
+        link->span = before;
+    }
+    for (int i = level; i < list->level; i++) {  // higher links now jump over one more node
+        update[i]->links[i].span++;
+    }
+
+    list->size++;
+    return 0;
+}
+
+int skiplist_delete_kth(SkipList* list, int k) {
+    if (k < 0 || k >= list->size) return -1;
+
+    SkipNode* update[SKIPLIST_MAX_LEVEL];
+    int pos[SKIPLIST_MAX_LEVEL];
+    find_predecessors(list, k, update, pos);
+
+    SkipNode* node_to_del = update[0]->links[0].next;
+    for (int i = 0; i < list->level; i++) {
+        SkipLink* link = &update[i]->links[i];
+        if (link->next == node_to_del) {
+            link->span += node_to_del->links[i].span - 1;
+            link->next = node_to_del->links[i].next;
+        } else {
+            link->span--;
+        }
+    }
+    while (list->level > 1 && list->head->links[list->level - 1].next == NULL) {
+        list->level--;
+    }
+
+    free(node_to_del);
+    list->size--;
+    return 0;
+}
+
+// kth is 1-indexed like in tricks/singly_delete_kth_from_end.c, the size makes it a plain delete_kth
+int skiplist_delete_kth_from_end(SkipList* list, int kth) {
+    return skiplist_delete_kth(list, list->size - kth);
+}
+
+int skiplist_append(SkipList* list, int data) {
+    return skiplist_insert_at(list, list->size, data);
+}
+
+SkipNode* skiplist_search(const SkipList* list, int key) {
+    SkipNode* n = list->head->links[0].next;
+    while (n != NULL) {
+        if (n->data == key)
+            return n;
+        else
+            n = n->links[0].next;
+    }
+
+    return NULL;
+}
+
+// assumes the values are in ascending order, returns the first node holding key
+SkipNode* skiplist_search_sorted(const SkipList* list, int key) {
+    SkipNode* node = list->head;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (node->links[i].next != NULL && node->links[i].next->data < key) {
+            node = node->links[i].next;
+        }
+    }
+
+    SkipNode* candidate = node->links[0].next;
+    return candidate != NULL && candidate->data == key ? candidate : NULL;
+}
+
+// assumes the values are in ascending order, equal values keep their insertion order
+// returns the index the data was inserted at
+int skiplist_insert_sorted(SkipList* list, int data) {
+    SkipNode* node = list->head;
+    int pos = -1;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (node->links[i].next != NULL && node->links[i].next->data <= data) {
+            pos += node->links[i].span;
+            node = node->links[i].next;
+        }
+    }
+
+    skiplist_insert_at(list, pos + 1, data);
+    return pos + 1;
+}
+
+/*
+###############################
+###          tests          ###
+###############################
+*/
+// every link's span must equal the distance between the positions of its two ends
+static void check_spans(const SkipList* list) {
+    SkipNode* nodes[4096];
+    assert(list->size < 4096);
+    int n = 0;
+    for (SkipNode* node = list->head->links[0].next; node != NULL; node = node->links[0].next) nodes[n++] = node;
+    assert(n == list->size);
+
+    for (int i = 0; i < list->level; i++) {
+        SkipNode* node = list->head;
+        int pos = -1;
+        while (node->links[i].next != NULL) {
+            SkipNode* next = node->links[i].next;
+            int next_pos = pos + node->links[i].span;
+            assert(next_pos < n && nodes[next_pos] == next);
+            node = next;
+            pos = next_pos;
+        }
+    }
+    for (int i = list->level; i < SKIPLIST_MAX_LEVEL; i++) assert(list->head->links[i].next == NULL);
+}
+
+void test_create_from_array() {
+    print_test_func_name();
+
+    int arr[100];
+    for (int i = 0; i < 100; i++) arr[i] = i * 10;
+    SkipList* list = skiplist_create_from_array_seeded(arr, 100, 1);
+
+    check_spans(list);
+    for (int i = 0; i < 100; i++) assert(skiplist_find_kth(list, i)->data == i * 10);
+    assert(skiplist_find_kth(list, 100) == NULL && skiplist_find_kth(list, -1) == NULL);
+    assert(list->level > 1);
+
+    skiplist_free_all(list);
+    passed();
+}
+
+void test_insert_at_and_delete_kth() {
+    print_test_func_name();
+
+    SkipList* list = skiplist_create_seeded(2);
+    assert(skiplist_insert_at(list, 0, 2) == 0);
+    assert(skiplist_insert_at(list, 0, 1) == 0);
+    assert(skiplist_append(list, 4) == 0);
+    assert(skiplist_insert_at(list, 2, 3) == 0);
+    assert(skiplist_insert_at(list, 5, 0) == -1);
+    check_spans(list);
+    for (int i = 0; i < 4; i++) assert(skiplist_find_kth(list, i)->data == i + 1);
+
+    assert(skiplist_delete_kth(list, 1) == 0);
+    assert(skiplist_delete_kth(list, 3) == -1);
+    check_spans(list);
+    assert(skiplist_find_kth(list, 1)->data == 3 && list->size == 3);
+
+    assert(skiplist_delete_kth_from_end(list, 1) == 0);  // 4
+    assert(skiplist_delete_kth_from_end(list, 2) == 0);  // 1
+    assert(skiplist_find_kth(list, 0)->data == 3 && list->size == 1);
+    assert(skiplist_delete_kth_from_end(list, 2) == -1);
+    assert(skiplist_delete_kth(list, 0) == 0);
+    assert(list->size == 0 && list->level == 1 && list->head->links[0].next == NULL);
+
+    skiplist_free_all(list);
+    passed();
+}
+
+void test_search() {
+    print_test_func_name();
+
+    int arr[] = {5, 3, 9, 3, 1};
+    SkipList* list = skiplist_create_from_array_seeded(arr, sizeof(arr) / sizeof(*arr), 3);
+
+    assert(skiplist_search(list, 10) == NULL);
+    assert(skiplist_search(list, 3) == skiplist_find_kth(list, 1));  // the first of two
+
+    skiplist_free_all(list);
+    passed();
+}
+
+void test_sorted_insert_and_search() {
+    print_test_func_name();
+
+    SkipList* list = skiplist_create_seeded(4);
+    int values[] = {50, 10, 40, 10, 30, 20, 60};
+    for (int i = 0; i < 7; i++) skiplist_insert_sorted(list, values[i]);
+    check_spans(list);
+
+    int expected[] = {10, 10, 20, 30, 40, 50, 60};
+    for (int i = 0; i < 7; i++) assert(skiplist_find_kth(list, i)->data == expected[i]);
+
+    assert(skiplist_search_sorted(list, 10) == skiplist_find_kth(list, 0));
+    assert(skiplist_search_sorted(list, 60) == skiplist_find_kth(list, 6));
+    assert(skiplist_search_sorted(list, 35) == NULL);
+    assert(skiplist_search_sorted(list, 70) == NULL);
+    assert(skiplist_insert_sorted(list, 10) == 2);  // after the equal values
+
+    skiplist_free_all(list);
+    passed();
+}
+
+void test_same_seed_same_shape() {
+    print_test_func_name();
+
+    int arr[200];
+    for (int i = 0; i < 200; i++) arr[i] = i;
+    SkipList* a = skiplist_create_from_array_seeded(arr, 200, 99);
+    SkipList* b = skiplist_create_from_array_seeded(arr, 200, 99);
+
+    SkipNode* x = a->head->links[0].next;
+    SkipNode* y = b->head->links[0].next;
+    while (x != NULL) {
+        assert(x->level == y->level);
+        x = x->links[0].next;
+        y = y->links[0].next;
+    }
+    assert(a->level == b->level);
+
+    skiplist_free_all(a);
+    skiplist_free_all(b);
+    passed();
+}
+
+// random inserts and deletes against a plain array
+void test_random_operations_match_array() {
+    print_test_func_name();
+
+    enum { MAX = 3000 };
+    int model[MAX];
+    int size = 0;
+    SkipList* list = skiplist_create_seeded(5);
+    srand(5);
+
+    for (int op = 0; op < 20000; op++) {
+        if (size < MAX && (size == 0 || rand() % 3 != 0)) {
+            int index = rand() % (size + 1);
+            int value = rand();
+            assert(skiplist_insert_at(list, index, value) == 0);
+            memmove(model + index + 1, model + index, sizeof(int) * (size - index));
+            model[index] = value;
+            size++;
+        } else {
+            int index = rand() % size;
+            assert(skiplist_delete_kth(list, index) == 0);
+            memmove(model + index, model + index + 1, sizeof(int) * (size - index - 1));
+            size--;
+        }
+        if (op % 1000 == 0) check_spans(list);
+    }
+
+    check_spans(list);
+    assert(list->size == size);
+    for (int i = 0; i < size; i++) assert(skiplist_find_kth(list, i)->data == model[i]);
+
+    skiplist_free_all(list);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_SEED 12345
+
+// find_kth on a one-int-per-node list, the walk the skip list replaces
+static SkipNode* bottom_level_find_kth(const SkipList* list, int k) {
+    SkipNode* node = list->head->links[0].next;
+    for (int i = 0; i < k; i++) node = node->links[0].next;
+    return node;
+}
+
+void bench_skiplist() {
+    print_test_func_name();
+    printf("seed: %d\n", BENCH_SEED);
+
+    srand(BENCH_SEED);
+    for (int size = 1000; size <= 1000000; size *= 10) {
+        int* arr = (int*)malloc(sizeof(int) * size);
+        for (int i = 0; i < size; i++) arr[i] = i;
+        SkipList* list = skiplist_create_from_array_seeded(arr, size, BENCH_SEED);
+        int ops = 100000;
+        int linear_ops = 100000000 / size;  // keeps the linear walk at ~10^8 hops
+        char label[64];
+
+        int found = 0;
+        long long start = now_ns();
+        for (int i = 0; i < linear_ops; i++) found += bottom_level_find_kth(list, rand() % size) != NULL;
+        long long end = now_ns();
+        snprintf(label, sizeof(label), "n=%d linear find_kth", size);
+        print_bench_result(label, end - start, linear_ops);
+        bench_keep(found);
+        assert(found == linear_ops);
+
+        found = 0;
+        start = now_ns();
+        for (int i = 0; i < ops; i++) found += skiplist_find_kth(list, rand() % size) != NULL;
+        end = now_ns();
+        snprintf(label, sizeof(label), "n=%d skiplist find_kth", size);
+        print_bench_result(label, end - start, ops);
+        bench_keep(found);
+        assert(found == ops);
+
+        found = 0;
+        start = now_ns();
+        for (int i = 0; i < ops; i++) found += skiplist_search_sorted(list, rand() % size) != NULL;
+        end = now_ns();
+        snprintf(label, sizeof(label), "n=%d skiplist search_sorted", size);
+        print_bench_result(label, end - start, ops);
+        bench_keep(found);
+        assert(found == ops);
+
+        start = now_ns();
+        for (int i = 0; i < ops; i++) {
+            skiplist_insert_at(list, rand() % (list->size + 1), i);
+            skiplist_delete_kth(list, rand() % list->size);
+        }
+        end = now_ns();
+        snprintf(label, sizeof(label), "n=%d skiplist insert_at+delete_kth", size);
+        print_bench_result(label, end - start, ops);
+
+        skiplist_free_all(list);
+        free(arr);
+    }
+}
+
+// harness cases: a skip list of 0..size-1 (ascending, so search_sorted applies) is built once per size
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    SkipList* list;
+} BenchState;
+
+static void* bench_setup(int size) {
+    int* arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) arr[i] = i;
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    bench_common_init(&state->common);
+    state->list = skiplist_create_from_array_seeded(arr, size, BENCH_SEED);
+    free(arr);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    skiplist_free_all(((BenchState*)state)->list);
+    free(state);
+}
+
+static long long bench_linear_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->common.sink += bottom_level_find_kth(b->list, (int)(bench_random(&b->common.seed) % (uint32_t)size))->data;
+    return 1;
+}
+
+static long long bench_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->common.sink += skiplist_find_kth(b->list, (int)(bench_random(&b->common.seed) % (uint32_t)size))->data;
+    return 1;
+}
+
+static long long bench_search_sorted(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->common.sink += skiplist_search_sorted(b->list, (int)(bench_random(&b->common.seed) % (uint32_t)size))->data;
+    return 1;
+}
+
+// the length stays the same
+static long long bench_insert_at_and_delete_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    skiplist_insert_at(b->list, (int)(bench_random(&b->common.seed) % (uint32_t)(size + 1)), size);
+    skiplist_delete_kth(b->list, (int)(bench_random(&b->common.seed) % (uint32_t)(size + 1)));
+    return 1;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"linear find_kth (bottom level)", bench_setup, NULL, bench_linear_find_kth, bench_teardown},
+    {"skiplist_find_kth", bench_setup, NULL, bench_find_kth, bench_teardown},
+    {"skiplist_search_sorted", bench_setup, NULL, bench_search_sorted, bench_teardown},
+    {"skiplist_insert_at+delete_kth", bench_setup, NULL, bench_insert_at_and_delete_kth, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+    if (should_run_tests) {
+        test_create_from_array();
+        test_insert_at_and_delete_kth();
+        test_search();
+        test_sorted_insert_and_search();
+        test_same_seed_same_shape();
+        test_random_operations_match_array();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_skiplist();
+    }
+
+    return 0;
+}
@@ -0,0 +1,721 @@
+/*
+- an unrolled linked list: every node stores a block of ints and a count instead of a single int
+- a node is exactly one cache line: the next pointer, the count and UNROLLED_CAPACITY ints (13 on 64-bit)
+- search reads UNROLLED_CAPACITY ints per pointer hop instead of one, so it pays ~1 cache miss per block
+- find_kth skips whole nodes using their count: O(n / UNROLLED_CAPACITY) hops
+- positions are 0-indexed element indices, there are no per-element node pointers
+- inserting into a full node splits it: the old node keeps split_fill ints, the rest moves to a new node
+- when a delete leaves a node with less than merge_threshold ints, it merges with its successor if both fit
+  in one node, otherwise it borrows ints from the successor
+- the *_simd functions scan each block with SSE2/AVX2 (see simd_search.h), picked at runtime from CPUID
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simd_search.h"
+#include "test_helper.h"
+
+#define CACHE_LINE_SIZE 64
+
+// can be overridden with -DUNROLLED_CAPACITY=n, nodes then span several cache lines
+#ifndef UNROLLED_CAPACITY
+#define UNROLLED_CAPACITY ((int)((CACHE_LINE_SIZE - sizeof(void*) - sizeof(int)) / sizeof(int)))
+#define UNROLLED_NODE_IS_ONE_LINE
+#endif
+
+typedef struct UNode {
+    struct UNode* next;
+    int count;
+    int data[UNROLLED_CAPACITY];
+} UNode;
+
+typedef struct UnrolledList {
+    UNode* head;
+    UNode* tail;
+    int size;
+    int split_fill;
+    int merge_threshold;
+} UnrolledList;
+
+UNode* unrolled_create_node() {
+    // aligned_alloc needs a size that is a multiple of the alignment
+    size_t size = (sizeof(UNode) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    UNode* node = (UNode*)aligned_alloc(CACHE_LINE_SIZE, size);
+    node->next = NULL;
+    node->count = 0;
+    return node;
+}
+
+// out of range values are clamped, split_fill must leave room in both halves
+void unrolled_set_thresholds(UnrolledList* list, int split_fill, int merge_threshold) {
+    if (split_fill < 1) split_fill = 1;
+    if (split_fill > UNROLLED_CAPACITY - 1) split_fill = UNROLLED_CAPACITY - 1;
+    if (merge_threshold < 0) merge_threshold = 0;
+    if (merge_threshold > UNROLLED_CAPACITY) merge_threshold = UNROLLED_CAPACITY;
+    list->split_fill = split_fill;
+    list->merge_threshold = merge_threshold;
+}
+
+UnrolledList* unrolled_create() {
+    UnrolledList* list = (UnrolledList*)malloc(sizeof(*list));
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+    unrolled_set_thresholds(list, UNROLLED_CAPACITY / 2, UNROLLED_CAPACITY / 4);
+    return list;
+}
+
+void unrolled_free_all(UnrolledList* list) {
+    UNode* node = list->head;
+    while (node != NULL) {
+        UNode* prev_node = node;
+        node = node->next;
+        free(prev_node);
+    }
+    free(list);
+}
+
+// appends never split: a full tail gets a fresh successor, so appended runs stay densely packed
+void unrolled_append(UnrolledList* list, int data) {
+    if (list->tail == NULL || list->tail->count == UNROLLED_CAPACITY) {
+        UNode* node = unrolled_create_node();
+        if (list->tail == NULL)
+            list->head = node;
+        else
+            list->tail->next = node;
+        list->tail = node;
+    }
+
+    list->tail->data[list->tail->count++] = data;
+    list->size++;
+}
+
+// every node but the last one is filled to capacity
+UnrolledList* unrolled_create_from_array(int a[], int size) {
+    UnrolledList* list = unrolled_create();
+    for (int i = 0; i < size; i++) {
+        unrolled_append(list, a[i]);
+    }
+    return list;
+}
+
+// returns the node holding element k and turns k into the offset inside that node
+static UNode* locate(const UnrolledList* list, int* k, UNode** prev) {
+    UNode* p = NULL;
+    UNode* node = list->head;
+    while (node != NULL && *k >= node->count) {
+        *k -= node->count;
+        p = node;
+        node = node->next;
+    }
+    if (prev != NULL) *prev = p;
+    return node;
+}
+
+int* unrolled_find_kth(const UnrolledList* list, int k) {
+    if (k < 0 || k >= list->size) return NULL;
+
+    UNode* node = locate(list, &k, NULL);
+    return &node->data[k];
+}
+
+int* unrolled_search(const UnrolledList* list, int key) {
+    for (UNode* node = list->head; node != NULL; node = node->next) {
+        for (int i = 0; i < node->count; i++) {
+            if (node->data[i] == key) return &node->data[i];
+        }
+    }
+    return NULL;
+}
+
+// same result as unrolled_search, level only picks the kernel used for each block
+int* unrolled_search_simd_level(const UnrolledList* list, int key, SimdLevel level) {
+    SimdFindFn find = simd_find_fn(level);
+    for (UNode* node = list->head; node != NULL; node = node->next) {
+        int i = find(node->data, node->count, key);
+        if (i >= 0) return &node->data[i];
+    }
+    return NULL;
+}
+
+int* unrolled_search_simd(const UnrolledList* list, int key) {
+    return unrolled_search_simd_level(list, key, simd_detect_level());
+}
+
+int unrolled_count_matches(const UnrolledList* list, int key) {
+    SimdCountFn count = simd_count_fn(simd_detect_level());
+    int matches = 0;
+    for (UNode* node = list->head; node != NULL; node = node->next) {
+        matches += count(node->data, node->count, key);
+    }
+    return matches;
+}
+
+// stores up to max_out matches in list order, returns the total number of matches
+int unrolled_search_all(const UnrolledList* list, int key, int** out, int max_out) {
+    SimdFindFn find = simd_find_fn(simd_detect_level());
+    int matches = 0;
+    for (UNode* node = list->head; node != NULL; node = node->next) {
+        int from = 0;
+        int i;
+        while ((i = find(node->data + from, node->count - from, key)) >= 0) {
+            if (matches < max_out) out[matches] = &node->data[from + i];
+            matches++;
+            from += i + 1;
+        }
+    }
+    return matches;
+}
+
+// the new node takes everything after split_fill, returns the node that now holds offset *i
+static UNode* split(UnrolledList* list, UNode* node, int* i) {
+    UNode* new_node = unrolled_create_node();
+    int keep = list->split_fill;
+    new_node->count = node->count - keep;
+    memcpy(new_node->data, node->data + keep, sizeof(int) * new_node->count);
+    node->count = keep;
+
+    new_node->next = node->next;
+    node->next = new_node;
+    if (list->tail == node) list->tail = new_node;
+
+    if (*i <= keep) return node;
+    *i -= keep;
+    return new_node;
+}
+
+// index is in [0, size], inserting at size is an append
+int unrolled_insert_at(UnrolledList* list, int index, int data) {
+    if (index < 0 || index > list->size) return -1;
+    if (index == list->size) {
+        unrolled_append(list, data);
+        return 0;
+    }
+
+    int i = index;
+    UNode* node = locate(list, &i, NULL);
+    if (node->count == UNROLLED_CAPACITY) node = split(list, node, &i);
+
+    memmove(node->data + i + 1, node->data + i, sizeof(int) * (node->count - i));
+    node->data[i] = data;
+    node->count++;
+    list->size++;
+    return 0;
+}
+
+int unrolled_insert_after(UnrolledList* list, int index, int data) {
+    if (index < 0 || index >= list->size) return -1;
+    return unrolled_insert_at(list, index + 1, data);
+}
+
+// keeps nodes from degenerating into one int per node after many deletes
+static void rebalance(UnrolledList* list, UNode* node) {
+    UNode* next = node->next;
+    if (node->count >= list->merge_threshold || next == NULL) return;
+
+    if (node->count + next->count <= UNROLLED_CAPACITY) {  // merge
+        memcpy(node->data + node->count, next->data, sizeof(int) * next->count);
+        node->count += next->count;
+        node->next = next->next;
+        if (list->tail == next) list->tail = node;
+        free(next);
+    } else if (next->count > node->count + 1) {  // borrow until both hold about the same number of ints
+        int moved = (next->count - node->count) / 2;
+        memcpy(node->data + node->count, next->data, sizeof(int) * moved);
+        memmove(next->data, next->data + moved, sizeof(int) * (next->count - moved));
+        node->count += moved;
+        next->count -= moved;
+    }
+}
+
+int unrolled_delete_at(UnrolledList* list, int index) {
+    if (index < 0 || index >= list->size) return -1;
+
+    int i = index;
+    UNode* prev;
+    UNode* node = locate(list, &i, &prev);
+
+    memmove(node->data + i, node->data + i + 1, sizeof(int) * (node->count - i - 1));
+    node->count--;
+    list->size--;
+
+    if (node->count == 0) {  // an empty node is unlinked instead of rebalanced
+        if (prev == NULL)
+            list->head = node->next;
+        else
+            prev->next = node->next;
+        if (list->tail == node) list->tail = prev;
+        free(node);
+        return 0;
+    }
+
+    rebalance(list, node);
+    return 0;
+}
+
+/*
+###############################
+###          tests          ###
+###############################
+*/
+// size and tail are consistent, no node is empty
+static void check_invariants(const UnrolledList* list) {
+    int size = 0;
+    UNode* last = NULL;
+    for (UNode* node = list->head; node != NULL; node = node->next) {
+        assert(node->count > 0 && node->count <= UNROLLED_CAPACITY);
+        size += node->count;
+        last = node;
+    }
+    assert(size == list->size);
+    assert(last == list->tail);
+}
+
+static void check_contents(const UnrolledList* list, const int a[], int size) {
+    check_invariants(list);
+    assert(list->size == size);
+    for (int i = 0; i < size; i++) {
+        assert(*unrolled_find_kth(list, i) == a[i]);
+    }
+}
+
+void test_node_is_one_cache_line() {
+    print_test_func_name();
+
+#ifdef UNROLLED_NODE_IS_ONE_LINE
+    assert(sizeof(UNode) == CACHE_LINE_SIZE);
+#endif
+    UNode* node = unrolled_create_node();
+    assert((size_t)node % CACHE_LINE_SIZE == 0);
+    free(node);
+
+    passed();
+}
+
+void test_create_from_array() {
+    print_test_func_name();
+
+    int arr[40];
+    for (int i = 0; i < 40; i++) arr[i] = i * 10;
+    UnrolledList* list = unrolled_create_from_array(arr, 40);
+
+    check_contents(list, arr, 40);
+    assert(list->head->count == UNROLLED_CAPACITY);  // densely packed
+    assert(unrolled_find_kth(list, 40) == NULL && unrolled_find_kth(list, -1) == NULL);
+
+    unrolled_free_all(list);
+    passed();
+}
+
+void test_search() {
+    print_test_func_name();
+
+    int arr[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
+    UnrolledList* list = unrolled_create_from_array(arr, sizeof(arr) / sizeof(*arr));
+
+    assert(unrolled_search(list, 100) == NULL);
+    int* found = unrolled_search(list, 17);  // lives in the second node
+    assert(found != NULL && *found == 17);
+    assert(found == unrolled_find_kth(list, 16));
+
+    unrolled_free_all(list);
+    passed();
+}
+
+void test_insert_splits_full_node() {
+    print_test_func_name();
+
+    int arr[UNROLLED_CAPACITY];
+    for (int i = 0; i < UNROLLED_CAPACITY; i++) arr[i] = i;
+    UnrolledList* list = unrolled_create_from_array(arr, UNROLLED_CAPACITY);
+    assert(list->head == list->tail);
+
+    assert(unrolled_insert_at(list, 1, 100) == 0);  // the only node is full: split
+    assert(list->head != list->tail);
+    assert(list->head->count == list->split_fill + 1);
+
+    int expected[UNROLLED_CAPACITY + 1];
+    expected[0] = 0;
+    expected[1] = 100;
+    for (int i = 1; i < UNROLLED_CAPACITY; i++) expected[i + 1] = i;
+    check_contents(list, expected, UNROLLED_CAPACITY + 1);
+
+    assert(unrolled_insert_after(list, UNROLLED_CAPACITY, 200) == 0);  // after the last element
+    assert(*unrolled_find_kth(list, UNROLLED_CAPACITY + 1) == 200);
+    assert(unrolled_insert_at(list, list->size + 1, 0) == -1);
+    assert(unrolled_insert_after(list, list->size, 0) == -1);
+
+    unrolled_free_all(list);
+    passed();
+}
+
+void test_delete_borrows_from_full_successor() {
+    print_test_func_name();
+
+    int arr[2 * UNROLLED_CAPACITY];
+    for (int i = 0; i < 2 * UNROLLED_CAPACITY; i++) arr[i] = i;
+    UnrolledList* list = unrolled_create_from_array(arr, 2 * UNROLLED_CAPACITY);
+    int threshold = list->merge_threshold;
+
+    // the first node drops below the threshold while its successor is full
+    int deletes = UNROLLED_CAPACITY - threshold + 1;
+    for (int i = 0; i < deletes; i++) unrolled_delete_at(list, 0);
+
+    int moved = (UNROLLED_CAPACITY - (threshold - 1)) / 2;
+    check_invariants(list);
+    assert(list->head->count == threshold - 1 + moved);
+    assert(list->head->next->count == UNROLLED_CAPACITY - moved);
+    for (int i = 0; i < list->size; i++) assert(*unrolled_find_kth(list, i) == deletes + i);
+
+    unrolled_free_all(list);
+    passed();
+}
+
+void test_delete_merges_with_successor() {
+    print_test_func_name();
+
+    int arr[2 * UNROLLED_CAPACITY];
+    for (int i = 0; i < 2 * UNROLLED_CAPACITY; i++) arr[i] = i;
+    UnrolledList* list = unrolled_create_from_array(arr, 2 * UNROLLED_CAPACITY);
+    int threshold = list->merge_threshold;
+
+    // shrink the tail to 2 ints (the tail has no successor, so it never rebalances)
+    while (list->tail->count > 2) unrolled_delete_at(list, list->size - 1);
+    // then shrink the first node below the threshold: both fit in one node
+    for (int i = 0; i < UNROLLED_CAPACITY - threshold + 1; i++) unrolled_delete_at(list, 0);
+
+    check_invariants(list);
+    assert(list->head == list->tail);
+    assert(list->head->count == threshold - 1 + 2);
+    assert(*unrolled_find_kth(list, list->size - 1) == UNROLLED_CAPACITY + 1);
+
+    assert(unrolled_delete_at(list, list->size) == -1);
+
+    unrolled_free_all(list);
+    passed();
+}
+
+void test_delete_everything() {
+    print_test_func_name();
+
+    int arr[30];
+    for (int i = 0; i < 30; i++) arr[i] = i;
+    UnrolledList* list = unrolled_create_from_array(arr, 30);
+
+    while (list->size > 0) {
+        assert(unrolled_delete_at(list, list->size - 1) == 0);
+        check_invariants(list);
+    }
+    assert(list->head == NULL && list->tail == NULL);
+
+    unrolled_append(list, 5);  // still usable once emptied
+    check_contents(list, (int[]){5}, 1);
+
+    unrolled_free_all(list);
+    passed();
+}
+
+// random inserts and deletes against a plain array with several threshold settings
+void test_random_operations_match_array() {
+    print_test_func_name();
+
+    enum { MAX = 2000 };
+    int thresholds[][2] = {{1, 0}, {UNROLLED_CAPACITY / 2, UNROLLED_CAPACITY / 4}, {UNROLLED_CAPACITY - 1, UNROLLED_CAPACITY}};
+    srand(42);
+    for (int t = 0; t < 3; t++) {
+        int model[MAX];
+        int size = 0;
+        UnrolledList* list = unrolled_create();
+        unrolled_set_thresholds(list, thresholds[t][0], thresholds[t][1]);
+
+        for (int op = 0; op < 20000; op++) {
+            if (size < MAX && (size == 0 || rand() % 3 != 0)) {
+                int index = rand() % (size + 1);
+                int value = rand();
+                assert(unrolled_insert_at(list, index, value) == 0);
+                memmove(model + index + 1, model + index, sizeof(int) * (size - index));
+                model[index] = value;
+                size++;
+            } else {
+                int index = rand() % size;
+                assert(unrolled_delete_at(list, index) == 0);
+                memmove(model + index, model + index + 1, sizeof(int) * (size - index - 1));
+                size--;
+            }
+        }
+        check_contents(list, model, size);
+        unrolled_free_all(list);
+    }
+
+    passed();
+}
+
+// every kernel must return the very same element as the scalar search, including duplicates
+void test_search_simd_matches_scalar() {
+    print_test_func_name();
+
+    enum { SIZE = 1000 };
+    int arr[SIZE];
+    srand(7);
+    for (int i = 0; i < SIZE; i++) arr[i] = rand() % 200;  // plenty of duplicates
+    UnrolledList* list = unrolled_create_from_array(arr, SIZE);
+    for (int i = 0; i < 300; i++) unrolled_delete_at(list, rand() % list->size);  // uneven node counts
+
+    for (int key = -1; key <= 200; key++) {
+        int* expected = unrolled_search(list, key);
+        assert(unrolled_search_simd_level(list, key, SIMD_SCALAR) == expected);
+        assert(unrolled_search_simd_level(list, key, SIMD_SSE2) == expected);
+        assert(unrolled_search_simd_level(list, key, SIMD_AVX2) == expected);
+        assert(unrolled_search_simd(list, key) == expected);
+    }
+
+    unrolled_free_all(list);
+    passed();
+}
+
+void test_count_matches_and_search_all() {
+    print_test_func_name();
+
+    int arr[40];
+    for (int i = 0; i < 40; i++) arr[i] = i % 3;  // 14 zeros, 13 ones, 13 twos
+    UnrolledList* list = unrolled_create_from_array(arr, 40);
+
+    assert(unrolled_count_matches(list, 0) == 14);
+    assert(unrolled_count_matches(list, 2) == 13);
+    assert(unrolled_count_matches(list, 3) == 0);
+
+    int* out[40];
+    assert(unrolled_search_all(list, 1, out, 40) == 13);
+    for (int i = 0; i < 13; i++) assert(out[i] == unrolled_find_kth(list, 3 * i + 1));
+
+    int* few[2];
+    assert(unrolled_search_all(list, 1, few, 2) == 13);  // the total is returned even when out is full
+    assert(few[0] == out[0] && few[1] == out[1]);
+
+    unrolled_free_all(list);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+// the one-int-per-node list from 1_singly_linked_list.c
+typedef struct Node {
+    int data;
+    struct Node* next;
+} Node;
+
+static Node* create_nodes_from_array(int a[], int size) {
+    Node* head = NULL;
+    Node** link = &head;
+    for (int i = 0; i < size; i++) {
+        Node* node = (Node*)malloc(sizeof(*node));
+        node->data = a[i];
+        node->next = NULL;
+        *link = node;
+        link = &node->next;
+    }
+    return head;
+}
+
+static void free_all(Node* head) {
+    while (head != NULL) {
+        Node* next = head->next;
+        free(head);
+        head = next;
+    }
+}
+
+static Node* search(Node* head, int key) {
+    for (Node* n = head; n != NULL; n = n->next) {
+        if (n->data == key) return n;
+    }
+    return NULL;
+}
+
+static Node* find_kth(Node* head, int k) {
+    Node* node = head;
+    for (int i = 0; i < k; i++) node = node->next;
+    return node;
+}
+
+void bench_unrolled_vs_singly() {
+    print_test_func_name();
+
+    for (int size = 1000; size <= 10000000; size *= 10) {
+        int* arr = (int*)malloc(sizeof(int) * size);
+        for (int i = 0; i < size; i++) arr[i] = i;
+        int reps = 10000000 / size > 0 ? 10000000 / size : 1;  // ~10^7 elements scanned per measurement
+        char label[64];
+
+        Node* head = create_nodes_from_array(arr, size);
+        UnrolledList* list = unrolled_create_from_array(arr, size);
+
+        int misses = 0;
+        long long start = now_ns();
+        for (int r = 0; r < reps; r++) misses += search(head, -1) == NULL;
+        long long end = now_ns();
+        snprintf(label, sizeof(label), "n=%d singly search", size);
+        print_bench_result(label, end - start, (long long)reps * size);
+        bench_keep(misses);
+        assert(misses == reps);
+
+        misses = 0;
+        start = now_ns();
+        for (int r = 0; r < reps; r++) misses += unrolled_search(list, -1) == NULL;
+        end = now_ns();
+        snprintf(label, sizeof(label), "n=%d unrolled search", size);
+        print_bench_result(label, end - start, (long long)reps * size);
+        bench_keep(misses);
+        assert(misses == reps);
+
+        long long sum = 0;
+        start = now_ns();
+        for (int r = 0; r < reps; r++) sum += find_kth(head, size - 1)->data;
+        end = now_ns();
+        snprintf(label, sizeof(label), "n=%d singly find_kth", size);
+        print_bench_result(label, end - start, (long long)reps * size);
+        bench_keep(sum);
+        assert(sum == (long long)reps * (size - 1));
+
+        sum = 0;
+        start = now_ns();
+        for (int r = 0; r < reps; r++) sum += *unrolled_find_kth(list, size - 1);
+        end = now_ns();
+        snprintf(label, sizeof(label), "n=%d unrolled find_kth", size);
+        print_bench_result(label, end - start, (long long)reps * size);
+        bench_keep(sum);
+        assert(sum == (long long)reps * (size - 1));
+
+        free_all(head);
+        unrolled_free_all(list);
+        free(arr);
+    }
+}
+
+void bench_search_simd() {
+    print_test_func_name();
+
+    const char* names[] = {"scalar", "sse2", "avx2"};
+    printf("detected level: %s\n", names[simd_detect_level()]);
+    for (int size = 100000; size <= 10000000; size *= 10) {
+        int* arr = (int*)malloc(sizeof(int) * size);
+        for (int i = 0; i < size; i++) arr[i] = i;
+        UnrolledList* list = unrolled_create_from_array(arr, size);
+        int reps = 10000000 / size * 5;
+        char label[64];
+
+        for (int level = SIMD_SCALAR; level <= SIMD_AVX2; level++) {
+            int misses = 0;
+            long long start = now_ns();
+            for (int r = 0; r < reps; r++) misses += unrolled_search_simd_level(list, -1, (SimdLevel)level) == NULL;
+            long long end = now_ns();
+            snprintf(label, sizeof(label), "n=%d %s search", size, names[level]);
+            print_bench_result(label, end - start, (long long)reps * size);
+            bench_keep(misses);
+            assert(misses == reps);
+        }
+
+        long long matches = 0;
+        long long start = now_ns();
+        for (int r = 0; r < reps; r++) matches += unrolled_count_matches(list, 5);
+        long long end = now_ns();
+        snprintf(label, sizeof(label), "n=%d count_matches", size);
+        print_bench_result(label, end - start, (long long)reps * size);
+        bench_keep(matches);
+        assert(matches == reps);
+
+        unrolled_free_all(list);
+        free(arr);
+    }
+}
+
+// harness cases: an unrolled list of 0..size-1 is built once per size
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    UnrolledList* list;
+} BenchState;
+
+static void* bench_setup(int size) {
+    int* arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) arr[i] = i;
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    bench_common_init(&state->common);
+    state->list = unrolled_create_from_array(arr, size);
+    free(arr);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    unrolled_free_all(((BenchState*)state)->list);
+    free(state);
+}
+
+static long long bench_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->common.sink += *unrolled_search(b->list, (int)(bench_random(&b->common.seed) % (uint32_t)size));
+    return 1;
+}
+
+static long long bench_search_simd_key(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->common.sink += *unrolled_search_simd(b->list, (int)(bench_random(&b->common.seed) % (uint32_t)size));
+    return 1;
+}
+
+static long long bench_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->common.sink += *unrolled_find_kth(b->list, (int)(bench_random(&b->common.seed) % (uint32_t)size));
+    return 1;
+}
+
+// the length stays the same
+static long long bench_insert_at_and_delete_at(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    unrolled_insert_at(b->list, (int)(bench_random(&b->common.seed) % (uint32_t)(size + 1)), size);
+    unrolled_delete_at(b->list, (int)(bench_random(&b->common.seed) % (uint32_t)(size + 1)));
+    return 1;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"unrolled_search", bench_setup, NULL, bench_search, bench_teardown},
+    {"unrolled_search_simd", bench_setup, NULL, bench_search_simd_key, bench_teardown},
+    {"unrolled_find_kth", bench_setup, NULL, bench_find_kth, bench_teardown},
+    {"unrolled_insert_at+delete_at", bench_setup, NULL, bench_insert_at_and_delete_at, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+    if (should_run_tests) {
+        test_node_is_one_cache_line();
+        test_create_from_array();
+        test_search();
+        test_insert_splits_full_node();
+        test_delete_borrows_from_full_successor();
+        test_delete_merges_with_successor();
+        test_delete_everything();
+        test_random_operations_match_array();
+        test_search_simd_matches_scalar();
+        test_count_matches_and_search_all();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) {
+            bench_unrolled_vs_singly();
+            bench_search_simd();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,481 @@
+/*
+- a doubly linked list that stores prev ^ next in one field instead of two pointers: a node is 16 bytes instead
+  of 24 (int data + one pointer-sized link, padded), the same as a singly node
+- the ends store NULL ^ neighbour, so a walk needs two consecutive nodes: next = prev ^ node->link
+- that is why the walk state is a cursor {prev, node}, and why insert_after and delete work at a cursor instead
+  of at a bare node pointer
+- the same step walks in both directions: xor_begin starts at the head going to the tail, xor_rbegin at the
+  tail going to the head; insert_after and delete follow the cursor's direction
+- the XorList handle stores head, tail and size: append and prepend are O(1), and reverse is O(1) too, it only
+  swaps head and tail since every link is symmetric
+- the links are not pointers as far as tools are concerned: debuggers and leak checkers cannot follow them
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_helper.h"
+
+typedef struct XorNode {
+    int data;
+    uintptr_t link;  // (uintptr_t)prev ^ (uintptr_t)next
+} XorNode;
+
+typedef struct XorList {
+    XorNode* head;
+    XorNode* tail;
+    int size;
+} XorList;
+
+// node is NULL past the end; reverse cursors walk from the tail to the head
+typedef struct XorCursor {
+    XorNode* prev;
+    XorNode* node;
+    int reverse;
+} XorCursor;
+
+static inline XorNode* xor_ptr(XorNode* a, XorNode* b) {
+    return (XorNode*)((uintptr_t)a ^ (uintptr_t)b);
+}
+
+// the neighbour of node that is not other
+static inline XorNode* xor_other(const XorNode* node, XorNode* other) {
+    return (XorNode*)(node->link ^ (uintptr_t)other);
+}
+
+XorNode* xor_create_node(int data) {
+    XorNode* node = (XorNode*)malloc(sizeof(*node));
+    node->data = data;
+    node->link = 0;
+    return node;
+}
+
+XorList* xor_list_create() {
+    XorList* list = (XorList*)malloc(sizeof(*list));
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+    return list;
+}
+
+void xor_list_free_all(XorList* list) {
+    XorNode* prev = NULL;
+    XorNode* node = list->head;
+    while (node != NULL) {
+        XorNode* next = xor_other(node, prev);
+        prev = node;
+        free(node);  // only its address is used from here on
+        node = next;
+    }
+    free(list);
+}
+
+int xor_list_length(const XorList* list) {
+    return list->size;
+}
+
+XorCursor xor_begin(const XorList* list) {
+    return (XorCursor){NULL, list->head, 0};
+}
+
+XorCursor xor_rbegin(const XorList* list) {
+    return (XorCursor){NULL, list->tail, 1};
+}
+
+void xor_cursor_next(XorCursor* cursor) {
+    XorNode* next = xor_other(cursor->node, cursor->prev);
+    cursor->prev = cursor->node;
+    cursor->node = next;
+}
+
+// the end the cursor walks towards, and the one it comes from
+static inline XorNode** xor_front_end(XorList* list, const XorCursor* cursor) {
+    return cursor->reverse ? &list->head : &list->tail;
+}
+
+static inline XorNode** xor_back_end(XorList* list, const XorCursor* cursor) {
+    return cursor->reverse ? &list->tail : &list->head;
+}
+
+void xor_list_append(XorList* list, XorNode* new_node) {
+    new_node->link = (uintptr_t)list->tail;
+    if (list->tail == NULL)
+        list->head = new_node;
+    else
+        list->tail->link ^= (uintptr_t)new_node;  // the old tail's NULL neighbour becomes new_node
+    list->tail = new_node;
+    list->size++;
+}
+
+void xor_list_prepend(XorList* list, XorNode* new_node) {
+    new_node->link = (uintptr_t)list->head;
+    if (list->head == NULL)
+        list->tail = new_node;
+    else
+        list->head->link ^= (uintptr_t)new_node;
+    list->head = new_node;
+    list->size++;
+}
+
+XorList* xor_list_create_from_array(int a[], int size) {
+    XorList* list = xor_list_create();
+    for (int i = 0; i < size; i++) {
+        xor_list_append(list, xor_create_node(a[i]));
+    }
+    return list;
+}
+
+// inserts new_node right after the cursor's node in the cursor's direction, the cursor stays where it is
+void xor_insert_after(XorList* list, const XorCursor* cursor, XorNode* new_node) {
+    XorNode* node = cursor->node;
+    XorNode* next = xor_other(node, cursor->prev);
+    new_node->link = (uintptr_t)xor_ptr(node, next);
+    node->link = (uintptr_t)xor_ptr(cursor->prev, new_node);
+    if (next != NULL)
+        next->link ^= (uintptr_t)xor_ptr(node, new_node);  // next's neighbour node becomes new_node
+    else
+        *xor_front_end(list, cursor) = new_node;
+    list->size++;
+}
+
+// deletes the cursor's node, the cursor moves on to the following node
+void xor_delete(XorList* list, XorCursor* cursor) {
+    XorNode* prev = cursor->prev;
+    XorNode* node = cursor->node;
+    XorNode* next = xor_other(node, prev);
+
+    if (prev != NULL)
+        prev->link ^= (uintptr_t)xor_ptr(node, next);
+    else
+        *xor_back_end(list, cursor) = next;
+    if (next != NULL)
+        next->link ^= (uintptr_t)xor_ptr(node, prev);
+    else
+        *xor_front_end(list, cursor) = prev;
+
+    free(node);
+    list->size--;
+    cursor->node = next;
+}
+
+// O(1): the links are symmetric, so walking from the old tail is walking the reversed list
+void xor_list_reverse(XorList* list) {
+    XorNode* head = list->head;
+    list->head = list->tail;
+    list->tail = head;
+}
+
+// a cursor on the k-th node from the head (k from 0), past the end if the list is shorter
+XorCursor xor_find_kth(const XorList* list, int k) {
+    XorCursor cursor = xor_begin(list);
+    for (int i = 0; i < k && cursor.node != NULL; i++) xor_cursor_next(&cursor);
+    return cursor;
+}
+
+XorCursor xor_search(const XorList* list, int key) {
+    XorCursor cursor = xor_begin(list);
+    while (cursor.node != NULL && cursor.node->data != key) xor_cursor_next(&cursor);
+    return cursor;
+}
+
+/*
+###############################
+###          tests          ###
+###############################
+*/
+// walks both directions
+static void assert_xor_list(const XorList* list, const int* expected, int size) {
+    int i = 0;
+    for (XorCursor c = xor_begin(list); c.node != NULL; xor_cursor_next(&c)) {
+        assert(i < size && c.node->data == expected[i]);
+        if (c.prev == NULL) assert(c.node == list->head);
+        i++;
+    }
+    assert(i == size && xor_list_length(list) == size);
+    for (XorCursor c = xor_rbegin(list); c.node != NULL; xor_cursor_next(&c)) {
+        assert(c.node->data == expected[--i]);
+    }
+    assert(i == 0);
+    assert((list->head == NULL) == (list->tail == NULL));
+}
+
+void test_node_size() {
+    print_test_func_name();
+
+    assert(sizeof(XorNode) == sizeof(int) + sizeof(uintptr_t) || sizeof(XorNode) == 2 * sizeof(uintptr_t));
+    assert(sizeof(XorNode) < sizeof(int) + 2 * sizeof(void*));
+
+    passed();
+}
+
+void test_append_and_prepend() {
+    print_test_func_name();
+
+    XorList* list = xor_list_create();
+    assert_xor_list(list, NULL, 0);
+    xor_list_append(list, xor_create_node(2));
+    assert(list->head == list->tail);
+    xor_list_prepend(list, xor_create_node(1));
+    xor_list_append(list, xor_create_node(3));
+    xor_list_prepend(list, xor_create_node(0));
+    assert_xor_list(list, (int[]){0, 1, 2, 3}, 4);
+
+    xor_list_free_all(list);
+    passed();
+}
+
+void test_find_kth_and_search() {
+    print_test_func_name();
+
+    XorList* list = xor_list_create_from_array((int[]){5, 6, 7}, 3);
+    assert(xor_find_kth(list, 0).node == list->head);
+    assert(xor_find_kth(list, 2).node->data == 7);
+    assert(xor_find_kth(list, 3).node == NULL);
+    assert(xor_search(list, 6).node == xor_find_kth(list, 1).node);
+    assert(xor_search(list, 8).node == NULL);
+
+    xor_list_free_all(list);
+    passed();
+}
+
+void test_insert_after() {
+    print_test_func_name();
+
+    XorList* list = xor_list_create_from_array((int[]){1, 3}, 2);
+    XorCursor c = xor_search(list, 1);
+    xor_insert_after(list, &c, xor_create_node(2));  // middle
+    c = xor_search(list, 3);
+    xor_insert_after(list, &c, xor_create_node(4));  // after the tail
+    assert_xor_list(list, (int[]){1, 2, 3, 4}, 4);
+
+    c = xor_rbegin(list);  // reverse cursor: after means towards the head
+    xor_cursor_next(&c);   // on 3
+    xor_insert_after(list, &c, xor_create_node(25));
+    c = xor_rbegin(list);
+    while (xor_other(c.node, c.prev) != NULL) xor_cursor_next(&c);  // on the head, going towards the head
+    xor_insert_after(list, &c, xor_create_node(0));                   // a new head
+    assert_xor_list(list, (int[]){0, 1, 2, 25, 3, 4}, 6);
+
+    XorList* single = xor_list_create_from_array((int[]){1}, 1);
+    c = xor_rbegin(single);
+    xor_insert_after(single, &c, xor_create_node(0));
+    assert_xor_list(single, (int[]){0, 1}, 2);
+
+    xor_list_free_all(single);
+    xor_list_free_all(list);
+    passed();
+}
+
+void test_delete() {
+    print_test_func_name();
+
+    XorList* list = xor_list_create_from_array((int[]){0, 1, 2, 3, 4, 5}, 6);
+    XorCursor c = xor_search(list, 2);
+    xor_delete(list, &c);  // middle, the cursor moves on to 3
+    assert(c.node->data == 3);
+    xor_delete(list, &c);
+    assert_xor_list(list, (int[]){0, 1, 4, 5}, 4);
+
+    c = xor_begin(list);
+    xor_delete(list, &c);  // head
+    c = xor_rbegin(list);
+    xor_delete(list, &c);  // tail, through a reverse cursor
+    assert(c.node->data == 4);
+    assert_xor_list(list, (int[]){1, 4}, 2);
+
+    c = xor_begin(list);
+    while (c.node != NULL) xor_delete(list, &c);
+    assert_xor_list(list, NULL, 0);
+
+    xor_list_free_all(list);
+    passed();
+}
+
+void test_reverse() {
+    print_test_func_name();
+
+    XorList* list = xor_list_create_from_array((int[]){1, 2, 3, 4}, 4);
+    xor_list_reverse(list);
+    assert_xor_list(list, (int[]){4, 3, 2, 1}, 4);
+
+    xor_list_append(list, xor_create_node(0));  // the reversed list is a normal list
+    XorCursor c = xor_search(list, 2);
+    xor_insert_after(list, &c, xor_create_node(15));
+    xor_delete(list, &c);
+    xor_list_reverse(list);
+    assert_xor_list(list, (int[]){0, 1, 15, 3, 4}, 5);
+
+    xor_list_free_all(list);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_LIST_SIZE 1000000
+#define BENCH_REPEAT 10
+
+// the node of 1_doubly_linked_list.c
+typedef struct DNode {
+    int data;
+    struct DNode* prev;
+    struct DNode* next;
+} DNode;
+
+// node sizes, full traversals in both directions and reverse, against the two-pointer doubly list
+void bench_xor_vs_doubly() {
+    print_test_func_name();
+
+    printf("%-40s %12zu bytes\n", "DNode size", sizeof(DNode));
+    printf("%-40s %12zu bytes\n", "XorNode size", sizeof(XorNode));
+    long long total = (long long)BENCH_REPEAT * BENCH_LIST_SIZE;
+
+    DNode* head = NULL;
+    DNode* tail = NULL;
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+        DNode* node = (DNode*)malloc(sizeof(*node));
+        *node = (DNode){i, tail, NULL};
+        if (tail != NULL)
+            tail->next = node;
+        else
+            head = node;
+        tail = node;
+    }
+    int* arr = (int*)malloc(sizeof(int) * BENCH_LIST_SIZE);
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) arr[i] = i;
+    XorList* list = xor_list_create_from_array(arr, BENCH_LIST_SIZE);
+    int count = 0;
+
+    long long start = now_ns();
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        for (DNode* n = head; n != NULL; n = n->next) count += n->data == -1;
+    }
+    print_bench_result("doubly forward", now_ns() - start, total);
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        for (DNode* n = tail; n != NULL; n = n->prev) count += n->data == -1;
+    }
+    print_bench_result("doubly backward", now_ns() - start, total);
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEAT; r++) count += xor_search(list, -1).node != NULL;
+    print_bench_result("xor forward", now_ns() - start, total);
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        for (XorCursor c = xor_rbegin(list); c.node != NULL; xor_cursor_next(&c)) count += c.node->data == -1;
+    }
+    print_bench_result("xor backward", now_ns() - start, total);
+
+    // reversing a two-pointer list swaps prev and next in every node
+    start = now_ns();
+    for (DNode* n = head; n != NULL; n = n->prev) {
+        DNode* next = n->next;
+        n->next = n->prev;
+        n->prev = next;
+    }
+    DNode* old_head = head;
+    head = tail;
+    tail = old_head;
+    print_bench_result("doubly reverse (per node)", now_ns() - start, BENCH_LIST_SIZE);
+    start = now_ns();
+    xor_list_reverse(list);
+    print_bench_result("xor reverse (per node)", now_ns() - start, BENCH_LIST_SIZE);
+    assert(head->data == BENCH_LIST_SIZE - 1 && list->head->data == BENCH_LIST_SIZE - 1);
+    assert(count == 0);
+
+    while (head != NULL) {
+        DNode* next = head->next;
+        free(head);
+        head = next;
+    }
+    xor_list_free_all(list);
+    free(arr);
+}
+
+// harness cases: an XorList of 0..size-1 is built once per size
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    XorList* list;
+} BenchState;
+
+static void* bench_setup(int size) {
+    int* arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) arr[i] = i;
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    bench_common_init(&state->common);
+    state->list = xor_list_create_from_array(arr, size);
+    free(arr);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    xor_list_free_all(((BenchState*)state)->list);
+    free(state);
+}
+
+static long long bench_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += xor_search(b->list, key).node->data;
+    return 1;
+}
+
+static long long bench_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int k = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += xor_find_kth(b->list, k).node->data;
+    return 1;
+}
+
+// one op per node
+static long long bench_backward_walk(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    for (XorCursor c = xor_rbegin(b->list); c.node != NULL; xor_cursor_next(&c)) b->common.sink += c.node->data;
+    return size;
+}
+
+// the length stays the same
+static long long bench_append_and_delete_head(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    xor_list_append(b->list, xor_create_node(size));
+    XorCursor head = xor_begin(b->list);
+    xor_delete(b->list, &head);
+    return 1;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"xor_search", bench_setup, NULL, bench_search, bench_teardown},
+    {"xor_find_kth", bench_setup, NULL, bench_find_kth, bench_teardown},
+    {"xor_rbegin walk (per node)", bench_setup, NULL, bench_backward_walk, bench_teardown},
+    {"xor_list_append+xor_delete(head)", bench_setup, NULL, bench_append_and_delete_head, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_node_size();
+        test_append_and_prepend();
+        test_find_kth_and_search();
+        test_insert_after();
+        test_delete();
+        test_reverse();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_xor_vs_doubly();
+    }
+
+    return 0;
+}
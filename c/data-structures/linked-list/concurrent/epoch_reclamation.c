@@ -0,0 +1,325 @@
+/*
+- tests and benchmarks of epoch_reclamation.h
+- a thread may hold several ErThread handles, so the single-threaded tests play a stalled reader and a writer
+  from the same OS thread
+- Compile with -pthread
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "epoch_reclamation.h"
+#include "test_helper.h"
+
+static void retire_nodes(ErThread* writer, int count) {
+    for (int i = 0; i < count; i++) {
+        er_enter(writer);
+        er_retire(writer, malloc(16));
+        er_exit(writer);
+    }
+}
+
+void test_er_counters() {
+    print_test_func_name();
+
+    for (ErMode mode = ER_EPOCH; mode <= ER_QSBR; mode++) {
+        ErDomain* domain = er_create(mode);
+        er_set_limits(domain, 4, 64);
+        ErThread* thread = er_register(domain);
+
+        ErStats stats = er_stats(domain);
+        assert(stats.retired == 0 && stats.freed == 0 && stats.pending == 0);
+
+        retire_nodes(thread, 10);
+        stats = er_stats(domain);
+        assert(stats.retired == 10);
+        assert(stats.freed > 0);  // batches of 4 were collected on the way
+        assert(stats.pending == stats.retired - stats.freed);
+
+        er_unregister(thread);
+        stats = er_stats(domain);
+        assert(stats.freed == 10 && stats.pending == 0);
+
+        er_destroy(domain);
+    }
+    passed();
+}
+
+// a reader inside an operation pins every node retired from then on
+void test_er_epoch_stalled_reader_blocks_frees() {
+    print_test_func_name();
+
+    ErDomain* domain = er_create(ER_EPOCH);
+    er_set_limits(domain, 8, 1000);
+    ErThread* reader = er_register(domain);
+    ErThread* writer = er_register(domain);
+
+    er_enter(reader);
+    retire_nodes(writer, 100);
+    er_collect(writer);
+    assert(er_stats(domain).freed == 0 && er_stats(domain).pending == 100);
+
+    er_exit(reader);
+    er_collect(writer);
+    er_collect(writer);
+    assert(er_stats(domain).freed == 100);
+
+    er_unregister(reader);
+    er_unregister(writer);
+    er_destroy(domain);
+    passed();
+}
+
+// a stalled reader only pins the node it protects
+void test_er_hazard_pins_only_protected() {
+    print_test_func_name();
+
+    ErDomain* domain = er_create(ER_HAZARD);
+    er_set_limits(domain, 8, 1000);
+    ErThread* reader = er_register(domain);
+    ErThread* writer = er_register(domain);
+
+    void* shared = malloc(16);
+    er_enter(reader);
+    void* protected_ptr = er_protect(reader, 0, &shared);
+    assert(protected_ptr == shared);
+
+    shared = NULL;  // unlinked
+    er_enter(writer);
+    er_retire(writer, protected_ptr);
+    er_exit(writer);
+    retire_nodes(writer, 99);
+    er_collect(writer);
+    assert(er_stats(domain).freed == 99 && er_stats(domain).pending == 1);
+
+    er_exit(reader);
+    er_collect(writer);
+    assert(er_stats(domain).pending == 0);
+
+    er_unregister(reader);
+    er_unregister(writer);
+    er_destroy(domain);
+    passed();
+}
+
+// qsbr: a registered reader pins every node retired after its last quiescent state, even without er_enter
+void test_er_qsbr_idle_reader_blocks_frees() {
+    print_test_func_name();
+
+    ErDomain* domain = er_create(ER_QSBR);
+    er_set_limits(domain, 8, 1000);
+    ErThread* reader = er_register(domain);
+    ErThread* writer = er_register(domain);
+    assert(reader->state == (atomic_load(&domain->epoch) << 1 | 1));  // online from er_register on
+
+    er_enter(reader);
+    assert(reader->state == (atomic_load(&domain->epoch) << 1 | 1));  // er_enter announces nothing
+    retire_nodes(writer, 100);
+    er_collect(writer);
+    er_collect(writer);
+    assert(er_stats(domain).freed == 0 && er_stats(domain).pending == 100);
+
+    // a node retired in epoch e waits for e + 2: two quiescent states of the reader, one advance after each
+    er_exit(reader);
+    er_collect(writer);
+    assert(er_stats(domain).freed < 100);
+    er_exit(reader);
+    er_collect(writer);
+    assert(er_stats(domain).freed == 100);
+
+    // an unregistered thread does not count anymore
+    retire_nodes(writer, 10);
+    er_unregister(reader);
+    er_collect(writer);
+    er_collect(writer);
+    assert(er_stats(domain).pending == 0);
+
+    er_unregister(writer);
+    er_destroy(domain);
+    passed();
+}
+
+void test_er_register_slots() {
+    print_test_func_name();
+
+    ErDomain* domain = er_create(ER_EPOCH);
+    ErThread* threads[ER_MAX_THREADS];
+    for (int i = 0; i < ER_MAX_THREADS; i++) {
+        threads[i] = er_register(domain);
+        assert(threads[i] != NULL);
+    }
+    assert(er_register(domain) == NULL);
+
+    er_unregister(threads[5]);
+    assert(er_register(domain) == threads[5]);
+
+    er_destroy(domain);
+    passed();
+}
+
+#define BOUND_THREADS 4
+#define BOUND_OPS 20000
+#define BOUND_MAX_PENDING 32
+
+static void* bounded_worker(void* arg) {
+    ErThread* thread = er_register((ErDomain*)arg);
+    for (int i = 0; i < BOUND_OPS; i++) {
+        er_enter(thread);
+        er_retire(thread, malloc(16));
+        er_exit(thread);
+        assert(thread->retired_size <= BOUND_MAX_PENDING);  // er_exit waits until it is back under the bound
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+void test_er_pending_is_bounded() {
+    print_test_func_name();
+
+    for (ErMode mode = ER_EPOCH; mode <= ER_QSBR; mode++) {
+        ErDomain* domain = er_create(mode);
+        er_set_limits(domain, 8, BOUND_MAX_PENDING);
+
+        pthread_t ids[BOUND_THREADS];
+        for (int t = 0; t < BOUND_THREADS; t++) pthread_create(&ids[t], NULL, bounded_worker, domain);
+        for (int t = 0; t < BOUND_THREADS; t++) pthread_join(ids[t], NULL);
+
+        ErStats stats = er_stats(domain);
+        assert(stats.retired == BOUND_THREADS * BOUND_OPS);
+        assert(stats.pending <= BOUND_THREADS * BOUND_MAX_PENDING);
+        if (mode != ER_QSBR) assert(stats.pending == 0);
+
+        // qsbr: a worker that unregistered while the others were still online left its last nodes in its slot
+        er_drain(domain);
+        assert(er_stats(domain).pending == 0);
+
+        er_destroy(domain);
+    }
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_OPS 10000000
+
+// the read-side cost of one operation that protects two pointers
+void bench_er_read_side() {
+    print_test_func_name();
+
+    void* shared = malloc(16);
+    const char* names[] = {"epoch enter+2 protect+exit", "hazard enter+2 protect+exit", "qsbr enter+2 protect+exit"};
+    for (ErMode mode = ER_EPOCH; mode <= ER_QSBR; mode++) {
+        ErDomain* domain = er_create(mode);
+        ErThread* thread = er_register(domain);
+
+        long long start = now_ns();
+        for (int i = 0; i < BENCH_OPS; i++) {
+            er_enter(thread);
+            er_protect(thread, 0, &shared);
+            er_protect(thread, 1, &shared);
+            er_exit(thread);
+        }
+        long long end = now_ns();
+        print_bench_result(names[mode], end - start, BENCH_OPS);
+
+        er_unregister(thread);
+        er_destroy(domain);
+    }
+    free(shared);
+}
+
+// harness cases: one domain per size, the size is the number of operations of one repetition
+static const int BENCH_SIZES[] = {1000, 100000};
+
+typedef struct BenchState {
+    ErDomain* domain;
+    ErThread* thread;
+    void* shared;
+} BenchState;
+
+static BenchState* bench_setup_mode(ErMode mode) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->domain = er_create(mode);
+    state->thread = er_register(state->domain);
+    state->shared = malloc(16);
+    return state;
+}
+
+static void* bench_setup_epoch(int size) {
+    (void)size;
+    return bench_setup_mode(ER_EPOCH);
+}
+
+static void* bench_setup_hazard(int size) {
+    (void)size;
+    return bench_setup_mode(ER_HAZARD);
+}
+
+static void* bench_setup_qsbr(int size) {
+    (void)size;
+    return bench_setup_mode(ER_QSBR);
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    er_unregister(b->thread);
+    er_destroy(b->domain);
+    free(b->shared);
+    free(b);
+}
+
+static long long bench_read_side(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    for (int i = 0; i < size; i++) {
+        er_enter(b->thread);
+        er_protect(b->thread, 0, &b->shared);
+        er_protect(b->thread, 1, &b->shared);
+        er_exit(b->thread);
+    }
+    return size;
+}
+
+// the malloc of the retired block is timed too, the frees happen in the batches of er_retire
+static long long bench_retire(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    retire_nodes(b->thread, size);
+    return size;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"epoch enter+2 protect+exit", bench_setup_epoch, NULL, bench_read_side, bench_teardown},
+    {"hazard enter+2 protect+exit", bench_setup_hazard, NULL, bench_read_side, bench_teardown},
+    {"qsbr enter+2 protect+exit", bench_setup_qsbr, NULL, bench_read_side, bench_teardown},
+    {"epoch malloc+retire", bench_setup_epoch, NULL, bench_retire, bench_teardown},
+    {"hazard malloc+retire", bench_setup_hazard, NULL, bench_retire, bench_teardown},
+    {"qsbr malloc+retire", bench_setup_qsbr, NULL, bench_retire, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_er_counters();
+        test_er_epoch_stalled_reader_blocks_frees();
+        test_er_hazard_pins_only_protected();
+        test_er_qsbr_idle_reader_blocks_frees();
+        test_er_register_slots();
+        test_er_pending_is_bounded();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_er_read_side();
+    }
+
+    return 0;
+}
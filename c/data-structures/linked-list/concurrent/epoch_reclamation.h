@@ -0,0 +1,261 @@
+/*
+- safe memory reclamation for the concurrent lists: a node unlinked by one thread may still be read by another,
+  so it is retired (er_retire) instead of freed, and freed once no thread can hold a reference to it anymore
+- every thread registers with the domain (er_register) and wraps each list operation in er_enter / er_exit
+- epoch mode: er_enter announces the global epoch, er_exit announces being outside; the global epoch advances
+  once every thread inside an operation has announced it, and a node retired in epoch e is freed once the global
+  epoch reached e + 2. er_enter is an RMW on the thread's own cache line (a locked instruction, a full barrier on
+  x86) and er_exit a release store, so every operation pays one barrier; one thread stuck inside an operation
+  blocks every free
+- qsbr mode (quiescent-state based): a registered thread counts as inside until it announces a quiescent state;
+  er_enter does nothing, er_exit and er_collect announce one (an acquire load of the global epoch and a release
+  store to the thread's own slot: no RMW, no fence). The epochs work as above. Operations must not nest, and a
+  thread that stays registered without calling er_exit blocks every free, so idle threads unregister. Only
+  er_register, which puts the thread online, is an RMW
+- hazard pointer mode: before dereferencing a pointer, er_protect publishes it in one of the thread's
+  ER_HAZARDS_PER_THREAD slots and re-checks its source; a node is freed when no slot holds it. A store and a
+  fence per protected pointer, but a stuck thread only pins the nodes it protects
+- er_protect is a plain acquire load in epoch and qsbr mode, so list code is written once for every mode
+- retired nodes go to a per-thread list, er_retire frees what it can (er_reclaim) every `batch` nodes; er_collect
+  does the same from outside an operation
+- bounded memory: in hazard mode by design, in epoch and qsbr mode er_exit waits while this thread has more than
+  max_pending nodes pending (the wait lasts as long as another thread stays inside one operation)
+- counters: er_stats sums retired, freed and pending (retired - freed) over all threads; er_drain frees what is
+  still pending once the domain is quiescent
+*/
+
+#ifndef EPOCH_RECLAMATION
+#define EPOCH_RECLAMATION
+
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ER_MAX_THREADS 64
+#define ER_HAZARDS_PER_THREAD 4
+#define ER_DEFAULT_BATCH 64
+#define ER_DEFAULT_MAX_PENDING 4096
+#define ER_CACHE_LINE 64
+
+typedef enum ErMode { ER_EPOCH, ER_HAZARD, ER_QSBR } ErMode;
+
+typedef struct ErRetired {
+    void* ptr;
+    unsigned long epoch;  // global epoch when it was retired
+} ErRetired;
+
+struct ErDomain;
+
+// aligned so that threads never share the cache line of their announcements
+typedef struct ErThread {
+    // epoch << 1 | 1 inside an operation, 0 outside; qsbr: the epoch of the last quiescent state, 0 unregistered
+    _Alignas(ER_CACHE_LINE) _Atomic unsigned long state;
+    _Atomic(void*) hazards[ER_HAZARDS_PER_THREAD];
+    _Atomic int in_use;
+    struct ErDomain* domain;
+    ErRetired* retired;
+    size_t retired_size;
+    size_t retired_capacity;
+    _Atomic long retired_count;  // written by the owner only, atomic so that er_stats can read it
+    _Atomic long freed_count;
+} ErThread;
+
+typedef struct ErDomain {
+    ErMode mode;
+    size_t batch;
+    size_t max_pending;
+    _Alignas(ER_CACHE_LINE) _Atomic unsigned long epoch;
+    ErThread threads[ER_MAX_THREADS];
+} ErDomain;
+
+typedef struct ErStats {
+    long retired;
+    long freed;
+    long pending;
+} ErStats;
+
+static inline ErDomain* er_create(ErMode mode) {
+    size_t size = (sizeof(ErDomain) + ER_CACHE_LINE - 1) / ER_CACHE_LINE * ER_CACHE_LINE;
+    ErDomain* domain = (ErDomain*)aligned_alloc(ER_CACHE_LINE, size);
+    memset(domain, 0, sizeof(*domain));
+    domain->mode = mode;
+    domain->batch = ER_DEFAULT_BATCH;
+    domain->max_pending = ER_DEFAULT_MAX_PENDING;
+    atomic_init(&domain->epoch, 1);
+    for (int i = 0; i < ER_MAX_THREADS; i++) domain->threads[i].domain = domain;
+    return domain;
+}
+
+// max_pending must be at least batch, set before threads register
+static inline void er_set_limits(ErDomain* domain, size_t batch, size_t max_pending) {
+    domain->batch = batch;
+    domain->max_pending = max_pending < batch ? batch : max_pending;
+}
+
+// frees every pending node, no thread may use the domain anymore
+static inline void er_destroy(ErDomain* domain) {
+    for (int i = 0; i < ER_MAX_THREADS; i++) {
+        ErThread* thread = &domain->threads[i];
+        for (size_t j = 0; j < thread->retired_size; j++) free(thread->retired[j].ptr);
+        free(thread->retired);
+    }
+    free(domain);
+}
+
+// returns NULL if ER_MAX_THREADS threads are registered already
+static inline ErThread* er_register(ErDomain* domain) {
+    for (int i = 0; i < ER_MAX_THREADS; i++) {
+        ErThread* thread = &domain->threads[i];
+        int expected = 0;
+        if (!atomic_compare_exchange_strong(&thread->in_use, &expected, 1)) continue;
+
+        // qsbr: online from here on; an RMW, so that no later list load can move before the announcement
+        if (domain->mode == ER_QSBR) atomic_exchange(&thread->state, atomic_load(&domain->epoch) << 1 | 1);
+        return thread;
+    }
+    return NULL;
+}
+
+static inline void er_reclaim(ErThread* thread);
+static inline void er_collect(ErThread* thread);
+
+// two epoch advances free everything unless another thread is inside an operation
+// the nodes that cannot be freed yet stay in the slot, the next thread to register there takes them over
+static inline void er_unregister(ErThread* thread) {
+    atomic_store_explicit(&thread->state, 0, memory_order_release);  // already 0 unless qsbr
+    for (int i = 0; i < 3 && thread->retired_size > 0; i++) er_reclaim(thread);
+    atomic_store(&thread->in_use, 0);
+}
+
+static inline void er_enter(ErThread* thread) {
+    if (thread->domain->mode != ER_EPOCH) return;
+
+    // an RMW: no later list load can move before the announcement
+    atomic_exchange(&thread->state, atomic_load(&thread->domain->epoch) << 1 | 1);
+}
+
+// qsbr: the thread holds no reference from its earlier operations; the release store keeps their loads before it
+static inline void er_quiesce(ErThread* thread) {
+    unsigned long epoch = atomic_load_explicit(&thread->domain->epoch, memory_order_acquire);
+    atomic_store_explicit(&thread->state, epoch << 1 | 1, memory_order_release);
+}
+
+// loads *src and keeps what it points to from being freed until the slot is reused or er_exit
+// a marked pointer (low bit set) protects the node it points to
+static inline void* er_protect(ErThread* thread, int slot, void** src) {
+    void* ptr = __atomic_load_n(src, __ATOMIC_ACQUIRE);
+    if (thread->domain->mode != ER_HAZARD) return ptr;
+
+    for (;;) {
+        // an RMW: published before *src is checked again
+        atomic_exchange(&thread->hazards[slot], (void*)((uintptr_t)ptr & ~(uintptr_t)1));
+        void* again = __atomic_load_n(src, __ATOMIC_SEQ_CST);
+        if (again == ptr) return ptr;
+        ptr = again;
+    }
+}
+
+static inline void er_exit(ErThread* thread) {
+    ErDomain* domain = thread->domain;
+    if (domain->mode == ER_EPOCH) {
+        atomic_store_explicit(&thread->state, 0, memory_order_release);
+    } else if (domain->mode == ER_QSBR) {
+        er_quiesce(thread);
+    } else {
+        for (int i = 0; i < ER_HAZARDS_PER_THREAD; i++) {
+            atomic_store_explicit(&thread->hazards[i], NULL, memory_order_release);
+        }
+    }
+
+    while (thread->retired_size > domain->max_pending) {
+        er_collect(thread);
+        if (thread->retired_size > domain->max_pending) sched_yield();
+    }
+}
+
+// the node must be unreachable for threads that enter afterwards
+static inline void er_retire(ErThread* thread, void* ptr) {
+    if (thread->retired_size == thread->retired_capacity) {
+        thread->retired_capacity = thread->retired_capacity ? 2 * thread->retired_capacity : thread->domain->batch;
+        thread->retired = (ErRetired*)realloc(thread->retired, sizeof(ErRetired) * thread->retired_capacity);
+    }
+
+    atomic_thread_fence(memory_order_seq_cst);  // the unlink is visible before the epoch is read
+    unsigned long epoch = atomic_load_explicit(&thread->domain->epoch, memory_order_relaxed);
+    thread->retired[thread->retired_size++] = (ErRetired){ptr, epoch};
+    atomic_store_explicit(&thread->retired_count, thread->retired_count + 1, memory_order_relaxed);
+
+    if (thread->retired_size % thread->domain->batch == 0) er_reclaim(thread);
+}
+
+// advances the global epoch if every thread inside an operation has announced the current one
+static inline unsigned long er_try_advance(ErDomain* domain) {
+    unsigned long epoch = atomic_load(&domain->epoch);
+    for (int i = 0; i < ER_MAX_THREADS; i++) {
+        unsigned long state = atomic_load(&domain->threads[i].state);
+        if ((state & 1) && (state >> 1) != epoch) return epoch;
+    }
+    atomic_compare_exchange_strong(&domain->epoch, &epoch, epoch + 1);
+    return atomic_load(&domain->epoch);
+}
+
+static inline int er_is_hazard(ErDomain* domain, void* ptr) {
+    for (int i = 0; i < ER_MAX_THREADS; i++) {
+        for (int j = 0; j < ER_HAZARDS_PER_THREAD; j++) {
+            if (atomic_load(&domain->threads[i].hazards[j]) == ptr) return 1;
+        }
+    }
+    return 0;
+}
+
+// frees this thread's retired nodes that nobody can reach anymore, also inside an operation
+static inline void er_reclaim(ErThread* thread) {
+    ErDomain* domain = thread->domain;
+    unsigned long epoch = domain->mode != ER_HAZARD ? er_try_advance(domain) : 0;
+
+    size_t kept = 0;
+    long freed = 0;
+    for (size_t i = 0; i < thread->retired_size; i++) {
+        ErRetired r = thread->retired[i];
+        int reachable = domain->mode != ER_HAZARD ? r.epoch + 2 > epoch : er_is_hazard(domain, r.ptr);
+        if (reachable) {
+            thread->retired[kept++] = r;
+        } else {
+            free(r.ptr);
+            freed++;
+        }
+    }
+    thread->retired_size = kept;
+    atomic_store_explicit(&thread->freed_count, thread->freed_count + freed, memory_order_relaxed);
+}
+
+// er_reclaim for a thread outside an operation, which in qsbr mode is a quiescent state
+static inline void er_collect(ErThread* thread) {
+    if (thread->domain->mode == ER_QSBR) er_quiesce(thread);
+    er_reclaim(thread);
+}
+
+// frees the pending nodes of every slot, registered or not: for a quiescent domain, where no thread is inside an
+// operation or retires meanwhile (e.g. once the workers are joined) and, in qsbr mode, every registered thread has
+// announced a quiescent state since; afterwards er_stats reports nothing pending
+static inline void er_drain(ErDomain* domain) {
+    for (int round = 0; round < 3; round++) {  // like er_unregister: two epoch advances, plus one
+        for (int i = 0; i < ER_MAX_THREADS; i++) {
+            if (domain->threads[i].retired_size > 0) er_reclaim(&domain->threads[i]);
+        }
+    }
+}
+
+static inline ErStats er_stats(ErDomain* domain) {
+    ErStats stats = {0, 0, 0};
+    for (int i = 0; i < ER_MAX_THREADS; i++) {
+        stats.retired += atomic_load_explicit(&domain->threads[i].retired_count, memory_order_relaxed);
+        stats.freed += atomic_load_explicit(&domain->threads[i].freed_count, memory_order_relaxed);
+    }
+    stats.pending = stats.retired - stats.freed;
+    return stats;
+}
+
+#endif
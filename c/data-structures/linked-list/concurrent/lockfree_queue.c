@@ -0,0 +1,374 @@
+/*
+- tests and benchmarks of lockfree_queue.h
+- the stress test checks that nothing is lost or duplicated and that every consumer sees each producer's
+  elements in the order they were enqueued
+- every test runs in both reclamation modes (epoch and hazard pointers)
+- the benchmark compares the queue in both modes against the List handle (O(1) append) behind a pthread mutex,
+  with 1 to 8 producer/consumer pairs; the harness cases time the uncontended single-thread costs
+- Compile with -pthread
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "lockfree_queue.h"
+#include "test_helper.h"
+
+typedef struct MutexQueue {
+    List* list;
+    pthread_mutex_t lock;
+} MutexQueue;
+
+void mutex_enqueue(MutexQueue* queue, int data) {
+    Node* node = create_node(data);
+    pthread_mutex_lock(&queue->lock);
+    list_append(queue->list, node);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+int mutex_dequeue(MutexQueue* queue, int* out) {
+    pthread_mutex_lock(&queue->lock);
+    Node* node = queue->list->head;
+    if (node != NULL) {
+        queue->list->head = node->next;
+        if (queue->list->head == NULL) queue->list->tail = NULL;
+        queue->list->size--;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    if (node == NULL) return 0;
+    *out = node->data;
+    free(node);
+    return 1;
+}
+
+static const char* mode_name(ErMode mode) {
+    return mode == ER_EPOCH ? "epoch" : "hazard";
+}
+
+void test_msq_fifo() {
+    print_test_func_name();
+
+    for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+        MsQueue* queue = msq_create(mode);
+        ErThread* thread = er_register(queue->domain);
+        int value = -1;
+        assert(msq_dequeue(queue, thread, &value) == 0 && value == -1);
+
+        for (int i = 0; i < 5; i++) msq_enqueue(queue, thread, i);
+        for (int i = 0; i < 5; i++) {
+            assert(msq_dequeue(queue, thread, &value) == 1);
+            assert(value == i);
+        }
+        assert(msq_dequeue(queue, thread, &value) == 0);
+        assert(er_stats(queue->domain).retired == 5);  // one old sentinel per element
+
+        er_unregister(thread);
+        msq_destroy(queue);
+    }
+    passed();
+}
+
+void test_msq_dequeue_batch() {
+    print_test_func_name();
+
+    for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+        MsQueue* queue = msq_create(mode);
+        ErThread* thread = er_register(queue->domain);
+        int out[8];
+        assert(msq_dequeue_batch(queue, thread, out, 8) == 0);
+
+        for (int i = 0; i < 10; i++) msq_enqueue(queue, thread, i);
+        assert(msq_dequeue_batch(queue, thread, out, 4) == 4);
+        for (int i = 0; i < 4; i++) assert(out[i] == i);
+        assert(msq_dequeue_batch(queue, thread, out, 8) == 6);  // fewer than max are left
+        for (int i = 0; i < 6; i++) assert(out[i] == 4 + i);
+        assert(msq_dequeue_batch(queue, thread, out, 8) == 0);
+
+        msq_enqueue(queue, thread, 42);  // the last node taken became the sentinel, the queue still works
+        assert(msq_dequeue_batch(queue, thread, out, 8) == 1 && out[0] == 42);
+        assert(er_stats(queue->domain).retired == 11);
+
+        er_unregister(thread);
+        msq_destroy(queue);
+    }
+    passed();
+}
+
+#define STRESS_PRODUCERS 4
+#define STRESS_CONSUMERS 4
+#define STRESS_PER_PRODUCER 100000
+#define STRESS_TOTAL (STRESS_PRODUCERS * STRESS_PER_PRODUCER)
+
+typedef struct StressArgs {
+    MsQueue* queue;
+    int id;
+    _Atomic int* consumed;
+    _Atomic char* seen;
+} StressArgs;
+
+static void* stress_producer(void* arg) {
+    StressArgs* args = (StressArgs*)arg;
+    ErThread* thread = er_register(args->queue->domain);
+    for (int i = 0; i < STRESS_PER_PRODUCER; i++) {
+        msq_enqueue(args->queue, thread, args->id * STRESS_PER_PRODUCER + i);
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+static void* stress_consumer(void* arg) {
+    StressArgs* args = (StressArgs*)arg;
+    ErThread* thread = er_register(args->queue->domain);
+    int last[STRESS_PRODUCERS];
+    for (int p = 0; p < STRESS_PRODUCERS; p++) last[p] = -1;
+
+    int out[16];
+    while (atomic_load(args->consumed) < STRESS_TOTAL) {
+        // odd consumers take batches, even ones single elements
+        int count = args->id % 2 ? msq_dequeue_batch(args->queue, thread, out, 16)
+                                 : msq_dequeue(args->queue, thread, out);
+        for (int i = 0; i < count; i++) {
+            int producer = out[i] / STRESS_PER_PRODUCER, seq = out[i] % STRESS_PER_PRODUCER;
+            assert(seq > last[producer]);  // FIFO per producer
+            last[producer] = seq;
+            assert(atomic_exchange(&args->seen[out[i]], 1) == 0);
+        }
+        atomic_fetch_add(args->consumed, count);
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+void test_msq_stress() {
+    print_test_func_name();
+
+    for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+        MsQueue* queue = msq_create(mode);
+        _Atomic int consumed = 0;
+        _Atomic char* seen = (_Atomic char*)calloc(STRESS_TOTAL, sizeof(*seen));
+
+        pthread_t ids[STRESS_PRODUCERS + STRESS_CONSUMERS];
+        StressArgs args[STRESS_PRODUCERS + STRESS_CONSUMERS];
+        for (int t = 0; t < STRESS_PRODUCERS + STRESS_CONSUMERS; t++) {
+            int is_producer = t < STRESS_PRODUCERS;
+            args[t] = (StressArgs){queue, is_producer ? t : t - STRESS_PRODUCERS, &consumed, seen};
+            pthread_create(&ids[t], NULL, is_producer ? stress_producer : stress_consumer, &args[t]);
+        }
+        for (int t = 0; t < STRESS_PRODUCERS + STRESS_CONSUMERS; t++) pthread_join(ids[t], NULL);
+
+        assert(atomic_load(&consumed) == STRESS_TOTAL);
+        for (int i = 0; i < STRESS_TOTAL; i++) assert(seen[i] == 1);
+        ErStats stats = er_stats(queue->domain);
+        assert(stats.retired == STRESS_TOTAL);  // one old sentinel per element
+        assert(stats.pending <= ER_MAX_THREADS * ER_DEFAULT_MAX_PENDING);
+        er_drain(queue->domain);
+        stats = er_stats(queue->domain);
+        assert(stats.pending == 0 && stats.freed == STRESS_TOTAL);
+
+        free(seen);
+        msq_destroy(queue);
+    }
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_PER_PRODUCER 500000
+#define BENCH_BATCH 32
+
+typedef struct BenchArgs {
+    MsQueue* queue;
+    MutexQueue* mutex_queue;
+    _Atomic long long* consumed;
+    long long total;
+    int batch;
+} BenchArgs;
+
+static void* bench_msq_producer(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    ErThread* thread = er_register(args->queue->domain);
+    for (int i = 0; i < BENCH_PER_PRODUCER; i++) msq_enqueue(args->queue, thread, i);
+    er_unregister(thread);
+    return NULL;
+}
+
+static void* bench_msq_consumer(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    ErThread* thread = er_register(args->queue->domain);
+    int out[BENCH_BATCH];
+    while (atomic_load_explicit(args->consumed, memory_order_relaxed) < args->total) {
+        int count = msq_dequeue_batch(args->queue, thread, out, args->batch);
+        if (count > 0) atomic_fetch_add_explicit(args->consumed, count, memory_order_relaxed);
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+static void* bench_mutex_producer(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    for (int i = 0; i < BENCH_PER_PRODUCER; i++) mutex_enqueue(args->mutex_queue, i);
+    return NULL;
+}
+
+static void* bench_mutex_consumer(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    int value;
+    while (atomic_load_explicit(args->consumed, memory_order_relaxed) < args->total) {
+        if (mutex_dequeue(args->mutex_queue, &value)) atomic_fetch_add_explicit(args->consumed, 1, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+// pairs producers with as many consumers, returns the ns of the whole run
+static long long run_bench(void* (*producer)(void*), void* (*consumer)(void*), BenchArgs* args, int pairs) {
+    pthread_t ids[32];
+    atomic_store(args->consumed, 0);
+    args->total = (long long)pairs * BENCH_PER_PRODUCER;
+
+    long long start = now_ns();
+    for (int t = 0; t < pairs; t++) {
+        pthread_create(&ids[2 * t], NULL, producer, args);
+        pthread_create(&ids[2 * t + 1], NULL, consumer, args);
+    }
+    for (int t = 0; t < 2 * pairs; t++) pthread_join(ids[t], NULL);
+    return now_ns() - start;
+}
+
+// ns per element (one enqueue + one dequeue) over all threads
+void bench_msq_vs_mutex() {
+    print_test_func_name();
+
+    printf("online cores: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    char label[64];
+    for (int pairs = 1; pairs <= 8; pairs *= 2) {
+        _Atomic long long consumed;
+        MutexQueue mutex_queue = {list_create(), PTHREAD_MUTEX_INITIALIZER};
+        BenchArgs args = {NULL, &mutex_queue, &consumed, 0, 1};
+        long long total = (long long)pairs * BENCH_PER_PRODUCER;
+
+        for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+            args.queue = msq_create(mode);
+            args.batch = 1;
+            long long ns = run_bench(bench_msq_producer, bench_msq_consumer, &args, pairs);
+            snprintf(label, sizeof(label), "%dP/%dC %s msq_dequeue", pairs, pairs, mode_name(mode));
+            print_bench_result(label, ns, total);
+
+            args.batch = BENCH_BATCH;
+            ns = run_bench(bench_msq_producer, bench_msq_consumer, &args, pairs);
+            snprintf(label, sizeof(label), "%dP/%dC %s msq_dequeue_batch(%d)", pairs, pairs, mode_name(mode),
+                     BENCH_BATCH);
+            print_bench_result(label, ns, total);
+            msq_destroy(args.queue);
+        }
+
+        long long ns = run_bench(bench_mutex_producer, bench_mutex_consumer, &args, pairs);
+        snprintf(label, sizeof(label), "%dP/%dC mutex List", pairs, pairs);
+        print_bench_result(label, ns, total);
+
+        list_free_all(mutex_queue.list);
+    }
+}
+
+// harness cases: the queues hold size elements, set up once per size, the calls run on one thread
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    MsQueue* queues[2];  // indexed by ErMode
+    ErThread* threads[2];
+    MutexQueue mutex_queue;
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    bench_common_init(&state->common);
+    for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+        state->queues[mode] = msq_create(mode);
+        state->threads[mode] = er_register(state->queues[mode]->domain);
+        for (int i = 0; i < size; i++) msq_enqueue(state->queues[mode], state->threads[mode], i);
+    }
+    state->mutex_queue = (MutexQueue){list_create(), PTHREAD_MUTEX_INITIALIZER};
+    for (int i = 0; i < size; i++) mutex_enqueue(&state->mutex_queue, i);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+        er_unregister(b->threads[mode]);
+        msq_destroy(b->queues[mode]);
+    }
+    list_free_all(b->mutex_queue.list);
+    pthread_mutex_destroy(&b->mutex_queue.lock);
+    free(b);
+}
+
+// the length stays the same
+static long long bench_msq_enqueue_and_dequeue(BenchState* b, ErMode mode, int size) {
+    int value;
+    msq_enqueue(b->queues[mode], b->threads[mode], size);
+    msq_dequeue(b->queues[mode], b->threads[mode], &value);
+    b->common.sink += value;
+    return 1;
+}
+
+static long long bench_msq_epoch(void* state, int size) {
+    return bench_msq_enqueue_and_dequeue((BenchState*)state, ER_EPOCH, size);
+}
+
+static long long bench_msq_hazard(void* state, int size) {
+    return bench_msq_enqueue_and_dequeue((BenchState*)state, ER_HAZARD, size);
+}
+
+// one op per element: BENCH_BATCH enqueues, then one msq_dequeue_batch
+static long long bench_msq_epoch_batch(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int out[BENCH_BATCH];
+    for (int i = 0; i < BENCH_BATCH; i++) msq_enqueue(b->queues[ER_EPOCH], b->threads[ER_EPOCH], size);
+    b->common.sink += msq_dequeue_batch(b->queues[ER_EPOCH], b->threads[ER_EPOCH], out, BENCH_BATCH);
+    return BENCH_BATCH;
+}
+
+static long long bench_mutex(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int value;
+    mutex_enqueue(&b->mutex_queue, size);
+    mutex_dequeue(&b->mutex_queue, &value);
+    b->common.sink += value;
+    return 1;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"epoch msq_enqueue+msq_dequeue", bench_setup, NULL, bench_msq_epoch, bench_teardown},
+    {"hazard msq_enqueue+msq_dequeue", bench_setup, NULL, bench_msq_hazard, bench_teardown},
+    {"epoch msq_dequeue_batch(32) (per elem)", bench_setup, NULL, bench_msq_epoch_batch, bench_teardown},
+    {"mutex List enqueue+dequeue", bench_setup, NULL, bench_mutex, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_msq_fifo();
+        test_msq_dequeue_batch();
+        test_msq_stress();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_msq_vs_mutex();
+    }
+
+    return 0;
+}
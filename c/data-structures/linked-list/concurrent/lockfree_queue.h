@@ -0,0 +1,113 @@
+/*
+- a lock-free multi-producer/multi-consumer FIFO queue (Michael & Scott) over the singly Node
+- `head` is a dummy sentinel: the first element is head->next, the queue is empty when head->next is NULL
+- msq_enqueue links the new node behind the last one with a CAS on its next, then swings `tail` (others help)
+- msq_dequeue_batch takes up to max elements with a single CAS on `head`: the last one taken becomes the new sentinel
+- the old sentinels are retired to the queue's reclamation domain (epoch_reclamation.h), every thread passes its
+  ErThread; a retired node is not freed while a thread can still hold it, so its address is never reused under
+  a pending CAS: no ABA
+- head, tail and next are plain Node* fields accessed with the __atomic builtins
+*/
+
+#ifndef LOCKFREE_QUEUE
+#define LOCKFREE_QUEUE
+
+#include <stdlib.h>
+
+#include "epoch_reclamation.h"
+#include "tricks/singly_linked_list.h"
+
+typedef struct MsQueue {
+    Node* head;
+    Node* tail;
+    ErDomain* domain;
+} MsQueue;
+
+static inline Node* msq_load(Node** src) {
+    return __atomic_load_n(src, __ATOMIC_ACQUIRE);
+}
+
+static inline int msq_cas(Node** src, Node* expected, Node* desired) {
+    return __atomic_compare_exchange_n(src, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static inline MsQueue* msq_create(ErMode mode) {
+    MsQueue* queue = (MsQueue*)malloc(sizeof(*queue));
+    queue->head = queue->tail = create_node(0);
+    queue->domain = er_create(mode);
+    return queue;
+}
+
+// frees the queued nodes and the retired ones, no other thread may use the queue anymore
+static inline void msq_destroy(MsQueue* queue) {
+    free_all(queue->head);
+    er_destroy(queue->domain);
+    free(queue);
+}
+
+static inline void msq_enqueue(MsQueue* queue, ErThread* thread, int data) {
+    Node* node = create_node(data);
+    er_enter(thread);
+    for (;;) {
+        Node* tail = (Node*)er_protect(thread, 0, (void**)&queue->tail);
+        Node* next = msq_load(&tail->next);
+        if (next != NULL) {
+            msq_cas(&queue->tail, tail, next);  // help the lagging tail
+            continue;
+        }
+        if (msq_cas(&tail->next, NULL, node)) {
+            msq_cas(&queue->tail, tail, node);  // may fail: someone helped already
+            break;
+        }
+    }
+    er_exit(thread);
+}
+
+// takes up to max elements in FIFO order into out, returns how many (0 if the queue is empty)
+// out[taken..max) may be overwritten by failed attempts
+static inline int msq_dequeue_batch(MsQueue* queue, ErThread* thread, int* out, int max) {
+    if (max <= 0) return 0;
+
+    int taken = 0;
+    er_enter(thread);
+    for (;;) {
+        Node* head = (Node*)er_protect(thread, 0, (void**)&queue->head);
+        Node* tail = msq_load(&queue->tail);
+        Node* first = msq_load(&head->next);
+        if (head == tail) {
+            if (first == NULL) break;
+            msq_cas(&queue->tail, tail, first);  // never let head pass tail
+            continue;
+        }
+
+        // walk up to max nodes, but not past tail; while head has not moved none of them is retired
+        Node* last = head;
+        int count = 0, slot = 1;
+        while (count < max && last != tail) {
+            Node* next = (Node*)er_protect(thread, slot, (void**)&last->next);
+            if (next == NULL || msq_load(&queue->head) != head) break;
+            out[count++] = next->data;
+            last = next;
+            slot = 3 - slot;  // keeps last protected while its successor is loaded
+        }
+        if (count == 0 || !msq_cas(&queue->head, head, last)) continue;
+
+        // head .. the node before last left the queue, last is the new sentinel
+        for (Node* n = head; n != last;) {
+            Node* next = n->next;
+            er_retire(thread, n);
+            n = next;
+        }
+        taken = count;
+        break;
+    }
+    er_exit(thread);
+    return taken;
+}
+
+// returns 0 and leaves *out untouched if the queue is empty
+static inline int msq_dequeue(MsQueue* queue, ErThread* thread, int* out) {
+    return msq_dequeue_batch(queue, thread, out, 1);
+}
+
+#endif
@@ -0,0 +1,447 @@
+/*
+- tests and benchmarks of lockfree_set.h
+- the stress tests check properties every linearizable history must have:
+  threads with disjoint keys get exactly the results of a sequential run,
+  keys that never change are always (or never) found by concurrent contains,
+  and on shared keys successful inserts and removes alternate, so inserts - removes is 0 or 1 per key
+- every test runs in both reclamation modes (epoch and hazard pointers)
+- the benchmark runs read-heavy and write-heavy mixes against a sorted singly list behind a pthread mutex, over
+  1 to 8 threads; the harness cases time the uncontended single-thread costs
+- Compile with -pthread
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "lockfree_set.h"
+#include "test_helper.h"
+
+static inline unsigned xorshift32(unsigned* state) {
+    unsigned x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static void assert_strictly_sorted(HarrisSet* set, int size) {
+    int count = 0;
+    for (Node* n = set->head->next; n != NULL; n = n->next, count++) {
+        assert(!hs_is_marked(n->next));  // nothing logically deleted is left behind
+        if (n->next != NULL) assert(n->data < n->next->data);
+    }
+    assert(count == size);
+}
+
+static const char* mode_name(ErMode mode) {
+    return mode == ER_EPOCH ? "epoch" : "hazard";
+}
+
+void test_hs_single_thread() {
+    print_test_func_name();
+
+    for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+        HarrisSet* set = hs_create(mode);
+        ErThread* thread = er_register(set->domain);
+        assert(!hs_contains(set, thread, 5));
+        assert(hs_remove(set, thread, 5) == 0);
+
+        int keys[] = {5, -3, 9, 0, 7};
+        for (int i = 0; i < 5; i++) assert(hs_insert(set, thread, keys[i]) == 1);
+        assert(hs_insert(set, thread, 9) == 0);
+        assert_strictly_sorted(set, 5);
+        for (int i = 0; i < 5; i++) assert(hs_contains(set, thread, keys[i]));
+        assert(!hs_contains(set, thread, 1) && !hs_contains(set, thread, 10) && !hs_contains(set, thread, -4));
+
+        assert(hs_remove(set, thread, 0) == 1);
+        assert(hs_remove(set, thread, 0) == 0);
+        assert(!hs_contains(set, thread, 0));
+        assert(hs_insert(set, thread, 0) == 1);  // a removed key can come back
+        assert(hs_contains(set, thread, 0));
+        assert_strictly_sorted(set, 5);
+        assert(er_stats(set->domain).retired == 1);
+
+        er_unregister(thread);
+        hs_destroy(set);
+    }
+    passed();
+}
+
+#define STRESS_THREADS 8
+#define STRESS_OPS 100000
+#define STRESS_KEYS_PER_THREAD 64
+
+typedef struct StressArgs {
+    HarrisSet* set;
+    int id;
+    char present[STRESS_KEYS_PER_THREAD];  // sequential model of this thread's keys
+    long removed;                          // successful hs_remove calls, each retires one node
+} StressArgs;
+
+// thread t owns the keys k * STRESS_THREADS + t, every result must match its sequential model
+static void* disjoint_worker(void* arg) {
+    StressArgs* args = (StressArgs*)arg;
+    ErThread* thread = er_register(args->set->domain);
+    unsigned rng = args->id + 1;
+    for (int i = 0; i < STRESS_OPS; i++) {
+        int k = xorshift32(&rng) % STRESS_KEYS_PER_THREAD;
+        int key = k * STRESS_THREADS + args->id;
+        switch (xorshift32(&rng) % 3) {
+            case 0:
+                assert(hs_insert(args->set, thread, key) == !args->present[k]);
+                args->present[k] = 1;
+                break;
+            case 1: {
+                int removed = hs_remove(args->set, thread, key);
+                assert(removed == args->present[k]);
+                args->removed += removed;
+                args->present[k] = 0;
+                break;
+            }
+            default:
+                assert(hs_contains(args->set, thread, key) == args->present[k]);
+        }
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+// the writers only use keys >= 0: the odd negative keys stay in the set, the even ones stay out
+static void* stable_reader(void* arg) {
+    StressArgs* args = (StressArgs*)arg;
+    ErThread* thread = er_register(args->set->domain);
+    for (int i = 0; i < STRESS_OPS; i++) {
+        int k = i % STRESS_KEYS_PER_THREAD;
+        assert(hs_contains(args->set, thread, -1 - 2 * k));   // inserted before the start
+        assert(!hs_contains(args->set, thread, -2 - 2 * k));  // never inserted
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+void test_hs_disjoint_keys_match_sequential_model() {
+    print_test_func_name();
+
+    for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+        HarrisSet* set = hs_create(mode);
+        ErThread* main_thread = er_register(set->domain);
+        for (int k = 0; k < STRESS_KEYS_PER_THREAD; k++) hs_insert(set, main_thread, -1 - 2 * k);
+
+        pthread_t ids[STRESS_THREADS + 2];
+        StressArgs* args = (StressArgs*)calloc(STRESS_THREADS + 2, sizeof(*args));
+        for (int t = 0; t < STRESS_THREADS + 2; t++) {
+            args[t].set = set;
+            args[t].id = t;
+            pthread_create(&ids[t], NULL, t < STRESS_THREADS ? disjoint_worker : stable_reader, &args[t]);
+        }
+        for (int t = 0; t < STRESS_THREADS + 2; t++) pthread_join(ids[t], NULL);
+
+        int size = STRESS_KEYS_PER_THREAD;
+        long removed = 0;
+        for (int t = 0; t < STRESS_THREADS; t++) {
+            removed += args[t].removed;
+            for (int k = 0; k < STRESS_KEYS_PER_THREAD; k++) {
+                assert(hs_contains(set, main_thread, k * STRESS_THREADS + t) == args[t].present[k]);
+                size += args[t].present[k];
+            }
+        }
+        assert_strictly_sorted(set, size);
+
+        // every removed node is retired exactly once, by the thread whose CAS unlinked it
+        ErStats stats = er_stats(set->domain);
+        assert(stats.retired == removed && stats.freed <= stats.retired);
+        er_drain(set->domain);
+        stats = er_stats(set->domain);
+        assert(stats.pending == 0 && stats.freed == removed);
+
+        free(args);
+        er_unregister(main_thread);
+        hs_destroy(set);
+    }
+    passed();
+}
+
+#define SHARED_KEYS 16
+
+typedef struct SharedArgs {
+    HarrisSet* set;
+    int id;
+    _Atomic long* balance;  // successful inserts - successful removes, per key
+} SharedArgs;
+
+static void* shared_worker(void* arg) {
+    SharedArgs* args = (SharedArgs*)arg;
+    ErThread* thread = er_register(args->set->domain);
+    unsigned rng = 77 + args->id;
+    for (int i = 0; i < STRESS_OPS; i++) {
+        int key = xorshift32(&rng) % SHARED_KEYS;
+        if (xorshift32(&rng) % 2) {
+            if (hs_insert(args->set, thread, key)) atomic_fetch_add(&args->balance[key], 1);
+        } else {
+            if (hs_remove(args->set, thread, key)) atomic_fetch_sub(&args->balance[key], 1);
+        }
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+void test_hs_shared_keys_alternate() {
+    print_test_func_name();
+
+    for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+        HarrisSet* set = hs_create(mode);
+        _Atomic long balance[SHARED_KEYS];
+        for (int k = 0; k < SHARED_KEYS; k++) atomic_init(&balance[k], 0);
+
+        pthread_t ids[STRESS_THREADS];
+        SharedArgs args[STRESS_THREADS];
+        for (int t = 0; t < STRESS_THREADS; t++) {
+            args[t] = (SharedArgs){set, t, balance};
+            pthread_create(&ids[t], NULL, shared_worker, &args[t]);
+        }
+        for (int t = 0; t < STRESS_THREADS; t++) pthread_join(ids[t], NULL);
+
+        ErThread* thread = er_register(set->domain);
+        int size = 0;
+        for (int k = 0; k < SHARED_KEYS; k++) {
+            long b = atomic_load(&balance[k]);
+            assert(b == 0 || b == 1);
+            assert(hs_contains(set, thread, k) == b);
+            size += b;
+        }
+        assert_strictly_sorted(set, size);
+
+        er_unregister(thread);
+        hs_destroy(set);
+    }
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_KEY_RANGE 1024
+#define BENCH_OPS_PER_THREAD 500000
+
+typedef struct MutexSet {
+    Node* head;  // sentinel of a sorted list
+    pthread_mutex_t lock;
+} MutexSet;
+
+int mutex_set_contains(MutexSet* set, int key) {
+    pthread_mutex_lock(&set->lock);
+    Node* n = set->head->next;
+    while (n != NULL && n->data < key) n = n->next;
+    int found = n != NULL && n->data == key;
+    pthread_mutex_unlock(&set->lock);
+    return found;
+}
+
+int mutex_set_insert(MutexSet* set, int key) {
+    pthread_mutex_lock(&set->lock);
+    Node* prev = set->head;
+    while (prev->next != NULL && prev->next->data < key) prev = prev->next;
+    int inserted = prev->next == NULL || prev->next->data != key;
+    if (inserted) {
+        Node* node = create_node(key);
+        node->next = prev->next;
+        prev->next = node;
+    }
+    pthread_mutex_unlock(&set->lock);
+    return inserted;
+}
+
+int mutex_set_remove(MutexSet* set, int key) {
+    pthread_mutex_lock(&set->lock);
+    Node* prev = set->head;
+    while (prev->next != NULL && prev->next->data < key) prev = prev->next;
+    Node* victim = prev->next != NULL && prev->next->data == key ? prev->next : NULL;
+    int removed = victim != NULL;
+    if (removed) prev->next = victim->next;
+    pthread_mutex_unlock(&set->lock);
+    free(victim);
+    return removed;
+}
+
+typedef struct BenchArgs {
+    HarrisSet* set;
+    MutexSet* mutex_set;
+    int read_percent;  // the rest is split evenly between insert and remove
+    unsigned seed;
+} BenchArgs;
+
+static void* bench_hs_worker(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    ErThread* thread = er_register(args->set->domain);
+    unsigned rng = args->seed;
+    for (int i = 0; i < BENCH_OPS_PER_THREAD; i++) {
+        int key = xorshift32(&rng) % BENCH_KEY_RANGE;
+        int op = xorshift32(&rng) % 100;
+        if (op < args->read_percent)
+            hs_contains(args->set, thread, key);
+        else if (op % 2)
+            hs_insert(args->set, thread, key);
+        else
+            hs_remove(args->set, thread, key);
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+static void* bench_mutex_worker(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    unsigned rng = args->seed;
+    for (int i = 0; i < BENCH_OPS_PER_THREAD; i++) {
+        int key = xorshift32(&rng) % BENCH_KEY_RANGE;
+        int op = xorshift32(&rng) % 100;
+        if (op < args->read_percent)
+            mutex_set_contains(args->mutex_set, key);
+        else if (op % 2)
+            mutex_set_insert(args->mutex_set, key);
+        else
+            mutex_set_remove(args->mutex_set, key);
+    }
+    return NULL;
+}
+
+static long long run_bench(void* (*worker)(void*), BenchArgs args[], int threads) {
+    pthread_t ids[16];
+    long long start = now_ns();
+    for (int t = 0; t < threads; t++) pthread_create(&ids[t], NULL, worker, &args[t]);
+    for (int t = 0; t < threads; t++) pthread_join(ids[t], NULL);
+    return now_ns() - start;
+}
+
+// ns per operation over all threads, the sets start half full
+void bench_hs_vs_mutex() {
+    print_test_func_name();
+
+    printf("online cores: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    int read_percents[] = {90, 0};
+    char label[64];
+    for (int mix = 0; mix < 2; mix++) {
+        for (int threads = 1; threads <= 8; threads *= 2) {
+            long long total = (long long)threads * BENCH_OPS_PER_THREAD;
+            BenchArgs args[16];
+            for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+                HarrisSet* set = hs_create(mode);
+                ErThread* thread = er_register(set->domain);
+                for (int key = 0; key < BENCH_KEY_RANGE; key += 2) hs_insert(set, thread, key);
+                er_unregister(thread);
+
+                for (int t = 0; t < threads; t++) args[t] = (BenchArgs){set, NULL, read_percents[mix], 1 + t};
+                long long ns = run_bench(bench_hs_worker, args, threads);
+                snprintf(label, sizeof(label), "%d%% reads threads=%d harris %s", read_percents[mix], threads,
+                         mode_name(mode));
+                print_bench_result(label, ns, total);
+                hs_destroy(set);
+            }
+
+            MutexSet mutex_set = {create_node(0), PTHREAD_MUTEX_INITIALIZER};
+            for (int key = 0; key < BENCH_KEY_RANGE; key += 2) mutex_set_insert(&mutex_set, key);
+            for (int t = 0; t < threads; t++) args[t] = (BenchArgs){NULL, &mutex_set, read_percents[mix], 1 + t};
+            long long ns = run_bench(bench_mutex_worker, args, threads);
+            snprintf(label, sizeof(label), "%d%% reads threads=%d mutex", read_percents[mix], threads);
+            print_bench_result(label, ns, total);
+            free_all(mutex_set.head);
+        }
+    }
+}
+
+// harness cases: the sets hold the even keys below size, set up once per size; the calls run on one thread
+static const int BENCH_SIZES[] = {1000, 10000, 100000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    HarrisSet* sets[2];  // indexed by ErMode
+    ErThread* threads[2];
+    MutexSet mutex_set;
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    bench_common_init(&state->common);
+    int last_even = (size - 1) & ~1;  // descending, so that every insert stops at the first node
+    for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+        state->sets[mode] = hs_create(mode);
+        state->threads[mode] = er_register(state->sets[mode]->domain);
+        for (int key = last_even; key >= 0; key -= 2) hs_insert(state->sets[mode], state->threads[mode], key);
+    }
+    state->mutex_set = (MutexSet){create_node(0), PTHREAD_MUTEX_INITIALIZER};
+    for (int key = last_even; key >= 0; key -= 2) mutex_set_insert(&state->mutex_set, key);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    for (ErMode mode = ER_EPOCH; mode <= ER_HAZARD; mode++) {
+        er_unregister(b->threads[mode]);
+        hs_destroy(b->sets[mode]);
+    }
+    free_all(b->mutex_set.head);
+    pthread_mutex_destroy(&b->mutex_set.lock);
+    free(b);
+}
+
+static long long bench_hs_contains(BenchState* b, ErMode mode, int size) {
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += hs_contains(b->sets[mode], b->threads[mode], key);
+    return 1;
+}
+
+static long long bench_hs_contains_epoch(void* state, int size) {
+    return bench_hs_contains((BenchState*)state, ER_EPOCH, size);
+}
+
+static long long bench_hs_contains_hazard(void* state, int size) {
+    return bench_hs_contains((BenchState*)state, ER_HAZARD, size);
+}
+
+// an odd key, so the set is the same afterwards
+static long long bench_hs_insert_and_remove(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size) | 1;
+    hs_insert(b->sets[ER_EPOCH], b->threads[ER_EPOCH], key);
+    hs_remove(b->sets[ER_EPOCH], b->threads[ER_EPOCH], key);
+    return 1;
+}
+
+static long long bench_mutex_contains(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    b->common.sink += mutex_set_contains(&b->mutex_set, key);
+    return 1;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"epoch hs_contains", bench_setup, NULL, bench_hs_contains_epoch, bench_teardown},
+    {"hazard hs_contains", bench_setup, NULL, bench_hs_contains_hazard, bench_teardown},
+    {"epoch hs_insert+hs_remove", bench_setup, NULL, bench_hs_insert_and_remove, bench_teardown},
+    {"mutex contains", bench_setup, NULL, bench_mutex_contains, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_hs_single_thread();
+        test_hs_disjoint_keys_match_sequential_model();
+        test_hs_shared_keys_alternate();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_hs_vs_mutex();
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+- a lock-free sorted set of ints (Harris) over the singly Node, behind a dummy head sentinel
+- removal is two steps: the low bit of the victim's next is set (logical delete, the linearization point),
+  then the victim is unlinked from its predecessor with a CAS; a marked next can never change again,
+  so an insert behind a logically deleted node fails its CAS and retries
+- hs_insert and hs_remove find their window (prev, cur) with hs_search, which unlinks every marked node on the way
+- unlinked nodes are retired to the set's reclamation domain (epoch_reclamation.h), every thread passes its ErThread
+- hs_contains never writes and never retries in epoch mode: one pass over at most every node, so it is wait-free
+  in hazard pointer mode a node may only be followed while its predecessor is unmarked, so it falls back to hs_search
+*/
+
+#ifndef LOCKFREE_SET
+#define LOCKFREE_SET
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "epoch_reclamation.h"
+#include "tricks/singly_linked_list.h"
+
+typedef struct HarrisSet {
+    Node* head;  // sentinel, never removed
+    ErDomain* domain;
+} HarrisSet;
+
+static inline Node* hs_mark(Node* node) {
+    return (Node*)((uintptr_t)node | 1);
+}
+
+static inline int hs_is_marked(Node* node) {
+    return ((uintptr_t)node & 1) != 0;
+}
+
+static inline Node* hs_unmark(Node* node) {
+    return (Node*)((uintptr_t)node & ~(uintptr_t)1);
+}
+
+static inline int hs_cas_next(Node* node, Node* expected, Node* desired) {
+    return __atomic_compare_exchange_n(&node->next, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static inline HarrisSet* hs_create(ErMode mode) {
+    HarrisSet* set = (HarrisSet*)malloc(sizeof(*set));
+    set->head = create_node(0);
+    set->domain = er_create(mode);
+    return set;
+}
+
+// no other thread may use the set anymore
+static inline void hs_destroy(HarrisSet* set) {
+    free_all(set->head);
+    er_destroy(set->domain);
+    free(set);
+}
+
+// returns the first unmarked node with data >= key (or NULL), *prev_out is its unmarked predecessor
+// both stay protected until the caller's er_exit; hazard slots: prev, cur and next rotate over 0..2
+static inline Node* hs_search(HarrisSet* set, ErThread* thread, int key, Node** prev_out) {
+retry:;
+    int prev_slot = 0, cur_slot = 1, next_slot = 2;
+    Node* prev = set->head;
+    Node* cur = (Node*)er_protect(thread, cur_slot, (void**)&prev->next);
+    for (;;) {
+        if (cur == NULL) break;
+
+        Node* next = (Node*)er_protect(thread, next_slot, (void**)&cur->next);
+        if (hs_is_marked(next)) {
+            // cur is logically deleted: unlink it, fails if prev got marked or changed meanwhile
+            if (!hs_cas_next(prev, cur, hs_unmark(next))) goto retry;
+            er_retire(thread, cur);
+            cur = hs_unmark(next);
+            int freed_slot = cur_slot;
+            cur_slot = next_slot;
+            next_slot = freed_slot;
+            continue;
+        }
+        if (cur->data >= key) break;
+
+        prev = cur;
+        cur = next;
+        int freed_slot = prev_slot;
+        prev_slot = cur_slot;
+        cur_slot = next_slot;
+        next_slot = freed_slot;
+    }
+    *prev_out = prev;
+    return cur;
+}
+
+// returns 1 if key was inserted, 0 if it was already there
+static inline int hs_insert(HarrisSet* set, ErThread* thread, int key) {
+    Node* node = create_node(key);
+    int inserted;
+    er_enter(thread);
+    for (;;) {
+        Node* prev;
+        Node* cur = hs_search(set, thread, key, &prev);
+        if (cur != NULL && cur->data == key) {
+            free(node);  // never published
+            inserted = 0;
+            break;
+        }
+
+        __atomic_store_n(&node->next, cur, __ATOMIC_RELAXED);
+        if (hs_cas_next(prev, cur, node)) {
+            inserted = 1;
+            break;
+        }
+    }
+    er_exit(thread);
+    return inserted;
+}
+
+// returns 1 if key was removed, 0 if it was not there
+static inline int hs_remove(HarrisSet* set, ErThread* thread, int key) {
+    int removed;
+    er_enter(thread);
+    for (;;) {
+        Node* prev;
+        Node* cur = hs_search(set, thread, key, &prev);
+        if (cur == NULL || cur->data != key) {
+            removed = 0;
+            break;
+        }
+
+        Node* next = __atomic_load_n(&cur->next, __ATOMIC_ACQUIRE);
+        if (hs_is_marked(next)) continue;  // someone else removed it first
+        if (!hs_cas_next(cur, next, hs_mark(next))) continue;
+
+        // logically deleted: unlink it here, or let a search do it if prev changed meanwhile
+        if (hs_cas_next(prev, cur, next))
+            er_retire(thread, cur);
+        else
+            hs_search(set, thread, key, &prev);
+        removed = 1;
+        break;
+    }
+    er_exit(thread);
+    return removed;
+}
+
+static inline int hs_contains(HarrisSet* set, ErThread* thread, int key) {
+    er_enter(thread);
+    Node* cur;
+    if (set->domain->mode == ER_HAZARD) {
+        Node* prev;
+        cur = hs_search(set, thread, key, &prev);
+    } else {
+        cur = hs_unmark(__atomic_load_n(&set->head->next, __ATOMIC_ACQUIRE));
+        while (cur != NULL && cur->data < key) cur = hs_unmark(__atomic_load_n(&cur->next, __ATOMIC_ACQUIRE));
+    }
+    int found = cur != NULL && cur->data == key && !hs_is_marked(__atomic_load_n(&cur->next, __ATOMIC_ACQUIRE));
+    er_exit(thread);
+    return found;
+}
+
+#endif
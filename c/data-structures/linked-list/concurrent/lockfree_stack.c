@@ -0,0 +1,334 @@
+/*
+- tests and benchmarks of lockfree_stack.h
+- the stress test keeps popping and pushing back the same few nodes, which is exactly the ABA pattern
+- the benchmark compares lf_push/lf_pop against the same stack behind a pthread mutex, over 1 to 16 threads; the
+  harness cases time the uncontended single-thread costs
+- Compile with -pthread
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "lockfree_stack.h"
+#include "test_helper.h"
+
+typedef struct MutexStack {
+    Node* head;
+    pthread_mutex_t lock;
+} MutexStack;
+
+void mutex_push(MutexStack* stack, Node* node) {
+    pthread_mutex_lock(&stack->lock);
+    node->next = stack->head;
+    stack->head = node;
+    pthread_mutex_unlock(&stack->lock);
+}
+
+Node* mutex_pop(MutexStack* stack) {
+    pthread_mutex_lock(&stack->lock);
+    Node* node = stack->head;
+    if (node != NULL) stack->head = node->next;
+    pthread_mutex_unlock(&stack->lock);
+    return node;
+}
+
+void test_lf_push_pop() {
+    print_test_func_name();
+
+    LfStack stack;
+    lf_stack_init(&stack);
+    assert(lf_pop(&stack) == NULL);
+    assert(lf_is_empty(&stack));
+
+    for (int i = 0; i < 5; i++) lf_push(&stack, create_node(i));
+    for (int i = 4; i >= 0; i--) {
+        Node* node = lf_pop(&stack);
+        assert(node->data == i);
+        free(node);
+    }
+    assert(lf_pop(&stack) == NULL);
+
+    passed();
+}
+
+void test_lf_pop_all() {
+    print_test_func_name();
+
+    LfStack stack;
+    lf_stack_init(&stack);
+    assert(lf_pop_all(&stack) == NULL);
+
+    for (int i = 0; i < 3; i++) lf_push(&stack, create_node(i));
+    Node* head = lf_pop_all(&stack);
+    assert(head->data == 2 && head->next->data == 1 && head->next->next->data == 0);
+    assert(head->next->next->next == NULL);
+    assert(lf_is_empty(&stack));
+
+    lf_push(&stack, create_node(7));  // still usable afterwards
+    Node* node = lf_pop(&stack);
+    assert(node->data == 7 && lf_is_empty(&stack));
+
+    free(node);
+    free_all(head);
+    passed();
+}
+
+#define STRESS_THREADS 8
+#define STRESS_NODES 16  // few nodes, so the same addresses come back to the top all the time
+#define STRESS_ROUNDS 200000
+
+typedef struct StressArgs {
+    LfStack* stack;
+    _Atomic int* owners;  // owners[data] is set while a thread holds the node
+    long long popped;
+} StressArgs;
+
+static void* stress_worker(void* arg) {
+    StressArgs* args = (StressArgs*)arg;
+    for (int i = 0; i < STRESS_ROUNDS; i++) {
+        Node* node = lf_pop(args->stack);
+        if (node == NULL) continue;
+        // an ABA bug hands the same node to two threads at once
+        int was_owned = atomic_exchange(&args->owners[node->data], 1);
+        assert(!was_owned);
+        args->popped++;
+        atomic_store(&args->owners[node->data], 0);
+        lf_push(args->stack, node);
+    }
+    return NULL;
+}
+
+void test_lf_stack_stress() {
+    print_test_func_name();
+
+    LfStack stack;
+    lf_stack_init(&stack);
+    _Atomic int owners[STRESS_NODES];
+    for (int i = 0; i < STRESS_NODES; i++) {
+        atomic_init(&owners[i], 0);
+        lf_push(&stack, create_node(i));
+    }
+
+    pthread_t ids[STRESS_THREADS];
+    StressArgs args[STRESS_THREADS];
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        args[t] = (StressArgs){&stack, owners, 0};
+        pthread_create(&ids[t], NULL, stress_worker, &args[t]);
+    }
+    for (int t = 0; t < STRESS_THREADS; t++) pthread_join(ids[t], NULL);
+
+    // every node is back exactly once
+    int seen[STRESS_NODES] = {0};
+    int count = 0;
+    Node* head = lf_pop_all(&stack);
+    for (Node* n = head; n != NULL; n = n->next, count++) assert(seen[n->data]++ == 0);
+    assert(count == STRESS_NODES);
+
+    free_all(head);
+    passed();
+}
+
+#define DRAIN_PRODUCERS 4
+#define DRAIN_PER_PRODUCER 50000
+
+typedef struct DrainArgs {
+    LfStack* stack;
+    int first;
+} DrainArgs;
+
+static void* drain_producer(void* arg) {
+    DrainArgs* args = (DrainArgs*)arg;
+    for (int i = 0; i < DRAIN_PER_PRODUCER; i++) lf_push(args->stack, create_node(args->first + i));
+    return NULL;
+}
+
+// producers push unique values while the consumer takes batches with lf_pop_all: nothing is lost or duplicated
+void test_lf_pop_all_concurrent() {
+    print_test_func_name();
+
+    enum { TOTAL = DRAIN_PRODUCERS * DRAIN_PER_PRODUCER };
+    LfStack stack;
+    lf_stack_init(&stack);
+    char* seen = (char*)calloc(TOTAL, 1);
+
+    pthread_t ids[DRAIN_PRODUCERS];
+    DrainArgs args[DRAIN_PRODUCERS];
+    for (int t = 0; t < DRAIN_PRODUCERS; t++) {
+        args[t] = (DrainArgs){&stack, t * DRAIN_PER_PRODUCER};
+        pthread_create(&ids[t], NULL, drain_producer, &args[t]);
+    }
+
+    int count = 0;
+    while (count < TOTAL) {
+        Node* head = lf_pop_all(&stack);
+        for (Node* n = head; n != NULL; n = n->next, count++) assert(seen[n->data]++ == 0);
+        free_all(head);
+    }
+    for (int t = 0; t < DRAIN_PRODUCERS; t++) pthread_join(ids[t], NULL);
+    assert(lf_is_empty(&stack));
+
+    free(seen);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_OPS_PER_THREAD 1000000
+
+#define BENCH_NODES_PER_THREAD 64
+
+typedef struct BenchArgs {
+    LfStack* lf_stack;
+    MutexStack* mutex_stack;
+    Node* nodes;  // this thread's share of the nodes, on the stack before the run starts
+} BenchArgs;
+
+// pops first and pushes back what it popped, like the stress test: a node belongs to one thread between the two
+// calls, so it is never on the stack twice; each thread holds at most one node, so the pop never finds it empty
+static void* bench_lf_worker(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    for (int i = 0; i < BENCH_OPS_PER_THREAD; i++) {
+        Node* node = lf_pop(args->lf_stack);
+        if (node != NULL) lf_push(args->lf_stack, node);
+    }
+    return NULL;
+}
+
+static void* bench_mutex_worker(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    for (int i = 0; i < BENCH_OPS_PER_THREAD; i++) {
+        Node* node = mutex_pop(args->mutex_stack);
+        if (node != NULL) mutex_push(args->mutex_stack, node);
+    }
+    return NULL;
+}
+
+static long long run_bench(void* (*worker)(void*), BenchArgs args[], int threads) {
+    pthread_t ids[16];
+    long long start = now_ns();
+    for (int t = 0; t < threads; t++) pthread_create(&ids[t], NULL, worker, &args[t]);
+    for (int t = 0; t < threads; t++) pthread_join(ids[t], NULL);
+    return now_ns() - start;
+}
+
+// ns per push+pop pair over all threads, lower is better; single-core machines only show the uncontended cost
+void bench_lf_stack_vs_mutex() {
+    print_test_func_name();
+
+    printf("online cores: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    char label[64];
+    for (int threads = 1; threads <= 16; threads *= 2) {
+        LfStack lf_stack;
+        lf_stack_init(&lf_stack);
+        MutexStack mutex_stack = {NULL, PTHREAD_MUTEX_INITIALIZER};
+        BenchArgs args[16];
+        for (int t = 0; t < threads; t++) {
+            args[t] = (BenchArgs){&lf_stack, &mutex_stack, (Node*)calloc(BENCH_NODES_PER_THREAD, sizeof(Node))};
+            for (int i = 0; i < BENCH_NODES_PER_THREAD; i++) lf_push(&lf_stack, &args[t].nodes[i]);
+        }
+        long long lf_ns = run_bench(bench_lf_worker, args, threads);
+
+        // every node is back exactly once, then the same nodes go to the mutex stack
+        int count = 0;
+        for (Node* n = lf_pop_all(&lf_stack); n != NULL; n = n->next) count++;
+        assert(count == threads * BENCH_NODES_PER_THREAD);
+        for (int t = 0; t < threads; t++) {
+            for (int i = 0; i < BENCH_NODES_PER_THREAD; i++) mutex_push(&mutex_stack, &args[t].nodes[i]);
+        }
+        long long mutex_ns = run_bench(bench_mutex_worker, args, threads);
+        snprintf(label, sizeof(label), "threads=%d lf_push+lf_pop", threads);
+        print_bench_result(label, lf_ns, (long long)threads * BENCH_OPS_PER_THREAD);
+        snprintf(label, sizeof(label), "threads=%d mutex push+pop", threads);
+        print_bench_result(label, mutex_ns, (long long)threads * BENCH_OPS_PER_THREAD);
+
+        for (int t = 0; t < threads; t++) free(args[t].nodes);
+    }
+}
+
+// harness cases: size nodes are pushed on each stack once per size, the calls run on one thread
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    Node* nodes;
+    LfStack lf_stack;
+    MutexStack mutex_stack;
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->nodes = (Node*)calloc(2 * (size_t)size, sizeof(Node));  // a node is on one stack only
+    lf_stack_init(&state->lf_stack);
+    state->mutex_stack = (MutexStack){NULL, PTHREAD_MUTEX_INITIALIZER};
+    for (int i = 0; i < size; i++) {
+        lf_push(&state->lf_stack, &state->nodes[i]);
+        mutex_push(&state->mutex_stack, &state->nodes[size + i]);
+    }
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    pthread_mutex_destroy(&b->mutex_stack.lock);
+    free(b->nodes);
+    free(b);
+}
+
+static long long bench_lf_pop_and_push(void* state, int size) {
+    (void)size;
+    BenchState* b = (BenchState*)state;
+    lf_push(&b->lf_stack, lf_pop(&b->lf_stack));
+    return 1;
+}
+
+static long long bench_mutex_pop_and_push(void* state, int size) {
+    (void)size;
+    BenchState* b = (BenchState*)state;
+    mutex_push(&b->mutex_stack, mutex_pop(&b->mutex_stack));
+    return 1;
+}
+
+// one op per node: one lf_pop_all, then every node is pushed back one by one
+static long long bench_lf_pop_all_and_push(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    Node* n = lf_pop_all(&b->lf_stack);
+    while (n != NULL) {
+        Node* next = n->next;
+        lf_push(&b->lf_stack, n);
+        n = next;
+    }
+    return size;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"lf_pop+lf_push (1 thread)", bench_setup, NULL, bench_lf_pop_and_push, bench_teardown},
+    {"mutex pop+push (1 thread)", bench_setup, NULL, bench_mutex_pop_and_push, bench_teardown},
+    {"lf_pop_all+lf_push (per node)", bench_setup, NULL, bench_lf_pop_all_and_push, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_lf_push_pop();
+        test_lf_pop_all();
+        test_lf_stack_stress();
+        test_lf_pop_all_concurrent();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_lf_stack_vs_mutex();
+    }
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+- a lock-free Treiber stack over the singly Node: prepend_and_swap_ptr made thread-safe with C11 atomics
+- lf_push and lf_pop swing `top` with a compare-and-swap, lf_pop_all detaches the whole list in one atomic step
+- ABA: a pop that reads top == A and A->next == B must not succeed if A was popped and pushed back meanwhile
+  (B may be gone), so `top` carries a 16-bit tag in the unused upper bits of the pointer, bumped on every update
+- x86-64 and AArch64 user space pointers fit in 48 bits; the tag only repeats after 65536 updates in one CAS window
+- lf_pop reads node->next of a node another thread may have popped already: popped nodes may be reused
+  (pushed again) at any time, but must not be freed while other threads can still pop from the stack
+*/
+
+#ifndef LOCKFREE_STACK
+#define LOCKFREE_STACK
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "tricks/singly_linked_list.h"
+
+#define LF_TAG_SHIFT 48
+#define LF_PTR_MASK ((UINT64_C(1) << LF_TAG_SHIFT) - 1)
+
+static_assert(sizeof(void*) == 8, "lockfree_stack.h packs a tag into the upper 16 bits of a 64-bit pointer");
+
+typedef struct LfStack {
+    _Atomic uint64_t top;  // tag << LF_TAG_SHIFT | pointer
+} LfStack;
+
+static inline Node* lf_ptr(uint64_t word) {
+    return (Node*)(uintptr_t)(word & LF_PTR_MASK);
+}
+
+// the tag wraps around silently, it is shifted out of the 64-bit word
+static inline uint64_t lf_next_word(uint64_t word, Node* node) {
+    return ((word >> LF_TAG_SHIFT) + 1) << LF_TAG_SHIFT | (uint64_t)(uintptr_t)node;
+}
+
+static inline void lf_stack_init(LfStack* stack) {
+    atomic_init(&stack->top, 0);
+}
+
+static inline int lf_is_empty(LfStack* stack) {
+    return lf_ptr(atomic_load_explicit(&stack->top, memory_order_acquire)) == NULL;
+}
+
+static inline void lf_push(LfStack* stack, Node* node) {
+    uint64_t top = atomic_load_explicit(&stack->top, memory_order_relaxed);
+    do {
+        __atomic_store_n(&node->next, lf_ptr(top), __ATOMIC_RELAXED);
+    } while (!atomic_compare_exchange_weak_explicit(&stack->top, &top, lf_next_word(top, node), memory_order_release,
+                                                    memory_order_relaxed));
+}
+
+// returns NULL if the stack is empty
+static inline Node* lf_pop(LfStack* stack) {
+    uint64_t top = atomic_load_explicit(&stack->top, memory_order_acquire);
+    for (;;) {
+        Node* node = lf_ptr(top);
+        if (node == NULL) return NULL;
+
+        // may be stale if node was popped meanwhile, the tag then makes the CAS fail
+        Node* next = __atomic_load_n(&node->next, __ATOMIC_RELAXED);
+        if (atomic_compare_exchange_weak_explicit(&stack->top, &top, lf_next_word(top, next), memory_order_acquire,
+                                                  memory_order_acquire)) {
+            return node;
+        }
+    }
+}
+
+// takes every node at once, newest first; a plain exchange would reset the tag, so it is a CAS that keeps it
+static inline Node* lf_pop_all(LfStack* stack) {
+    uint64_t top = atomic_load_explicit(&stack->top, memory_order_acquire);
+    while (lf_ptr(top) != NULL &&
+           !atomic_compare_exchange_weak_explicit(&stack->top, &top, lf_next_word(top, NULL), memory_order_acquire,
+                                                  memory_order_acquire)) {
+    }
+    return lf_ptr(top);
+}
+
+#endif
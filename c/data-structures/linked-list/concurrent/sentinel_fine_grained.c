@@ -0,0 +1,322 @@
+/*
+- tests and benchmarks of sentinel_fine_grained.h
+- the stress test mixes inserts and deletes at random positions from many threads, then checks that the next and
+  prev chains still mirror each other and that the length matches the successful operations
+- the benchmark compares it with the same list behind one pthread mutex as the thread count grows; the harness
+  cases time the uncontended single-thread costs
+- Compile with -pthread
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "sentinel_fine_grained.h"
+#include "test_helper.h"
+
+static inline unsigned xorshift32(unsigned* state) {
+    unsigned x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// walks both directions, returns the number of real nodes
+static int assert_consistent(FgList* list) {
+    int count = 0;
+    FgNode* n = list->dummy_head;
+    while (n->next != NULL) {
+        assert(n->next->prev == n);
+        assert(!n->deleted && n->lock == 0);
+        n = n->next;
+        count++;
+    }
+    assert(n == list->dummy_tail);
+    assert(count - 1 == fg_length(list));
+    return count - 1;
+}
+
+void test_fg_single_thread() {
+    print_test_func_name();
+
+    FgList* list = fg_create();
+    ErThread* thread = er_register(list->domain);
+    er_enter(thread);
+
+    assert(fg_find_kth(list, 0) == NULL);
+    for (int i = 1; i <= 3; i++) fg_append(list, fg_create_node(i));
+    fg_prepend(list, fg_create_node(0));  // 0 1 2 3
+    FgNode* two = fg_search(list, 2);
+    assert(fg_insert_after(list, two, fg_create_node(20)));
+    assert(fg_insert_before(list, two, fg_create_node(15)));  // 0 1 15 2 20 3
+
+    int expected[] = {0, 1, 15, 2, 20, 3};
+    for (int k = 0; k < 6; k++) assert(fg_find_kth(list, k)->data == expected[k]);
+    assert(fg_find_kth(list, 6) == NULL);
+    assert(assert_consistent(list) == 6);
+
+    assert(fg_delete_node(list, thread, two));
+    assert(fg_search(list, 2) == NULL);
+    assert(fg_find_kth(list, 3)->data == 20);
+    // two is retired but not freed while we are inside the operation: late calls on it fail
+    assert(fg_delete_node(list, thread, two) == 0);
+    FgNode* orphan = fg_create_node(99);
+    assert(fg_insert_after(list, two, orphan) == 0);
+    assert(fg_insert_before(list, two, orphan) == 0);
+    free(orphan);
+    assert(assert_consistent(list) == 5);
+
+    er_exit(thread);
+    er_unregister(thread);
+    fg_destroy(list);
+    passed();
+}
+
+#define STRESS_THREADS 8
+#define STRESS_OPS 20000
+#define STRESS_INITIAL 64
+
+typedef struct StressArgs {
+    FgList* list;
+    unsigned seed;
+    int inserted;
+    int deleted;
+} StressArgs;
+
+static void* stress_worker(void* arg) {
+    StressArgs* args = (StressArgs*)arg;
+    ErThread* thread = er_register(args->list->domain);
+    for (int i = 0; i < STRESS_OPS; i++) {
+        er_enter(thread);
+        int length = fg_length(args->list);
+        FgNode* node = fg_find_kth(args->list, length > 0 ? xorshift32(&args->seed) % length : 0);
+        if (node == NULL) {
+            fg_append(args->list, fg_create_node(i));
+            args->inserted++;
+        } else if (xorshift32(&args->seed) % 2) {
+            FgNode* new_node = fg_create_node(i);
+            int ok = xorshift32(&args->seed) % 2 ? fg_insert_after(args->list, node, new_node)
+                                                 : fg_insert_before(args->list, node, new_node);
+            if (ok)
+                args->inserted++;
+            else
+                free(new_node);  // node was deleted meanwhile
+        } else {
+            args->deleted += fg_delete_node(args->list, thread, node);
+        }
+        er_exit(thread);
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+void test_fg_stress() {
+    print_test_func_name();
+
+    FgList* list = fg_create();
+    for (int i = 0; i < STRESS_INITIAL; i++) fg_append(list, fg_create_node(i));
+
+    pthread_t ids[STRESS_THREADS];
+    StressArgs args[STRESS_THREADS];
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        args[t] = (StressArgs){list, 1 + t, 0, 0};
+        pthread_create(&ids[t], NULL, stress_worker, &args[t]);
+    }
+    for (int t = 0; t < STRESS_THREADS; t++) pthread_join(ids[t], NULL);
+
+    int expected = STRESS_INITIAL;
+    for (int t = 0; t < STRESS_THREADS; t++) expected += args[t].inserted - args[t].deleted;
+    assert(assert_consistent(list) == expected);
+
+    fg_destroy(list);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_LIST_SIZE 1000
+#define BENCH_OPS_PER_THREAD 20000
+
+// the baseline: the same nodes and operations, every call under one mutex
+typedef struct GlobalLockList {
+    FgList* list;
+    pthread_mutex_t lock;
+} GlobalLockList;
+
+typedef struct BenchArgs {
+    FgList* list;
+    GlobalLockList* global;
+    unsigned seed;
+} BenchArgs;
+
+// every op finds a random position and inserts after it or deletes it, so the size stays around its start
+static void* bench_fg_worker(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    ErThread* thread = er_register(args->list->domain);
+    for (int i = 0; i < BENCH_OPS_PER_THREAD; i++) {
+        er_enter(thread);
+        FgNode* node = fg_find_kth(args->list, xorshift32(&args->seed) % BENCH_LIST_SIZE);
+        if (node != NULL) {
+            if (xorshift32(&args->seed) % 2) {
+                FgNode* new_node = fg_create_node(i);
+                if (!fg_insert_after(args->list, node, new_node)) free(new_node);
+            } else {
+                fg_delete_node(args->list, thread, node);
+            }
+        }
+        er_exit(thread);
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+static void* bench_global_worker(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    FgList* list = args->global->list;
+    for (int i = 0; i < BENCH_OPS_PER_THREAD; i++) {
+        pthread_mutex_lock(&args->global->lock);
+        FgNode* node = fg_find_kth(list, xorshift32(&args->seed) % BENCH_LIST_SIZE);
+        if (node != NULL) {
+            if (xorshift32(&args->seed) % 2) {
+                FgNode* new_node = fg_create_node(i);
+                new_node->prev = node;
+                new_node->next = node->next;
+                node->next->prev = new_node;
+                node->next = new_node;
+                list->size++;
+            } else {
+                node->prev->next = node->next;
+                node->next->prev = node->prev;
+                list->size--;
+                free(node);
+            }
+        }
+        pthread_mutex_unlock(&args->global->lock);
+    }
+    return NULL;
+}
+
+static long long run_bench(void* (*worker)(void*), BenchArgs args[], int threads) {
+    pthread_t ids[16];
+    long long start = now_ns();
+    for (int t = 0; t < threads; t++) pthread_create(&ids[t], NULL, worker, &args[t]);
+    for (int t = 0; t < threads; t++) pthread_join(ids[t], NULL);
+    return now_ns() - start;
+}
+
+// ns per operation over all threads: find_kth plus an insert_after or a delete_node
+void bench_fg_vs_global_lock() {
+    print_test_func_name();
+
+    printf("online cores: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    char label[64];
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        FgList* list = fg_create();
+        GlobalLockList global = {fg_create(), PTHREAD_MUTEX_INITIALIZER};
+        for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+            fg_append(list, fg_create_node(i));
+            fg_append(global.list, fg_create_node(i));
+        }
+
+        BenchArgs args[16];
+        for (int t = 0; t < threads; t++) args[t] = (BenchArgs){list, &global, 1 + t};
+        long long total = (long long)threads * BENCH_OPS_PER_THREAD;
+
+        long long ns = run_bench(bench_fg_worker, args, threads);
+        snprintf(label, sizeof(label), "threads=%d per-node locks", threads);
+        print_bench_result(label, ns, total);
+
+        for (int t = 0; t < threads; t++) args[t].seed = 1 + t;
+        ns = run_bench(bench_global_worker, args, threads);
+        snprintf(label, sizeof(label), "threads=%d global mutex", threads);
+        print_bench_result(label, ns, total);
+
+        fg_destroy(list);
+        fg_destroy(global.list);
+    }
+}
+
+// harness cases: an FgList of 0..size-1 is built once per size, the calls run on one thread
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    FgList* list;
+    ErThread* thread;
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    bench_common_init(&state->common);
+    state->list = fg_create();
+    for (int i = 0; i < size; i++) fg_append(state->list, fg_create_node(i));
+    state->thread = er_register(state->list->domain);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    er_unregister(b->thread);
+    fg_destroy(b->list);
+    free(b);
+}
+
+static long long bench_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    er_enter(b->thread);
+    b->common.sink += fg_search(b->list, key)->data;
+    er_exit(b->thread);
+    return 1;
+}
+
+static long long bench_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int k = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    er_enter(b->thread);
+    b->common.sink += fg_find_kth(b->list, k)->data;
+    er_exit(b->thread);
+    return 1;
+}
+
+// the length stays the same; the deleted head goes through er_retire
+static long long bench_append_and_delete_head(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    er_enter(b->thread);
+    fg_append(b->list, fg_create_node(size));
+    fg_delete_node(b->list, b->thread, fg_next(b->list->dummy_head));
+    er_exit(b->thread);
+    return 1;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"fg_search", bench_setup, NULL, bench_search, bench_teardown},
+    {"fg_find_kth", bench_setup, NULL, bench_find_kth, bench_teardown},
+    {"fg_append+fg_delete_node(head)", bench_setup, NULL, bench_append_and_delete_head, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_fg_single_thread();
+        test_fg_stress();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_fg_vs_global_lock();
+    }
+
+    return 0;
+}
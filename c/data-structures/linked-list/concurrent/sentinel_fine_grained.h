@@ -0,0 +1,200 @@
+/*
+- a thread-safe version of 1_doubly_linked_list_sentinel.c with one spinlock per node instead of one list mutex
+- insert_after locks node and node->next, delete_node locks prev, node and next: writers on different parts of
+  the list never meet, and thanks to the sentinels every real node always has both neighbours to lock
+- locks are always taken from left to right, so two writers can never wait for each other in a cycle
+- the left neighbour is read before it is locked and re-checked afterwards (it may have changed meanwhile)
+- a deleted node is flagged under its lock, so an insert_after or delete_node that arrives late fails (returns 0)
+- readers (search, find_kth) take no lock: they follow next with acquire loads and skip flagged nodes;
+  a deleted node keeps its next, so a reader standing on it can always go on
+- deleted nodes are retired to the list's epoch domain (epoch_reclamation.h): the caller wraps every sequence of
+  calls whose nodes it holds in er_enter/er_exit, the fg_* functions do not enter by themselves
+- epoch mode only: the readers do not publish hazard pointers
+*/
+
+#ifndef SENTINEL_FINE_GRAINED
+#define SENTINEL_FINE_GRAINED
+
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "epoch_reclamation.h"
+
+#define FG_SPINS_BEFORE_YIELD 64
+
+typedef struct FgNode {
+    int data;
+    struct FgNode* prev;
+    struct FgNode* next;
+    _Atomic int lock;
+    _Atomic int deleted;
+} FgNode;
+
+typedef struct FgList {
+    FgNode* dummy_head;
+    FgNode* dummy_tail;
+    _Atomic int size;
+    ErDomain* domain;
+} FgList;
+
+static inline void fg_lock(FgNode* node) {
+    for (int spins = 0;; spins++) {
+        if (atomic_load_explicit(&node->lock, memory_order_relaxed) == 0 &&
+            atomic_exchange_explicit(&node->lock, 1, memory_order_acquire) == 0) {
+            return;
+        }
+        if (spins >= FG_SPINS_BEFORE_YIELD) sched_yield();  // the holder may be preempted
+    }
+}
+
+static inline void fg_unlock(FgNode* node) {
+    atomic_store_explicit(&node->lock, 0, memory_order_release);
+}
+
+static inline FgNode* fg_next(FgNode* node) {
+    return __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+}
+
+static inline FgNode* fg_prev(FgNode* node) {
+    return __atomic_load_n(&node->prev, __ATOMIC_ACQUIRE);
+}
+
+static inline int fg_is_deleted(FgNode* node) {
+    return atomic_load_explicit(&node->deleted, memory_order_acquire);
+}
+
+static inline FgNode* fg_create_node(int data) {
+    FgNode* node = (FgNode*)malloc(sizeof(*node));
+    node->data = data;
+    node->prev = NULL;
+    node->next = NULL;
+    atomic_init(&node->lock, 0);
+    atomic_init(&node->deleted, 0);
+    return node;
+}
+
+static inline FgList* fg_create(void) {
+    FgList* list = (FgList*)malloc(sizeof(*list));
+    list->dummy_head = fg_create_node(0);
+    list->dummy_tail = fg_create_node(0);
+    list->dummy_head->next = list->dummy_tail;
+    list->dummy_tail->prev = list->dummy_head;
+    atomic_init(&list->size, 0);
+    list->domain = er_create(ER_EPOCH);
+    return list;
+}
+
+// no other thread may use the list anymore
+static inline void fg_destroy(FgList* list) {
+    FgNode* node = list->dummy_head;
+    while (node != NULL) {
+        FgNode* next = node->next;
+        free(node);
+        node = next;
+    }
+    er_destroy(list->domain);
+    free(list);
+}
+
+static inline int fg_length(FgList* list) {
+    return atomic_load_explicit(&list->size, memory_order_relaxed);
+}
+
+// both neighbours are locked by the caller
+static inline void fg_link(FgList* list, FgNode* left, FgNode* right, FgNode* new_node) {
+    new_node->prev = left;
+    new_node->next = right;
+    __atomic_store_n(&right->prev, new_node, __ATOMIC_RELEASE);
+    __atomic_store_n(&left->next, new_node, __ATOMIC_RELEASE);  // publishes the initialized node to readers
+    atomic_fetch_add_explicit(&list->size, 1, memory_order_relaxed);
+}
+
+// assumes that node is NOT the dummy tail; returns 0 (new_node untouched) if node was deleted meanwhile
+static inline int fg_insert_after(FgList* list, FgNode* node, FgNode* new_node) {
+    fg_lock(node);
+    if (fg_is_deleted(node)) {
+        fg_unlock(node);
+        return 0;
+    }
+    FgNode* right = node->next;  // cannot change while node is locked
+    fg_lock(right);
+    fg_link(list, node, right, new_node);
+    fg_unlock(right);
+    fg_unlock(node);
+    return 1;
+}
+
+// locks node->prev and then node, re-reading prev until it is still the left neighbour once locked
+// returns NULL (nothing locked) if node is deleted
+static inline FgNode* fg_lock_left_of(FgNode* node) {
+    for (;;) {
+        FgNode* left = fg_prev(node);
+        fg_lock(left);
+        if (fg_next(left) == node && !fg_is_deleted(left)) {
+            fg_lock(node);
+            if (!fg_is_deleted(node)) return left;
+            fg_unlock(node);
+            fg_unlock(left);
+            return NULL;
+        }
+        fg_unlock(left);
+        if (fg_is_deleted(node)) return NULL;
+    }
+}
+
+// assumes that node is NOT the dummy head; returns 0 (new_node untouched) if node was deleted meanwhile
+static inline int fg_insert_before(FgList* list, FgNode* node, FgNode* new_node) {
+    FgNode* left = fg_lock_left_of(node);
+    if (left == NULL) return 0;
+    fg_link(list, left, node, new_node);
+    fg_unlock(node);
+    fg_unlock(left);
+    return 1;
+}
+
+static inline void fg_append(FgList* list, FgNode* new_node) {
+    fg_insert_before(list, list->dummy_tail, new_node);  // the sentinels are never deleted
+}
+
+static inline void fg_prepend(FgList* list, FgNode* new_node) {
+    fg_insert_after(list, list->dummy_head, new_node);
+}
+
+// assumes that node is NOT a sentinel node; returns 0 if another thread deleted it first
+static inline int fg_delete_node(FgList* list, ErThread* thread, FgNode* node) {
+    FgNode* left = fg_lock_left_of(node);
+    if (left == NULL) return 0;
+    FgNode* right = node->next;
+    fg_lock(right);
+
+    atomic_store_explicit(&node->deleted, 1, memory_order_release);
+    __atomic_store_n(&left->next, right, __ATOMIC_RELEASE);
+    __atomic_store_n(&right->prev, left, __ATOMIC_RELEASE);
+    atomic_fetch_sub_explicit(&list->size, 1, memory_order_relaxed);
+
+    fg_unlock(right);
+    fg_unlock(node);
+    fg_unlock(left);
+    er_retire(thread, node);
+    return 1;
+}
+
+// the first live node with data == key, NULL if none
+static inline FgNode* fg_search(FgList* list, int key) {
+    for (FgNode* n = fg_next(list->dummy_head); n != list->dummy_tail; n = fg_next(n)) {
+        if (n->data == key && !fg_is_deleted(n)) return n;
+    }
+    return NULL;
+}
+
+// k counts live real nodes from 0, NULL if the list is shorter
+static inline FgNode* fg_find_kth(FgList* list, int k) {
+    for (FgNode* n = fg_next(list->dummy_head); n != list->dummy_tail; n = fg_next(n)) {
+        if (fg_is_deleted(n)) continue;
+        if (k-- == 0) return n;
+    }
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,384 @@
+/*
+- tests and benchmarks of sentinel_rcu.h
+- the stress test runs readers against writers that keep inserting and deleting odd keys between even keys that
+  are never deleted: every reader must always find every even key, in order, and the final list must be consistent
+- the benchmark measures reader throughput from 1 thread up to all cores while one writer keeps inserting and
+  deleting, against the same list behind a pthread rwlock; the harness cases time the uncontended single-thread
+  costs
+- Compile with -pthread
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "sentinel_rcu.h"
+#include "test_helper.h"
+
+static inline unsigned xorshift32(unsigned* state) {
+    unsigned x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// walks both directions, returns the number of real nodes
+static int assert_consistent(RcuList* list) {
+    int count = 0;
+    RcuNode* n = list->dummy_head;
+    while (n->next != NULL) {
+        assert(n->next->prev == n);
+        assert(!n->deleted);
+        n = n->next;
+        count++;
+    }
+    assert(n == list->dummy_tail);
+    assert(count - 1 == rcu_length(list));
+    return count - 1;
+}
+
+void test_rcu_single_thread() {
+    print_test_func_name();
+
+    RcuList* list = rcu_create();
+    ErThread* thread = er_register(list->domain);
+    rcu_read_lock(thread);
+
+    assert(rcu_find_kth(list, 0) == NULL);
+    for (int i = 1; i <= 3; i++) rcu_append(list, rcu_create_node(i));
+    rcu_prepend(list, rcu_create_node(0));  // 0 1 2 3
+    RcuNode* two = rcu_search(list, 2);
+    assert(rcu_insert_after(list, two, rcu_create_node(20)));
+    assert(rcu_insert_before(list, two, rcu_create_node(15)));  // 0 1 15 2 20 3
+
+    int expected[] = {0, 1, 15, 2, 20, 3};
+    for (int k = 0; k < 6; k++) assert(rcu_find_kth(list, k)->data == expected[k]);
+    assert(rcu_find_kth(list, 6) == NULL);
+    assert(assert_consistent(list) == 6);
+
+    assert(rcu_delete_node(list, thread, two));
+    assert(rcu_search(list, 2) == NULL);
+    assert(rcu_next(two)->data == 20);  // a reader standing on two can go on
+    assert(rcu_delete_node(list, thread, two) == 0);
+    RcuNode* orphan = rcu_create_node(99);
+    assert(rcu_insert_after(list, two, orphan) == 0);
+    assert(rcu_insert_before(list, two, orphan) == 0);
+    free(orphan);
+    assert(assert_consistent(list) == 5);
+    rcu_read_unlock(thread);
+
+    // two is freed after the grace period, once no read-side section can see it
+    for (int i = 0; i < 3; i++) er_collect(thread);
+    assert(er_stats(list->domain).freed == 1);
+
+    er_unregister(thread);
+    rcu_destroy(list);
+    passed();
+}
+
+#define STRESS_READERS 6
+#define STRESS_WRITERS 2
+#define STRESS_PINNED 32
+#define STRESS_WRITER_OPS 20000
+
+typedef struct StressArgs {
+    RcuList* list;
+    _Atomic int* writers_done;
+    unsigned seed;
+    int inserted;
+    int deleted;
+} StressArgs;
+
+static void* stress_reader(void* arg) {
+    StressArgs* args = (StressArgs*)arg;
+    ErThread* thread = er_register(args->list->domain);
+    while (atomic_load(args->writers_done) < STRESS_WRITERS) {
+        rcu_read_lock(thread);
+        int next_pinned = 0;
+        for (RcuNode* n = rcu_next(args->list->dummy_head); n != args->list->dummy_tail; n = rcu_next(n)) {
+            if (n->data % 2 == 0) {
+                assert(n->data == next_pinned);
+                next_pinned += 2;
+            }
+        }
+        assert(next_pinned == 2 * STRESS_PINNED);
+        assert(rcu_search(args->list, 2 * (xorshift32(&args->seed) % STRESS_PINNED)) != NULL);
+        rcu_read_unlock(thread);
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+static void* stress_writer(void* arg) {
+    StressArgs* args = (StressArgs*)arg;
+    ErThread* thread = er_register(args->list->domain);
+    for (int i = 0; i < STRESS_WRITER_OPS; i++) {
+        rcu_read_lock(thread);
+        RcuNode* node = rcu_find_kth(args->list, xorshift32(&args->seed) % rcu_length(args->list));
+        if (node != NULL && node->data % 2 && xorshift32(&args->seed) % 2) {
+            args->deleted += rcu_delete_node(args->list, thread, node);
+        } else if (node != NULL) {
+            RcuNode* new_node = rcu_create_node(2 * i + 1);
+            if (rcu_insert_after(args->list, node, new_node))
+                args->inserted++;
+            else
+                free(new_node);  // node was deleted meanwhile
+        }
+        rcu_read_unlock(thread);
+    }
+    atomic_fetch_add(args->writers_done, 1);
+    er_unregister(thread);
+    return NULL;
+}
+
+void test_rcu_stress() {
+    print_test_func_name();
+
+    RcuList* list = rcu_create();
+    for (int i = 0; i < STRESS_PINNED; i++) rcu_append(list, rcu_create_node(2 * i));
+    _Atomic int writers_done = 0;
+
+    pthread_t ids[STRESS_READERS + STRESS_WRITERS];
+    StressArgs args[STRESS_READERS + STRESS_WRITERS];
+    for (int t = 0; t < STRESS_READERS + STRESS_WRITERS; t++) {
+        args[t] = (StressArgs){list, &writers_done, 1 + t, 0, 0};
+        pthread_create(&ids[t], NULL, t < STRESS_WRITERS ? stress_writer : stress_reader, &args[t]);
+    }
+    for (int t = 0; t < STRESS_READERS + STRESS_WRITERS; t++) pthread_join(ids[t], NULL);
+
+    int expected = STRESS_PINNED;
+    for (int t = 0; t < STRESS_WRITERS; t++) expected += args[t].inserted - args[t].deleted;
+    assert(assert_consistent(list) == expected);
+
+    rcu_destroy(list);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_LIST_SIZE 1000
+#define BENCH_READS_PER_THREAD 20000
+
+// the baseline: the same list, readers share a pthread rwlock with the writer
+typedef struct RwLockList {
+    RcuList* list;
+    pthread_rwlock_t lock;
+} RwLockList;
+
+typedef struct BenchArgs {
+    RcuList* list;
+    RwLockList* rw;
+    _Atomic int* stop;
+    unsigned seed;
+    long writes;
+} BenchArgs;
+
+static void* bench_rcu_reader(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    ErThread* thread = er_register(args->list->domain);
+    for (int i = 0; i < BENCH_READS_PER_THREAD; i++) {
+        rcu_read_lock(thread);
+        rcu_find_kth(args->list, xorshift32(&args->seed) % BENCH_LIST_SIZE);
+        rcu_read_unlock(thread);
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+// deletes a random node and inserts one in its place until the readers are done, the size stays the same
+static void* bench_rcu_writer(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    ErThread* thread = er_register(args->list->domain);
+    while (!atomic_load_explicit(args->stop, memory_order_relaxed)) {
+        rcu_read_lock(thread);
+        RcuNode* node = rcu_find_kth(args->list, xorshift32(&args->seed) % BENCH_LIST_SIZE);
+        rcu_insert_after(args->list, node, rcu_create_node(node->data));
+        rcu_delete_node(args->list, thread, node);
+        rcu_read_unlock(thread);
+        args->writes++;
+    }
+    er_unregister(thread);
+    return NULL;
+}
+
+static void* bench_rw_reader(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    for (int i = 0; i < BENCH_READS_PER_THREAD; i++) {
+        pthread_rwlock_rdlock(&args->rw->lock);
+        rcu_find_kth(args->rw->list, xorshift32(&args->seed) % BENCH_LIST_SIZE);
+        pthread_rwlock_unlock(&args->rw->lock);
+    }
+    return NULL;
+}
+
+static void* bench_rw_writer(void* arg) {
+    BenchArgs* args = (BenchArgs*)arg;
+    while (!atomic_load_explicit(args->stop, memory_order_relaxed)) {
+        pthread_rwlock_wrlock(&args->rw->lock);
+        RcuNode* node = rcu_find_kth(args->rw->list, xorshift32(&args->seed) % BENCH_LIST_SIZE);
+        RcuNode* new_node = rcu_create_node(node->data);
+        new_node->prev = node->prev;
+        new_node->next = node->next;
+        node->prev->next = new_node;
+        node->next->prev = new_node;
+        free(node);
+        pthread_rwlock_unlock(&args->rw->lock);
+        args->writes++;
+    }
+    return NULL;
+}
+
+// runs readers with one writer in the background, returns the ns until the last reader is done
+static long long run_bench(void* (*reader)(void*), void* (*writer)(void*), BenchArgs args[], int readers) {
+    pthread_t ids[257];
+    atomic_store(args[0].stop, 0);
+    args[readers].writes = 0;
+    pthread_create(&ids[readers], NULL, writer, &args[readers]);
+
+    long long start = now_ns();
+    for (int t = 0; t < readers; t++) pthread_create(&ids[t], NULL, reader, &args[t]);
+    for (int t = 0; t < readers; t++) pthread_join(ids[t], NULL);
+    long long ns = now_ns() - start;
+
+    atomic_store(args[0].stop, 1);
+    pthread_join(ids[readers], NULL);
+    return ns;
+}
+
+static void bench_readers(RcuList* list, RwLockList* rw, long readers) {
+    _Atomic int stop;
+    BenchArgs args[257];
+    char label[64];
+    for (int t = 0; t <= readers; t++) args[t] = (BenchArgs){list, rw, &stop, 1 + t, 0};
+    long long total = readers * BENCH_READS_PER_THREAD;
+
+    long long ns = run_bench(bench_rcu_reader, bench_rcu_writer, args, readers);
+    snprintf(label, sizeof(label), "readers=%ld rcu (%ld writes)", readers, args[readers].writes);
+    print_bench_result(label, ns, total);
+
+    for (int t = 0; t <= readers; t++) args[t].seed = 1 + t;
+    ns = run_bench(bench_rw_reader, bench_rw_writer, args, readers);
+    snprintf(label, sizeof(label), "readers=%ld rwlock (%ld writes)", readers, args[readers].writes);
+    print_bench_result(label, ns, total);
+}
+
+// ns per find_kth over all readers (lower is better scaling), one writer replaces nodes meanwhile
+// readers double up to the number of online cores (at least 2, at most 256)
+void bench_rcu_reader_scaling() {
+    print_test_func_name();
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("online cores: %ld\n", cores);
+    RcuList* list = rcu_create();
+    RwLockList rw = {rcu_create(), PTHREAD_RWLOCK_INITIALIZER};
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+        rcu_append(list, rcu_create_node(i));
+        rcu_append(rw.list, rcu_create_node(i));
+    }
+
+    long max_readers = cores < 2 ? 2 : cores > 256 ? 256 : cores;
+    long readers = 1;
+    for (; readers < max_readers; readers *= 2) bench_readers(list, &rw, readers);
+    bench_readers(list, &rw, max_readers);
+
+    rcu_destroy(list);
+    rcu_destroy(rw.list);
+}
+
+// harness cases: an RcuList of 0..size-1 is built once per size, the calls run on one thread
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    RcuList* list;
+    ErThread* thread;
+    pthread_rwlock_t lock;  // for the rwlock baseline, which reads the same list
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    bench_common_init(&state->common);
+    state->list = rcu_create();
+    for (int i = 0; i < size; i++) rcu_append(state->list, rcu_create_node(i));
+    state->thread = er_register(state->list->domain);
+    pthread_rwlock_init(&state->lock, NULL);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    er_unregister(b->thread);
+    rcu_destroy(b->list);
+    pthread_rwlock_destroy(&b->lock);
+    free(b);
+}
+
+static long long bench_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int key = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    rcu_read_lock(b->thread);
+    b->common.sink += rcu_search(b->list, key)->data;
+    rcu_read_unlock(b->thread);
+    return 1;
+}
+
+static long long bench_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int k = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    rcu_read_lock(b->thread);
+    b->common.sink += rcu_find_kth(b->list, k)->data;
+    rcu_read_unlock(b->thread);
+    return 1;
+}
+
+static long long bench_rwlock_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int k = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+    pthread_rwlock_rdlock(&b->lock);
+    b->common.sink += rcu_find_kth(b->list, k)->data;
+    pthread_rwlock_unlock(&b->lock);
+    return 1;
+}
+
+// the length stays the same; the deleted head goes through er_retire
+static long long bench_append_and_delete_head(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    rcu_read_lock(b->thread);
+    rcu_append(b->list, rcu_create_node(size));
+    rcu_delete_node(b->list, b->thread, rcu_next(b->list->dummy_head));
+    rcu_read_unlock(b->thread);
+    return 1;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"rcu_search", bench_setup, NULL, bench_search, bench_teardown},
+    {"rcu_find_kth", bench_setup, NULL, bench_find_kth, bench_teardown},
+    {"rwlock find_kth", bench_setup, NULL, bench_rwlock_find_kth, bench_teardown},
+    {"rcu_append+rcu_delete_node(head)", bench_setup, NULL, bench_append_and_delete_head, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_rcu_single_thread();
+        test_rcu_stress();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_rcu_reader_scaling();
+    }
+
+    return 0;
+}
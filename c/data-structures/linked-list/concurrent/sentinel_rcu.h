@@ -0,0 +1,167 @@
+/*
+- an RCU-style version of 1_doubly_linked_list_sentinel.c for read-mostly use: readers never lock and never write
+  shared memory, writers take turns on one mutex
+- readers (search, find_kth) follow next with acquire loads only; a read-side section is rcu_read_lock /
+  rcu_read_unlock on the qsbr mode of epoch_reclamation.h: rcu_read_lock does nothing and rcu_read_unlock
+  announces a quiescent state, an acquire load of the global epoch and a release store to the reader's own
+  ErThread (its own cache line). No RMW and no fence per section, nothing is shared between readers; the one RMW
+  of a reader is er_register
+- the price of qsbr: a registered thread counts as reading until its next rcu_read_unlock, so a thread that stops
+  reading must er_unregister, or no deleted node is freed anymore; read-side sections do not nest
+- writers initialize a new node completely and publish it with one release store to left->next, so a reader sees
+  either the old list or the new node with its fields set
+- a deleted node is unlinked but keeps its next, so a reader standing on it can go on; it is retired to the list's
+  epoch domain (epoch_reclamation.h) and freed after a grace period: once every registered thread has passed
+  rcu_read_unlock twice since (or unregistered)
+- a writer passes nodes it found by reading, so it calls the writer functions inside its own read-side section;
+  a node that another writer deleted meanwhile is detected under the mutex (returns 0)
+- prev is for writers only: readers see it in an intermediate state while a writer works
+*/
+
+#ifndef SENTINEL_RCU
+#define SENTINEL_RCU
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "epoch_reclamation.h"
+
+typedef struct RcuNode {
+    int data;
+    struct RcuNode* prev;
+    struct RcuNode* next;
+    int deleted;  // guarded by the writer mutex
+} RcuNode;
+
+typedef struct RcuList {
+    RcuNode* dummy_head;
+    RcuNode* dummy_tail;
+    _Atomic int size;
+    pthread_mutex_t writer_lock;
+    ErDomain* domain;
+} RcuList;
+
+static inline RcuNode* rcu_create_node(int data) {
+    RcuNode* node = (RcuNode*)malloc(sizeof(*node));
+    node->data = data;
+    node->prev = NULL;
+    node->next = NULL;
+    node->deleted = 0;
+    return node;
+}
+
+static inline RcuList* rcu_create(void) {
+    RcuList* list = (RcuList*)malloc(sizeof(*list));
+    list->dummy_head = rcu_create_node(0);
+    list->dummy_tail = rcu_create_node(0);
+    list->dummy_head->next = list->dummy_tail;
+    list->dummy_tail->prev = list->dummy_head;
+    atomic_init(&list->size, 0);
+    pthread_mutex_init(&list->writer_lock, NULL);
+    list->domain = er_create(ER_QSBR);
+    return list;
+}
+
+// no other thread may use the list anymore
+static inline void rcu_destroy(RcuList* list) {
+    RcuNode* node = list->dummy_head;
+    while (node != NULL) {
+        RcuNode* next = node->next;
+        free(node);
+        node = next;
+    }
+    pthread_mutex_destroy(&list->writer_lock);
+    er_destroy(list->domain);
+    free(list);
+}
+
+// does nothing in qsbr mode, it marks where the reader starts to hold references
+static inline void rcu_read_lock(ErThread* thread) {
+    er_enter(thread);
+}
+
+// a quiescent state: the reader holds no reference from this section anymore
+static inline void rcu_read_unlock(ErThread* thread) {
+    er_exit(thread);
+}
+
+static inline RcuNode* rcu_next(RcuNode* node) {
+    return __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+}
+
+static inline int rcu_length(RcuList* list) {
+    return atomic_load_explicit(&list->size, memory_order_relaxed);
+}
+
+// the writer lock is held
+static inline void rcu_link(RcuList* list, RcuNode* left, RcuNode* new_node) {
+    RcuNode* right = left->next;
+    new_node->prev = left;
+    new_node->next = right;
+    right->prev = new_node;
+    __atomic_store_n(&left->next, new_node, __ATOMIC_RELEASE);  // publishes the initialized node to readers
+    atomic_fetch_add_explicit(&list->size, 1, memory_order_relaxed);
+}
+
+// assumes that node is NOT the dummy tail; returns 0 (new_node untouched) if node was deleted meanwhile
+static inline int rcu_insert_after(RcuList* list, RcuNode* node, RcuNode* new_node) {
+    pthread_mutex_lock(&list->writer_lock);
+    int ok = !node->deleted;
+    if (ok) rcu_link(list, node, new_node);
+    pthread_mutex_unlock(&list->writer_lock);
+    return ok;
+}
+
+// assumes that node is NOT the dummy head; returns 0 (new_node untouched) if node was deleted meanwhile
+static inline int rcu_insert_before(RcuList* list, RcuNode* node, RcuNode* new_node) {
+    pthread_mutex_lock(&list->writer_lock);
+    int ok = !node->deleted;
+    if (ok) rcu_link(list, node->prev, new_node);
+    pthread_mutex_unlock(&list->writer_lock);
+    return ok;
+}
+
+static inline void rcu_append(RcuList* list, RcuNode* new_node) {
+    rcu_insert_before(list, list->dummy_tail, new_node);  // the sentinels are never deleted
+}
+
+static inline void rcu_prepend(RcuList* list, RcuNode* new_node) {
+    rcu_insert_after(list, list->dummy_head, new_node);
+}
+
+// assumes that node is NOT a sentinel node; returns 0 if another writer deleted it first
+// the node is freed after a grace period, readers may still be standing on it
+static inline int rcu_delete_node(RcuList* list, ErThread* thread, RcuNode* node) {
+    pthread_mutex_lock(&list->writer_lock);
+    if (node->deleted) {
+        pthread_mutex_unlock(&list->writer_lock);
+        return 0;
+    }
+    node->deleted = 1;
+    node->next->prev = node->prev;
+    __atomic_store_n(&node->prev->next, node->next, __ATOMIC_RELEASE);
+    atomic_fetch_sub_explicit(&list->size, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&list->writer_lock);
+
+    er_retire(thread, node);
+    return 1;
+}
+
+// the first node with data == key, NULL if none; call inside a read-side section
+static inline RcuNode* rcu_search(RcuList* list, int key) {
+    for (RcuNode* n = rcu_next(list->dummy_head); n != list->dummy_tail; n = rcu_next(n)) {
+        if (n->data == key) return n;
+    }
+    return NULL;
+}
+
+// k counts real nodes from 0, NULL if the list is shorter; call inside a read-side section
+static inline RcuNode* rcu_find_kth(RcuList* list, int k) {
+    for (RcuNode* n = rcu_next(list->dummy_head); n != list->dummy_tail; n = rcu_next(n)) {
+        if (k-- == 0) return n;
+    }
+    return NULL;
+}
+
+#endif
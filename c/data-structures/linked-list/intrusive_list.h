@@ -0,0 +1,229 @@
+/*
+- intrusive versions of 1_doubly_linked_list.c (dlink_*) and 1_doubly_linked_list_sentinel.c (dlist_*)
+- the caller embeds a DLink in its own struct and gets the struct back with container_of, so a record and its
+  links are one allocation and one cache miss, and any payload type works without a second pointer
+- the lists never allocate or free: the caller owns the records
+- dlink_*: NULL ends the list on both sides, functions that may change the head return it
+- dlist_*: the DList handle embeds both sentinels and the size, so it must not be copied or moved once initialized
+- merges take a cmp(a, b) that returns <= 0 when a goes first; it is a compile-time constant at every call site,
+  so the compiler inlines it
+- the intrusive singly list (SLink) is in tricks/singly_linked_list.h
+*/
+
+#ifndef INTRUSIVE_LIST
+#define INTRUSIVE_LIST
+
+#include <stddef.h>
+
+#ifndef container_of
+#define container_of(ptr, type, member) ((type*)((char*)(ptr) - offsetof(type, member)))
+#endif
+
+typedef struct DLink {
+    struct DLink* prev;
+    struct DLink* next;
+} DLink;
+
+typedef int (*DLinkCmp)(const DLink*, const DLink*);
+
+#define dlink_entry_or_null(link, type, member) ((link) != NULL ? container_of((link), type, member) : NULL)
+
+// link must not be unlinked inside the loop
+#define dlink_foreach(link, head) for (DLink* link = (head); link != NULL; link = link->next)
+
+#define dlink_foreach_entry(entry, head, type, member) \
+    for (type* entry = dlink_entry_or_null((head), type, member); entry != NULL; \
+         entry = dlink_entry_or_null(entry->member.next, type, member))
+
+static inline void dlink_insert_after(DLink* link, DLink* new_link) {
+    new_link->prev = link;
+    new_link->next = link->next;
+    if (link->next != NULL) link->next->prev = new_link;
+    link->next = new_link;
+}
+
+// returns the new head
+static inline DLink* dlink_delete(DLink* head, DLink* link) {
+    if (link->next != NULL) link->next->prev = link->prev;
+    if (link->prev == NULL) return link->next;
+    link->prev->next = link->next;
+    return head;
+}
+
+// inserts the chain first..last (linked in both directions) after link: O(1)
+static inline void dlink_splice_after(DLink* link, DLink* first, DLink* last) {
+    last->next = link->next;
+    if (link->next != NULL) link->next->prev = last;
+    first->prev = link;
+    link->next = first;
+}
+
+// stable, ties are taken from head1 first
+static inline DLink* dlink_merge_two_sorted(DLink* head1, DLink* head2, DLinkCmp cmp) {
+    DLink sentinel = {NULL, NULL};
+
+    DLink* n = &sentinel;
+    while (head1 && head2) {
+        DLink** taken = cmp(head1, head2) <= 0 ? &head1 : &head2;
+        n->next = *taken;
+        (*taken)->prev = n;
+        *taken = (*taken)->next;
+        n = n->next;
+    }
+
+    n->next = head1 ? head1 : head2;
+    if (n->next != NULL) n->next->prev = n;
+    if (sentinel.next != NULL) sentinel.next->prev = NULL;
+
+    return sentinel.next;
+}
+
+// reverses the links s to k inclusive (1-indexed) in one pass, returns the new head
+static inline DLink* dlink_reverse_sublist(DLink* head, int s, int k) {
+    DLink sentinel = {NULL, head};
+    if (head != NULL) head->prev = &sentinel;
+    DLink* s_link_prev = &sentinel;
+    for (int i = 1; i < s; i++) s_link_prev = s_link_prev->next;
+
+    DLink* sublist_tail = s_link_prev->next;  // the s-th link will become the tail
+    DLink* sec = sublist_tail;
+    DLink* sublist_head = NULL;
+    for (int i = s; i <= k; i++) {
+        DLink* next_sec = sec->next;
+        sec->next = sublist_head;
+        if (sublist_head != NULL) sublist_head->prev = sec;
+        sublist_head = sec;
+        sec = next_sec;
+    }
+
+    s_link_prev->next = sublist_head;
+    sublist_head->prev = s_link_prev;
+    sublist_tail->next = sec;  // sec is the (k+1)-th link
+    if (sec != NULL) sec->prev = sublist_tail;
+
+    if (sentinel.next != NULL) sentinel.next->prev = NULL;
+    return sentinel.next;
+}
+
+// the sentinel version: an empty list is dummy_head <-> dummy_tail, every real link has both neighbours
+typedef struct DList {
+    DLink dummy_head;
+    DLink dummy_tail;
+    int size;
+} DList;
+
+#define dlist_foreach(link, list) \
+    for (DLink* link = (list)->dummy_head.next; link != &(list)->dummy_tail; link = link->next)
+
+#define dlist_foreach_entry(entry, list, type, member) \
+    for (type* entry = container_of((list)->dummy_head.next, type, member); \
+         &entry->member != &(list)->dummy_tail; entry = container_of(entry->member.next, type, member))
+
+static inline void dlist_init(DList* list) {
+    list->dummy_head.prev = NULL;
+    list->dummy_head.next = &list->dummy_tail;
+    list->dummy_tail.prev = &list->dummy_head;
+    list->dummy_tail.next = NULL;
+    list->size = 0;
+}
+
+static inline int dlist_length(const DList* list) {
+    return list->size;
+}
+
+// NULL if the list is empty
+static inline DLink* dlist_first(DList* list) {
+    return list->size > 0 ? list->dummy_head.next : NULL;
+}
+
+static inline DLink* dlist_last(DList* list) {
+    return list->size > 0 ? list->dummy_tail.prev : NULL;
+}
+
+// assumes that link is NOT the dummy tail
+static inline void dlist_insert_after(DList* list, DLink* link, DLink* new_link) {
+    new_link->prev = link;
+    new_link->next = link->next;
+    link->next->prev = new_link;
+    link->next = new_link;
+    list->size++;
+}
+
+static inline void dlist_append(DList* list, DLink* new_link) {
+    dlist_insert_after(list, list->dummy_tail.prev, new_link);
+}
+
+static inline void dlist_prepend(DList* list, DLink* new_link) {
+    dlist_insert_after(list, &list->dummy_head, new_link);
+}
+
+// assumes that link is NOT a sentinel
+static inline void dlist_delete(DList* list, DLink* link) {
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    list->size--;
+}
+
+// k counts real links from 0, NULL if the list is shorter
+static inline DLink* dlist_find_kth(DList* list, int k) {
+    if (k < 0 || k >= list->size) return NULL;
+    DLink* n = list->dummy_head.next;
+    for (int i = 0; i < k; i++) n = n->next;
+    return n;
+}
+
+// moves every link of other after link (which belongs to list), other is left empty: O(1)
+static inline void dlist_splice_after(DList* list, DLink* link, DList* other) {
+    if (other->size == 0) return;
+    dlink_splice_after(link, other->dummy_head.next, other->dummy_tail.prev);
+    list->size += other->size;
+    dlist_init(other);
+}
+
+// detaches the real links as a NULL-terminated dlink chain, list is left empty
+static inline DLink* dlist_detach(DList* list) {
+    if (list->size == 0) return NULL;
+    DLink* head = list->dummy_head.next;
+    head->prev = NULL;
+    list->dummy_tail.prev->next = NULL;
+    dlist_init(list);
+    return head;
+}
+
+// puts a NULL-terminated dlink chain of size links back between the sentinels of an empty list
+static inline void dlist_attach(DList* list, DLink* head, int size) {
+    if (head == NULL) return;
+    DLink* tail = head;
+    while (tail->next != NULL) tail = tail->next;
+    dlink_splice_after(&list->dummy_head, head, tail);
+    list->size = size;
+}
+
+// both lists sorted by cmp; moves every link of other into list, stable, other is left empty
+static inline void dlist_merge(DList* list, DList* other, DLinkCmp cmp) {
+    int size = list->size + other->size;
+    DLink* head = dlink_merge_two_sorted(dlist_detach(list), dlist_detach(other), cmp);
+    dlist_attach(list, head, size);
+}
+
+// reverses the real links s to k inclusive (1-indexed): O(k), the sentinels are the neighbours
+static inline void dlist_reverse_sublist(DList* list, int s, int k) {
+    DLink* before = s == 1 ? &list->dummy_head : dlist_find_kth(list, s - 2);
+    DLink* sublist_tail = before->next;
+    DLink* sec = sublist_tail;
+    DLink* sublist_head = NULL;
+    for (int i = s; i <= k; i++) {
+        DLink* next_sec = sec->next;
+        sec->next = sublist_head;
+        if (sublist_head != NULL) sublist_head->prev = sec;
+        sublist_head = sec;
+        sec = next_sec;
+    }
+
+    before->next = sublist_head;
+    sublist_head->prev = before;
+    sublist_tail->next = sec;  // sec is the (k+1)-th link or the dummy tail
+    sec->prev = sublist_tail;
+}
+
+#endif
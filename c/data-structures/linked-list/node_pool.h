@@ -0,0 +1,90 @@
+/*
+- a fixed-size node allocator: nodes are carved out of large slabs instead of one malloc per node
+- freed nodes are kept on an intrusive free list (a free node stores the pointer to the next free node)
+- pool_alloc_node and pool_free_node are O(1) and never touch malloc unless a new slab is needed
+- pool_destroy releases every node of the pool in O(slabs), so a list that owns its pool is freed without walking it
+- the pool only knows the node size, so every list variant (singly, doubly, sentinel) can share this header
+*/
+
+#ifndef NODE_POOL
+#define NODE_POOL
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#define POOL_DEFAULT_NODES_PER_SLAB 1024
+
+typedef struct PoolFreeNode {
+    struct PoolFreeNode* next;
+} PoolFreeNode;
+
+// the union pads the header so that the nodes following it are suitably aligned
+typedef union PoolSlab {
+    union PoolSlab* next;
+    max_align_t align;
+} PoolSlab;
+
+typedef struct NodePool {
+    size_t node_size;
+    size_t nodes_per_slab;
+    size_t slab_used;  // nodes handed out from the newest slab (the head of slabs)
+    size_t slab_count;
+    PoolSlab* slabs;
+    PoolFreeNode* free_list;
+} NodePool;
+
+static inline NodePool* pool_create(size_t node_size, size_t nodes_per_slab) {
+    NodePool* pool = (NodePool*)malloc(sizeof(*pool));
+    if (pool == NULL) return NULL;
+
+    // a free node must be able to hold the free list pointer, and every node must stay pointer aligned
+    if (node_size < sizeof(PoolFreeNode)) node_size = sizeof(PoolFreeNode);
+    node_size = (node_size + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+
+    pool->node_size = node_size;
+    pool->nodes_per_slab = nodes_per_slab > 0 ? nodes_per_slab : POOL_DEFAULT_NODES_PER_SLAB;
+    pool->slab_used = pool->nodes_per_slab;  // forces a slab allocation on the first pool_alloc_node
+    pool->slab_count = 0;
+    pool->slabs = NULL;
+    pool->free_list = NULL;
+    return pool;
+}
+
+static inline void* pool_alloc_node(NodePool* pool) {
+    if (pool->free_list != NULL) {  // recycle a freed node first: it is likely still in cache
+        PoolFreeNode* node = pool->free_list;
+        pool->free_list = node->next;
+        return node;
+    }
+
+    if (pool->slab_used == pool->nodes_per_slab) {
+        PoolSlab* slab = (PoolSlab*)malloc(sizeof(PoolSlab) + pool->node_size * pool->nodes_per_slab);
+        if (slab == NULL) return NULL;
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pool->slab_used = 0;
+        pool->slab_count++;
+    }
+
+    char* nodes = (char*)(pool->slabs + 1);
+    return nodes + pool->node_size * pool->slab_used++;
+}
+
+static inline void pool_free_node(NodePool* pool, void* node) {
+    PoolFreeNode* free_node = (PoolFreeNode*)node;
+    free_node->next = pool->free_list;
+    pool->free_list = free_node;
+}
+
+// releases all nodes ever allocated from the pool, whether or not they were freed: O(slabs)
+static inline void pool_destroy(NodePool* pool) {
+    PoolSlab* slab = pool->slabs;
+    while (slab != NULL) {
+        PoolSlab* next_slab = slab->next;
+        free(slab);
+        slab = next_slab;
+    }
+    free(pool);
+}
+
+#endif
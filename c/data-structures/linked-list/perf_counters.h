@@ -0,0 +1,172 @@
+/*
+- hardware counters around benchmarked code, through Linux perf_event_open: cycles, instructions, L1d read misses,
+  LLC read misses, dTLB read misses, branch misses, plus the page faults (a software event)
+- every counter is opened on its own for this thread (user space only), so one that the CPU or the kernel does not
+  offer does not take the others down; when the kernel multiplexes them the values are scaled by enabled/running
+- an unavailable counter keeps fd -1 and reads as -1: containers, VMs without a PMU and perf_event_paranoid > 2
+  usually leave only the page faults, other systems than Linux leave nothing
+- perf_counters_enable/disable are an ioctl per counter, keep them outside the timed region
+- test_helper.h includes this file, the harness collects the counters with --bench-counters
+- syscall is not in ISO C: a file that includes this header (also through test_helper.h) defines _DEFAULT_SOURCE
+  before its first #include, so that -std=c11 builds declare it
+*/
+
+#ifndef PERF_COUNTERS
+#define PERF_COUNTERS
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+typedef enum PerfCounterId {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_PAGE_FAULTS,
+    PERF_COUNTER_COUNT
+} PerfCounterId;
+
+static const char* const PERF_COUNTER_NAMES[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses", "page_faults",
+};
+
+typedef struct PerfCounters {
+    int fds[PERF_COUNTER_COUNT];  // -1: unavailable
+    int open_errno;               // of the first counter that could not be opened, 0 if all opened
+} PerfCounters;
+
+#ifdef __linux__
+
+#define PERF_CACHE_READ_MISS(cache) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static inline int perf_event_open_counter(PerfCounterId id) {
+    static const struct {
+        unsigned type;
+        unsigned long long config;
+    } events[PERF_COUNTER_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, PERF_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D)},
+        {PERF_TYPE_HW_CACHE, PERF_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL)},
+        {PERF_TYPE_HW_CACHE, PERF_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_DTLB)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    };
+
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = events[id].type;
+    attr.config = events[id].config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);  // this thread, any CPU
+}
+
+// returns the number of counters that could be opened
+static inline int perf_counters_open(PerfCounters* counters) {
+    int opened = 0;
+    counters->open_errno = 0;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        counters->fds[i] = perf_event_open_counter((PerfCounterId)i);
+        if (counters->fds[i] >= 0)
+            opened++;
+        else if (counters->open_errno == 0)
+            counters->open_errno = errno;
+    }
+    return opened;
+}
+
+static inline void perf_counters_close(PerfCounters* counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0) close(counters->fds[i]);
+        counters->fds[i] = -1;
+    }
+}
+
+static inline void perf_counters_reset(PerfCounters* counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0) ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+    }
+}
+
+static inline void perf_counters_enable(PerfCounters* counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0) ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+static inline void perf_counters_disable(PerfCounters* counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0) ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+}
+
+// totals since the last reset, -1 for the unavailable counters
+static inline void perf_counters_read(const PerfCounters* counters, double values[PERF_COUNTER_COUNT]) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        unsigned long long data[3];  // value, time enabled, time running
+        values[i] = -1;
+        if (counters->fds[i] < 0 || read(counters->fds[i], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+        values[i] = (double)data[0];
+        if (data[2] > 0 && data[2] < data[1]) values[i] *= (double)data[1] / (double)data[2];
+    }
+}
+
+#else
+
+static inline int perf_counters_open(PerfCounters* counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) counters->fds[i] = -1;
+    counters->open_errno = 0;
+    return 0;
+}
+
+static inline void perf_counters_close(PerfCounters* counters) {
+    (void)counters;
+}
+
+static inline void perf_counters_reset(PerfCounters* counters) {
+    (void)counters;
+}
+
+static inline void perf_counters_enable(PerfCounters* counters) {
+    (void)counters;
+}
+
+static inline void perf_counters_disable(PerfCounters* counters) {
+    (void)counters;
+}
+
+static inline void perf_counters_read(const PerfCounters* counters, double values[PERF_COUNTER_COUNT]) {
+    (void)counters;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) values[i] = -1;
+}
+
+#endif
+
+// one line of per-op averages, n/a for the unavailable counters
+static inline void perf_counters_print(const char* name, const double values[PERF_COUNTER_COUNT], long long ops) {
+    printf("%-36s", name);
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (values[i] < 0)
+            printf(" %s n/a", PERF_COUNTER_NAMES[i]);
+        else
+            printf(" %s %.2f", PERF_COUNTER_NAMES[i], values[i] / (double)ops);
+    }
+    printf("\n");
+}
+
+#endif
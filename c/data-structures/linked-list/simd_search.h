@@ -0,0 +1,145 @@
+/*
+- vectorized equality search over a contiguous run of ints (e.g. the block of an unrolled list node)
+- SSE2 compares 4 ints per instruction, AVX2 compares 8, anything else falls back to a scalar loop
+- the implementation is picked at runtime from CPUID, so one binary runs on every x86-64 machine; CPUID runs once,
+  the level is cached
+- every kernel returns exactly what the scalar loop returns: the index of the FIRST match or -1
+*/
+
+#ifndef SIMD_SEARCH
+#define SIMD_SEARCH
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_SEARCH_X86
+#endif
+
+typedef enum SimdLevel {
+    SIMD_SCALAR = 0,
+    SIMD_SSE2 = 1,
+    SIMD_AVX2 = 2,
+} SimdLevel;
+
+typedef int (*SimdFindFn)(const int* a, int n, int key);
+typedef int (*SimdCountFn)(const int* a, int n, int key);
+
+static inline int simd_find_scalar(const int* a, int n, int key) {
+    for (int i = 0; i < n; i++) {
+        if (a[i] == key) return i;
+    }
+    return -1;
+}
+
+static inline int simd_count_scalar(const int* a, int n, int key) {
+    int count = 0;
+    for (int i = 0; i < n; i++) count += a[i] == key;
+    return count;
+}
+
+#ifdef SIMD_SEARCH_X86
+__attribute__((target("sse2"))) static inline int simd_find_sse2(const int* a, int n, int key) {
+    __m128i needle = _mm_set1_epi32(key);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + i)), needle);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));  // one bit per lane
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    int rest = simd_find_scalar(a + i, n - i, key);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("sse2"))) static inline int simd_count_sse2(const int* a, int n, int key) {
+    __m128i needle = _mm_set1_epi32(key);
+    __m128i counts = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + i)), needle);
+        counts = _mm_sub_epi32(counts, eq);  // a matching lane is -1
+    }
+    int lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, counts);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + simd_count_scalar(a + i, n - i, key);
+}
+
+__attribute__((target("avx2"))) static inline int simd_find_avx2(const int* a, int n, int key) {
+    __m256i needle = _mm256_set1_epi32(key);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(a + i)), needle);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    int rest = simd_find_sse2(a + i, n - i, key);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("avx2"))) static inline int simd_count_avx2(const int* a, int n, int key) {
+    __m256i needle = _mm256_set1_epi32(key);
+    __m256i counts = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(a + i)), needle);
+        counts = _mm256_sub_epi32(counts, eq);
+    }
+    int lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, counts);
+    int count = 0;
+    for (int l = 0; l < 8; l++) count += lanes[l];
+    return count + simd_count_sse2(a + i, n - i, key);
+}
+#endif
+
+static inline SimdLevel simd_cpuid_level(void) {
+#ifdef SIMD_SEARCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+#endif
+    return SIMD_SCALAR;
+}
+
+// CPUID runs on the first call only, later calls are a load of the cached level
+static inline SimdLevel simd_detect_level(void) {
+    static int detected = -1;
+    if (detected < 0) detected = simd_cpuid_level();
+    return (SimdLevel)detected;
+}
+
+// levels the cpu does not support are lowered to the best supported one
+static inline SimdLevel simd_clamp_level(SimdLevel level) {
+    SimdLevel supported = simd_detect_level();
+    return level > supported ? supported : level;
+}
+
+static inline SimdFindFn simd_find_fn(SimdLevel level) {
+#ifdef SIMD_SEARCH_X86
+    switch (simd_clamp_level(level)) {
+        case SIMD_AVX2:
+            return simd_find_avx2;
+        case SIMD_SSE2:
+            return simd_find_sse2;
+        default:
+            break;
+    }
+#endif
+    (void)level;
+    return simd_find_scalar;
+}
+
+static inline SimdCountFn simd_count_fn(SimdLevel level) {
+#ifdef SIMD_SEARCH_X86
+    switch (simd_clamp_level(level)) {
+        case SIMD_AVX2:
+            return simd_count_avx2;
+        case SIMD_SSE2:
+            return simd_count_sse2;
+        default:
+            break;
+    }
+#endif
+    (void)level;
+    return simd_count_scalar;
+}
+
+#endif
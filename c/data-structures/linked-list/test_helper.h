@@ -1,16 +1,31 @@
 #ifndef TEST_HELPER
 #define TEST_HELPER
 
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#include "perf_counters.h"
 
 #define RUN_TESTS_FLAG_LONG "--test"
 #define RUN_TESTS_FLAG_SHORT "-t"
+#define RUN_BENCH_FLAG_LONG "--bench"
+#define RUN_BENCH_FLAG_SHORT "-b"
+#define BENCH_FORMAT_FLAG "--bench-format="
+#define BENCH_SIZES_FLAG "--bench-sizes="
+#define BENCH_REPS_FLAG "--bench-reps="
+#define BENCH_WARMUP_FLAG "--bench-warmup="
+#define BENCH_COUNTERS_FLAG "--bench-counters"
 
 #define print_test_func_name() printf("===== %s =====\n", __func__)
 
 #define passed() printf("PASSED\n");
 
+#define print_bench_result(name, total_ns, ops) \
+    printf("%-40s %12.2f ns/op\n", (name), (double)(total_ns) / (double)(ops))
+
 static inline int has_test_flag(int argc, char** argv) {
     for (int i = 0; i < argc; i++) {
         const char* arg = argv[i];
@@ -21,4 +36,306 @@ static inline int has_test_flag(int argc, char** argv) {
     return 0;
 }
 
+static inline int has_bench_flag(int argc, char** argv) {
+    for (int i = 0; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, RUN_BENCH_FLAG_LONG) == 0 || strcmp(arg, RUN_BENCH_FLAG_SHORT) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// monotonic clock in nanoseconds, for benchmarks (clock_gettime is POSIX: files define _POSIX_C_SOURCE first)
+static inline long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// a volatile store of a result of timed code, so that the compiler cannot drop the code (assert goes with -DNDEBUG)
+static volatile long long bench_sink;
+
+static inline void bench_keep(long long value) {
+    bench_sink = value;
+}
+
+/*
+- the benchmark harness: a file lists its BenchCases and calls bench_run when has_bench_flag is set
+- every case runs at every size: setup(size) builds the state once, then warmup untimed and repetitions timed calls
+  of run, each preceded by an untimed reset (when the case has one) so that runs which consume the list can rebuild it
+- run returns the number of operations it did; each repetition is one sample of ns/op, and the report gives the mean
+  ns/op, ops/sec, the p50/p99/p999 of the samples (nearest rank: with less than 1000 repetitions p999 is the slowest
+  sample) and their standard deviation
+- flags: --bench-format=text|csv|json, --bench-sizes=1000,100000 (replaces the defaults of the file),
+  --bench-reps=N and --bench-warmup=N
+- --bench-counters adds the per-op averages of the counters of perf_counters.h, counted over the timed repetitions
+  (not over reset); counters the system does not offer print as n/a, empty in csv and null in json
+- csv and json print only the harness results, so files run their one-off comparisons (print_bench_result) in the
+  text format only
+*/
+#define BENCH_FORMAT_TEXT 0
+#define BENCH_FORMAT_CSV 1
+#define BENCH_FORMAT_JSON 2
+#define BENCH_MAX_SIZES 16
+#define BENCH_DEFAULT_REPS 100
+#define BENCH_DEFAULT_WARMUP 5
+
+typedef struct BenchCase {
+    const char* name;
+    void* (*setup)(int size);                 // NULL: the state is NULL
+    void (*reset)(void* state, int size);     // NULL: run leaves the state reusable
+    long long (*run)(void* state, int size);  // one repetition, returns the number of operations
+    void (*teardown)(void* state);            // NULL: nothing to free
+} BenchCase;
+
+typedef struct BenchOptions {
+    int format;
+    int repetitions;
+    int warmup;
+    int sizes[BENCH_MAX_SIZES];
+    int size_count;
+    int counters;
+} BenchOptions;
+
+typedef struct BenchResult {
+    double mean_ns;  // per op, like the percentiles and the standard deviation
+    double ops_per_sec;
+    double p50_ns;
+    double p99_ns;
+    double p999_ns;
+    double stddev_ns;
+    double counters[PERF_COUNTER_COUNT];  // per op, -1 when unavailable or not collected
+} BenchResult;
+
+static inline BenchOptions bench_options(int argc, char** argv, const int default_sizes[], int size_count) {
+    BenchOptions options = {BENCH_FORMAT_TEXT, BENCH_DEFAULT_REPS, BENCH_DEFAULT_WARMUP, {0}, 0, 0};
+    for (int i = 0; i < size_count && i < BENCH_MAX_SIZES; i++) options.sizes[options.size_count++] = default_sizes[i];
+
+    for (int i = 0; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strncmp(arg, BENCH_FORMAT_FLAG, strlen(BENCH_FORMAT_FLAG)) == 0) {
+            const char* format = arg + strlen(BENCH_FORMAT_FLAG);
+            options.format = strcmp(format, "csv") == 0    ? BENCH_FORMAT_CSV
+                             : strcmp(format, "json") == 0 ? BENCH_FORMAT_JSON
+                                                           : BENCH_FORMAT_TEXT;
+        } else if (strncmp(arg, BENCH_REPS_FLAG, strlen(BENCH_REPS_FLAG)) == 0) {
+            int reps = atoi(arg + strlen(BENCH_REPS_FLAG));
+            if (reps > 0) options.repetitions = reps;
+        } else if (strncmp(arg, BENCH_WARMUP_FLAG, strlen(BENCH_WARMUP_FLAG)) == 0) {
+            int warmup = atoi(arg + strlen(BENCH_WARMUP_FLAG));
+            if (warmup >= 0) options.warmup = warmup;
+        } else if (strcmp(arg, BENCH_COUNTERS_FLAG) == 0) {
+            options.counters = 1;
+        } else if (strncmp(arg, BENCH_SIZES_FLAG, strlen(BENCH_SIZES_FLAG)) == 0) {
+            options.size_count = 0;
+            for (const char* p = arg + strlen(BENCH_SIZES_FLAG); *p != '\0' && options.size_count < BENCH_MAX_SIZES;) {
+                char* end;
+                long size = strtol(p, &end, 10);
+                if (end == p) break;
+                if (size > 0) options.sizes[options.size_count++] = (int)size;
+                p = *end == ',' ? end + 1 : end;
+            }
+        }
+    }
+    return options;
+}
+
+static inline int bench_compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// nearest rank on sorted samples
+static inline double bench_percentile(const double* sorted, int count, double p) {
+    int rank = (int)(p * count + 0.999999);
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1];
+}
+
+// Newton's method, so that test_helper.h does not need -lm
+static inline double bench_sqrt(double x) {
+    if (x <= 0) return 0;
+    double root = x > 1 ? x : 1;
+    for (int i = 0; i < 64; i++) {
+        double next = 0.5 * (root + x / root);
+        if (next >= root) break;
+        root = next;
+    }
+    return root;
+}
+
+static inline BenchResult bench_measure(const BenchCase* bench, int size, const BenchOptions* options) {
+    void* state = bench->setup != NULL ? bench->setup(size) : NULL;
+    for (int i = 0; i < options->warmup; i++) {
+        if (bench->reset != NULL) bench->reset(state, size);
+        bench->run(state, size);
+    }
+
+    PerfCounters counters;
+    if (options->counters) {
+        perf_counters_open(&counters);
+        perf_counters_reset(&counters);
+    }
+
+    double* samples = (double*)malloc(sizeof(double) * options->repetitions);
+    long long total_ns = 0, total_ops = 0;
+    for (int i = 0; i < options->repetitions; i++) {
+        if (bench->reset != NULL) bench->reset(state, size);
+        if (options->counters) perf_counters_enable(&counters);
+        long long start = now_ns();
+        long long ops = bench->run(state, size);
+        long long elapsed = now_ns() - start;
+        if (options->counters) perf_counters_disable(&counters);
+        if (ops < 1) ops = 1;
+        samples[i] = (double)elapsed / (double)ops;
+        total_ns += elapsed;
+        total_ops += ops;
+    }
+    if (bench->teardown != NULL) bench->teardown(state);
+
+    BenchResult result;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) result.counters[i] = -1;
+    if (options->counters) {
+        perf_counters_read(&counters, result.counters);
+        perf_counters_close(&counters);
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            if (result.counters[i] >= 0) result.counters[i] /= (double)total_ops;
+        }
+    }
+    result.mean_ns = (double)total_ns / (double)total_ops;
+    result.ops_per_sec = total_ns > 0 ? 1e9 * (double)total_ops / (double)total_ns : 0;
+    double mean_sample = 0, variance = 0;
+    for (int i = 0; i < options->repetitions; i++) mean_sample += samples[i] / options->repetitions;
+    for (int i = 0; i < options->repetitions; i++) {
+        variance += (samples[i] - mean_sample) * (samples[i] - mean_sample) / options->repetitions;
+    }
+    result.stddev_ns = bench_sqrt(variance);
+    qsort(samples, options->repetitions, sizeof(double), bench_compare_doubles);
+    result.p50_ns = bench_percentile(samples, options->repetitions, 0.50);
+    result.p99_ns = bench_percentile(samples, options->repetitions, 0.99);
+    result.p999_ns = bench_percentile(samples, options->repetitions, 0.999);
+    free(samples);
+    return result;
+}
+
+static inline void bench_print_result(const BenchOptions* options, const char* name, int size, const BenchResult* r,
+                                      int first) {
+    if (options->format == BENCH_FORMAT_CSV) {
+        printf("%s,%d,%d,%.2f,%.0f,%.2f,%.2f,%.2f,%.2f", name, size, options->repetitions, r->mean_ns, r->ops_per_sec,
+               r->p50_ns, r->p99_ns, r->p999_ns, r->stddev_ns);
+        for (int i = 0; options->counters && i < PERF_COUNTER_COUNT; i++) {
+            if (r->counters[i] < 0)
+                printf(",");
+            else
+                printf(",%.4f", r->counters[i]);
+        }
+        printf("\n");
+    } else if (options->format == BENCH_FORMAT_JSON) {
+        printf("%s\n  {\"name\": \"%s\", \"size\": %d, \"repetitions\": %d, \"ns_per_op\": %.2f, \"ops_per_sec\": %.0f, "
+               "\"p50_ns\": %.2f, \"p99_ns\": %.2f, \"p999_ns\": %.2f, \"stddev_ns\": %.2f",
+               first ? "" : ",", name, size, options->repetitions, r->mean_ns, r->ops_per_sec, r->p50_ns, r->p99_ns,
+               r->p999_ns, r->stddev_ns);
+        for (int i = 0; options->counters && i < PERF_COUNTER_COUNT; i++) {
+            if (r->counters[i] < 0)
+                printf(", \"%s_per_op\": null", PERF_COUNTER_NAMES[i]);
+            else
+                printf(", \"%s_per_op\": %.4f", PERF_COUNTER_NAMES[i], r->counters[i]);
+        }
+        printf("}");
+    } else {
+        printf("%-36s %10d %12.2f %14.0f %12.2f %12.2f %12.2f %10.2f\n", name, size, r->mean_ns, r->ops_per_sec,
+               r->p50_ns, r->p99_ns, r->p999_ns, r->stddev_ns);
+        if (options->counters) perf_counters_print("  per op:", r->counters, 1);
+    }
+}
+
+// says once, on stderr, which counters --bench-counters will not be able to report
+static inline void bench_check_counters(void) {
+    PerfCounters counters;
+    int opened = perf_counters_open(&counters);
+    if (opened < PERF_COUNTER_COUNT) {
+        fprintf(stderr, "perf counters: %d of %d available", opened, PERF_COUNTER_COUNT);
+        if (counters.open_errno != 0) fprintf(stderr, " (perf_event_open: %s)", strerror(counters.open_errno));
+        fprintf(stderr, ", the others are reported as n/a\n");
+    }
+    perf_counters_close(&counters);
+}
+
+static inline void bench_run(const BenchOptions* options, const BenchCase cases[], int count) {
+    if (options->counters) bench_check_counters();
+    if (options->format == BENCH_FORMAT_CSV) {
+        printf("name,size,repetitions,ns_per_op,ops_per_sec,p50_ns,p99_ns,p999_ns,stddev_ns");
+        for (int i = 0; options->counters && i < PERF_COUNTER_COUNT; i++) printf(",%s_per_op", PERF_COUNTER_NAMES[i]);
+        printf("\n");
+    } else if (options->format == BENCH_FORMAT_JSON) {
+        printf("[");
+    } else {
+        printf("%-36s %10s %12s %14s %12s %12s %12s %10s\n", "benchmark", "size", "ns/op", "ops/sec", "p50", "p99",
+               "p999", "stddev");
+    }
+
+    int first = 1;
+    for (int c = 0; c < count; c++) {
+        for (int s = 0; s < options->size_count; s++) {
+            BenchResult result = bench_measure(&cases[c], options->sizes[s], options);
+            bench_print_result(options, cases[c].name, options->sizes[s], &result, first);
+            first = 0;
+            fflush(stdout);
+        }
+    }
+
+    if (options->format == BENCH_FORMAT_JSON) printf("\n]\n");
+}
+
+// xorshift32 for the random keys and positions of benchmarks, state must not be 0
+static inline uint32_t bench_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// Fisher-Yates with bench_random; linking nodes in a shuffled order makes consecutive nodes far apart in memory,
+// like a heap that has been in use
+static inline void bench_shuffle(int* a, int size, uint32_t* state) {
+    for (int i = size - 1; i > 0; i--) {
+        int j = (int)(bench_random(state) % (uint32_t)(i + 1));
+        int t = a[i];
+        a[i] = a[j];
+        a[j] = t;
+    }
+}
+
+// links the nodes (allocated one by one) in a shuffled order through the pointer at next_offset of each node, the
+// last one gets NULL; returns the first node, the whole list is scattered over the heap
+static inline void* bench_link_scattered(void** nodes, int size, size_t next_offset, uint32_t* state) {
+    if (size <= 0) return NULL;
+    int* order = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) order[i] = i;
+    bench_shuffle(order, size, state);
+    for (int i = 0; i < size; i++) {
+        void* next = i + 1 < size ? nodes[order[i + 1]] : NULL;
+        memcpy((char*)nodes[order[i]] + next_offset, &next, sizeof(next));
+    }
+    void* head = nodes[order[0]];
+    free(order);
+    return head;
+}
+
+// the first bench_random state of every harness case, so that all files draw the same keys and positions
+#define BENCH_RANDOM_SEED 2463534242u
+
+// the state every file's harness cases share, the first member of its BenchState
+typedef struct BenchCommon {
+    uint32_t seed;   // for bench_random
+    long long sink;  // keeps the results alive
+} BenchCommon;
+
+static inline void bench_common_init(BenchCommon* common) {
+    common->seed = BENCH_RANDOM_SEED;
+    common->sink = 0;
+}
+
 #endif
\ No newline at end of file
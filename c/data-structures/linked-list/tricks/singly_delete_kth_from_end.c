@@ -2,8 +2,12 @@
 - This trick allows us to find and delete the kth element, from the end of the list, in one iteration
 - Remember that the length is unknown
 - A naive approach would calculate the length and delete the node in two different iterations
+- When the length IS known (the List handle stores it) the trick is unnecessary: the predecessor is at index size-k-1
 */
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -12,10 +16,10 @@
 #include "test_helper.h"
 
 void delete_kth_from_end(Node* head, int kth) {
-    Node* sentinel = create_node(0);
-    sentinel->next = head;
+    Node sentinel;  // on the stack, nothing to free
+    sentinel.next = head;
 
-    Node *first = head, *second = sentinel;  // you will see why we use sentinel later
+    Node *first = head, *second = &sentinel;  // you will see why we use sentinel later
 
     for (int i = 0; i < kth; i++) {
         first = first->next;
@@ -35,6 +39,31 @@ void delete_kth_from_end(Node* head, int kth) {
     free(node_to_del);
 }
 
+// kth is 1-indexed like delete_kth_from_end, returns -1 when the list has less than kth nodes
+int list_delete_kth_from_end(List* list, int kth) {
+    if (kth < 1 || kth > list->size) return -1;
+
+    int index = list->size - kth;
+    Node* node_to_del;
+    if (index == 0) {
+        node_to_del = list->head;
+        list->head = node_to_del->next;
+    } else {
+        Node* prev = list->head;
+        for (int i = 1; i < index; i++) {
+            prev = prev->next;
+        }
+        node_to_del = prev->next;
+        prev->next = node_to_del->next;
+        if (node_to_del == list->tail) list->tail = prev;
+    }
+
+    if (list->head == NULL) list->tail = NULL;
+    free(node_to_del);
+    list->size--;
+    return 0;
+}
+
 void test_delete_kth_from_end() {
     print_test_func_name();
 
@@ -65,11 +94,90 @@ void test_delete_kth_from_end() {
     passed();
 }
 
+void test_list_delete_kth_from_end() {
+    print_test_func_name();
+
+    int arr[] = {1, 2, 3, 4, 5};
+    List* list = list_create_from_array(arr, sizeof(arr) / sizeof(*arr));
+
+    assert(list_delete_kth_from_end(list, 4) == 0);  // same deletion as test_delete_kth_from_end
+    assert(list->head->next->data == 3 && list_length(list) == 4);
+
+    assert(list_delete_kth_from_end(list, 1) == 0);  // the tail
+    assert(list->tail->data == 4 && list->tail->next == NULL);
+
+    assert(list_delete_kth_from_end(list, 3) == 0);  // the head
+    assert(list->head->data == 3 && list_length(list) == 2);
+
+    assert(list_delete_kth_from_end(list, 3) == -1);
+    assert(list_delete_kth_from_end(list, 1) == 0);
+    assert(list_delete_kth_from_end(list, 1) == 0);
+    assert(list->head == NULL && list->tail == NULL);
+
+    list_free_all(list);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    List* list;
+} BenchState;
+
+static void* bench_setup(int size) {
+    int* arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) arr[i] = i;
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->list = list_create_from_array(arr, size);
+    free(arr);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    list_free_all(((BenchState*)state)->list);
+    free(state);
+}
+
+// links a node after the head, then deletes the middle one: the head is never deleted and the length stays the same
+static long long bench_delete_kth_from_end(void* state, int size) {
+    Node* head = ((BenchState*)state)->list->head;
+    Node* node = create_node(size);
+    node->next = head->next;
+    head->next = node;
+    delete_kth_from_end(head, (size + 1) / 2);
+    return 1;
+}
+
+// the tail may move, so this one goes through the List handle only
+static long long bench_list_delete_kth_from_end(void* state, int size) {
+    List* list = ((BenchState*)state)->list;
+    list_append(list, create_node(size));
+    list_delete_kth_from_end(list, (size + 1) / 2);
+    return 1;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"delete_kth_from_end (middle)", bench_setup, NULL, bench_delete_kth_from_end, bench_teardown},
+    {"list_delete_kth_from_end (middle)", bench_setup, NULL, bench_list_delete_kth_from_end, bench_teardown},
+};
+
 int main(int argc, char** argv) {
     int should_run_tests = has_test_flag(argc, argv);
 
-    if (should_run_tests)
+    if (should_run_tests) {
         test_delete_kth_from_end();
+        test_list_delete_kth_from_end();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+    }
 
     return 0;
 }
\ No newline at end of file
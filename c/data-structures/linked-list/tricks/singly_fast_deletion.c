@@ -3,6 +3,9 @@
 - This differs from delete_after where we know the predecessor node
 */
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
 #include <assert.h>
 #include <stdlib.h>
 
@@ -12,9 +15,10 @@
 // workaround for deleting node in O(1) time when predecessor is unknown
 // this will segfault for tail nodes
 void fast_delete(Node* node) {
-    node->data = node->next->data;
-    node->next = node->next->next;
-    free(node->next);
+    Node* next = node->next;
+    node->data = next->data;
+    node->next = next->next;
+    free(next);
 }
 
 void test_fast_delete() {
@@ -33,11 +37,63 @@ void test_fast_delete() {
     passed();
 }
 
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_DELETE_OPS 1000
+static const int BENCH_SIZES[] = {1000, 1000000};
+
+typedef struct BenchState {
+    Node* head;
+    Node* middle;
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->head = create_node(0);
+    for (int i = size - 1; i > 0; i--) {
+        Node* node = create_node(i);
+        node->next = state->head->next;
+        state->head->next = node;
+    }
+    state->middle = state->head;
+    for (int i = 0; i < size / 2; i++) state->middle = state->middle->next;
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    free_all(((BenchState*)state)->head);
+    free(state);
+}
+
+// links a node after the middle, then fast_delete removes the middle's value: the middle is never the tail
+static long long bench_fast_delete(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    for (int i = 0; i < BENCH_DELETE_OPS; i++) {
+        Node* node = create_node(size + i);
+        node->next = b->middle->next;
+        b->middle->next = node;
+        fast_delete(b->middle);
+    }
+    return BENCH_DELETE_OPS;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"fast_delete", bench_setup, NULL, bench_fast_delete, bench_teardown},
+};
+
 int main(int argc, char** argv) {
     int should_run_tests = has_test_flag(argc, argv);
 
     if (should_run_tests)
         test_fast_delete();
 
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+    }
+
     return 0;
 }
\ No newline at end of file
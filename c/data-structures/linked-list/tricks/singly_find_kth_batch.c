@@ -0,0 +1,211 @@
+/*
+- This trick answers q find_kth queries on the same list in one pass: O(n + q*log(q)) instead of O(n*q)
+- Each find_kth restarts from the head, so q queries walk up to q times the list
+- find_kth_batch sorts the queries by k (keeping their original index), then walks the list once and stops at each k
+  in increasing order; equal ks share the stop
+- The results come back in the order of the queries, out[i] is the node at index ks[i] (from 0), NULL when ks[i] is
+  negative or not smaller than the length
+- Worth it from two or three queries on: the sort costs far less than one extra walk (see the benchmark)
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "singly_linked_list.h"
+#include "test_helper.h"
+
+Node* find_kth(Node* head, int k) {
+    Node* node = head;
+    for (int i = 0; i < k && node != NULL; i++) node = node->next;
+    return node;
+}
+
+typedef struct KthQuery {
+    int k;
+    int index;  // into ks and out
+} KthQuery;
+
+static int compare_queries(const void* a, const void* b) {
+    int x = ((const KthQuery*)a)->k, y = ((const KthQuery*)b)->k;
+    return (x > y) - (x < y);
+}
+
+void find_kth_batch(Node* head, const int* ks, Node** out, int q) {
+    KthQuery* queries = (KthQuery*)malloc(sizeof(KthQuery) * (q > 0 ? q : 1));
+    for (int i = 0; i < q; i++) queries[i] = (KthQuery){ks[i], i};
+    qsort(queries, q, sizeof(KthQuery), compare_queries);
+
+    Node* node = head;
+    int position = 0;
+    for (int i = 0; i < q; i++) {
+        int k = queries[i].k;
+        if (k < 0) {
+            out[queries[i].index] = NULL;
+            continue;
+        }
+        while (node != NULL && position < k) {
+            node = node->next;
+            position++;
+        }
+        out[queries[i].index] = node;  // NULL once the walk ran past the tail
+    }
+
+    free(queries);
+}
+
+/*
+###############################
+###          tests          ###
+###############################
+*/
+void test_find_kth_batch() {
+    print_test_func_name();
+
+    int arr[] = {10, 11, 12, 13, 14, 15};
+    Node* head = create_nodes_from_array(arr, 6);
+    int ks[] = {5, 0, 3, 3, 6, -1, 2, 100};
+    Node* out[8];
+
+    find_kth_batch(head, ks, out, 8);
+    assert(out[0]->data == 15 && out[1] == head && out[2]->data == 13 && out[3] == out[2]);
+    assert(out[4] == NULL && out[5] == NULL && out[7] == NULL);  // past the end, negative
+    assert(out[6]->data == 12);
+
+    find_kth_batch(head, ks, out, 0);
+    find_kth_batch(NULL, ks, out, 2);
+    assert(out[0] == NULL && out[1] == NULL);
+
+    free_all(head);
+    passed();
+}
+
+void test_find_kth_batch_matches_find_kth() {
+    print_test_func_name();
+
+    enum { SIZE = 200, QUERIES = 500 };
+    int arr[SIZE];
+    for (int i = 0; i < SIZE; i++) arr[i] = i;
+    Node* head = create_nodes_from_array(arr, SIZE);
+    int ks[QUERIES];
+    Node* out[QUERIES];
+    uint32_t seed = 5;
+    for (int i = 0; i < QUERIES; i++) ks[i] = (int)(bench_random(&seed) % (SIZE + 20));
+
+    find_kth_batch(head, ks, out, QUERIES);
+    for (int i = 0; i < QUERIES; i++) assert(out[i] == find_kth(head, ks[i]));
+
+    free_all(head);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_LIST_SIZE 1000000
+
+// q random ks on a 1M list: repeated find_kth against one batch, to find the crossover
+void bench_find_kth_batch_crossover() {
+    print_test_func_name();
+
+    int* arr = (int*)malloc(sizeof(int) * BENCH_LIST_SIZE);
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) arr[i] = i;
+    NodeBlock block;
+    Node* head = bulk_create_nodes_from_array(&block, arr, BENCH_LIST_SIZE);
+    int* ks = (int*)malloc(sizeof(int) * 1024);
+    Node** out = (Node**)malloc(sizeof(Node*) * 1024);
+    uint32_t seed = 9;
+    for (int i = 0; i < 1024; i++) ks[i] = (int)(bench_random(&seed) % BENCH_LIST_SIZE);
+    char label[64];
+    bench_keep(find_kth(head, BENCH_LIST_SIZE - 1) != NULL);  // one walk to warm up, q=1 would pay for it otherwise
+
+    for (int q = 1; q <= 1024; q *= 2) {
+        long long start = now_ns();
+        for (int i = 0; i < q; i++) out[i] = find_kth(head, ks[i]);
+        snprintf(label, sizeof(label), "q=%d repeated find_kth (per query)", q);
+        print_bench_result(label, now_ns() - start, q);
+
+        start = now_ns();
+        find_kth_batch(head, ks, out, q);
+        snprintf(label, sizeof(label), "q=%d find_kth_batch (per query)", q);
+        print_bench_result(label, now_ns() - start, q);
+        for (int i = 0; i < q; i++) assert(out[i]->data == ks[i]);
+    }
+
+    free(out);
+    free(ks);
+    bulk_free_all(&block, NULL);
+    free(arr);
+}
+
+// harness cases: 64 random ks per repetition on a list of size nodes
+#define BENCH_CASE_QUERIES 64
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    Node* head;
+    int ks[BENCH_CASE_QUERIES];
+    Node* out[BENCH_CASE_QUERIES];
+} BenchState;
+
+static void* bench_setup(int size) {
+    int* arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) arr[i] = i;
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->head = create_nodes_from_array(arr, size);
+    bench_common_init(&state->common);
+    free(arr);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    free_all(((BenchState*)state)->head);
+    free(state);
+}
+
+static void bench_new_queries(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    for (int i = 0; i < BENCH_CASE_QUERIES; i++) b->ks[i] = (int)(bench_random(&b->common.seed) % (uint32_t)size);
+}
+
+static long long bench_repeated_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    (void)size;
+    for (int i = 0; i < BENCH_CASE_QUERIES; i++) b->out[i] = find_kth(b->head, b->ks[i]);
+    return BENCH_CASE_QUERIES;
+}
+
+static long long bench_find_kth_batch(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    (void)size;
+    find_kth_batch(b->head, b->ks, b->out, BENCH_CASE_QUERIES);
+    return BENCH_CASE_QUERIES;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"repeated find_kth (q=64, per query)", bench_setup, bench_new_queries, bench_repeated_find_kth, bench_teardown},
+    {"find_kth_batch (q=64, per query)", bench_setup, bench_new_queries, bench_find_kth_batch, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_find_kth_batch();
+        test_find_kth_batch_matches_find_kth();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_find_kth_batch_crossover();
+    }
+
+    return 0;
+}
@@ -0,0 +1,266 @@
+/*
+- tests and benchmarks of singly_generic_list.h
+- instances: ints (to compare with the hand-written Node), 64-bit keys, a struct ordered by two fields and strings
+- the benchmark runs search, find_kth and merge_two_sorted on the generated int list and on the hand-written Node of
+  singly_linked_list.h: the generated code should be as fast
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "singly_generic_list.h"
+#include "singly_linked_list.h"
+#include "singly_merge_two_sorted.h"
+#include "test_helper.h"
+
+typedef struct Point {
+    int x;
+    int y;
+} Point;
+
+// by x, then by y
+static inline int point_cmp(Point a, Point b) {
+    return a.x != b.x ? LIST_CMP_SCALAR(a.x, b.x) : LIST_CMP_SCALAR(a.y, b.y);
+}
+
+DEFINE_LIST(Int, int, LIST_CMP_SCALAR)
+DEFINE_LIST(I64, int64_t, LIST_CMP_SCALAR)
+DEFINE_LIST(Point, Point, point_cmp)
+DEFINE_LIST(Str, const char*, strcmp)
+
+void test_int_list() {
+    print_test_func_name();
+
+    int arr[] = {1, 2, 3, 4, 5, 6, 7};
+    IntNode* head = Int_create_nodes_from_array(arr, 7);
+    assert(Int_length(head) == 7);
+    assert(Int_search(head, 5)->data == 5 && Int_search(head, 8) == NULL);
+    assert(Int_find_kth(head, 0) == head && Int_find_kth(head, 6)->data == 7);
+
+    head = Int_reverse_sublist(head, 2, 5);  // 1 5 4 3 2 6 7
+    int reversed[] = {1, 5, 4, 3, 2, 6, 7};
+    for (int i = 0; i < 7; i++) assert(Int_find_kth(head, i)->data == reversed[i]);
+
+    Int_insert_after(head, Int_create_node(0));  // 1 0 5 ...
+    assert(head->next->data == 0 && Int_length(head) == 8);
+    free(Int_delete_after(head));
+    assert(head->next->data == 5 && Int_length(head) == 7);
+
+    head = Int_merge_sort(head);
+    for (int i = 0; i < 7; i++) assert(Int_find_kth(head, i)->data == i + 1);
+
+    Int_free_all(head);
+    assert(Int_create_nodes_from_array(arr, 0) == NULL);
+    passed();
+}
+
+void test_i64_list() {
+    print_test_func_name();
+
+    int64_t odd[] = {-(INT64_C(1) << 40), 1, INT64_C(1) << 40};
+    int64_t even[] = {0, INT64_C(1) << 35, INT64_MAX};
+    I64Node* head = I64_merge_two_sorted(I64_create_nodes_from_array(odd, 3), I64_create_nodes_from_array(even, 3));
+
+    int64_t expected[] = {-(INT64_C(1) << 40), 0, 1, INT64_C(1) << 35, INT64_C(1) << 40, INT64_MAX};
+    int i = 0;
+    for (I64Node* n = head; n != NULL; n = n->next) assert(n->data == expected[i++]);
+    assert(i == 6);
+    assert(I64_search(head, INT64_MAX) != NULL && I64_search(head, 2) == NULL);
+
+    I64_free_all(head);
+    passed();
+}
+
+void test_point_list() {
+    print_test_func_name();
+
+    Point points[] = {{2, 1}, {1, 5}, {2, 0}, {1, 5}, {0, 9}};
+    PointNode* head = Point_create_nodes_from_array(points, 5);
+    PointNode* first_dup = Point_find_kth(head, 1);
+    PointNode* second_dup = Point_find_kth(head, 3);
+    assert(Point_search(head, (Point){2, 0}) == Point_find_kth(head, 2));
+
+    head = Point_merge_sort(head);
+    Point expected[] = {{0, 9}, {1, 5}, {1, 5}, {2, 0}, {2, 1}};
+    for (int i = 0; i < 5; i++) assert(point_cmp(Point_find_kth(head, i)->data, expected[i]) == 0);
+    assert(Point_find_kth(head, 1) == first_dup && Point_find_kth(head, 2) == second_dup);  // stable
+
+    Point_free_all(head);
+    passed();
+}
+
+void test_str_list() {
+    print_test_func_name();
+
+    const char* words[] = {"pear", "apple", "fig", "banana"};
+    StrNode* head = Str_merge_sort(Str_create_nodes_from_array(words, 4));
+    const char* expected[] = {"apple", "banana", "fig", "pear"};
+    for (int i = 0; i < 4; i++) assert(strcmp(Str_find_kth(head, i)->data, expected[i]) == 0);
+
+    char key[] = "fig";  // another copy: search compares contents, not pointers
+    assert(Str_search(head, key) == Str_find_kth(head, 2));
+    assert(Str_search(head, "kiwi") == NULL);
+
+    Str_free_all(head);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_SIZE 1000000
+#define BENCH_REPEAT 10
+
+// the hand-written search and find_kth of 1_singly_linked_list.c
+static Node* search(Node* head, int key) {
+    Node* n = head;
+    while (n != NULL) {
+        if (n->data == key)
+            return n;
+        else
+            n = n->next;
+    }
+
+    return NULL;
+}
+
+static Node* find_kth(Node* head, int k) {
+    if (k == 0) return head;
+
+    Node* node = head;
+    for (int i = 0; i < k; i++) {
+        node = node->next;
+    }
+
+    return node;
+}
+
+void bench_generated_vs_hand_written() {
+    print_test_func_name();
+
+    int* even = (int*)malloc(sizeof(int) * BENCH_SIZE);
+    int* odd = (int*)malloc(sizeof(int) * BENCH_SIZE);
+    for (int i = 0; i < BENCH_SIZE; i++) {
+        even[i] = 2 * i;
+        odd[i] = 2 * i + 1;
+    }
+    long long total = (long long)BENCH_REPEAT * BENCH_SIZE;
+
+    Node* head = create_nodes_from_array(even, BENCH_SIZE);
+    IntNode* int_head = Int_create_nodes_from_array(even, BENCH_SIZE);
+
+    int misses = 0, int_misses = 0;
+    long long start = now_ns();
+    for (int r = 0; r < BENCH_REPEAT; r++) misses += search(head, -1 - r) == NULL;
+    print_bench_result("search hand-written", now_ns() - start, total);
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEAT; r++) int_misses += Int_search(int_head, -1 - r) == NULL;
+    print_bench_result("search DEFINE_LIST(int)", now_ns() - start, total);
+    bench_keep(misses + int_misses);
+    assert(misses == BENCH_REPEAT && int_misses == BENCH_REPEAT);
+
+    long long sum = 0, int_sum = 0, expected = 0;
+    for (int r = 0; r < BENCH_REPEAT; r++) expected += 2 * (BENCH_SIZE - 1 - r);
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEAT; r++) sum += find_kth(head, BENCH_SIZE - 1 - r)->data;
+    print_bench_result("find_kth hand-written", now_ns() - start, total);
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEAT; r++) int_sum += Int_find_kth(int_head, BENCH_SIZE - 1 - r)->data;
+    print_bench_result("find_kth DEFINE_LIST(int)", now_ns() - start, total);
+    bench_keep(sum + int_sum);
+    assert(sum == expected && int_sum == expected);
+
+    // one merge of two interleaving lists, the worst case for branch prediction
+    Node* other = create_nodes_from_array(odd, BENCH_SIZE);
+    start = now_ns();
+    head = merge_two_sorted(head, other);
+    print_bench_result("merge_two_sorted hand-written", now_ns() - start, 2 * BENCH_SIZE);
+    IntNode* int_other = Int_create_nodes_from_array(odd, BENCH_SIZE);
+    start = now_ns();
+    int_head = Int_merge_two_sorted(int_head, int_other);
+    print_bench_result("merge_two_sorted DEFINE_LIST(int)", now_ns() - start, 2 * BENCH_SIZE);
+
+    free_all(head);
+    Int_free_all(int_head);
+    free(even);
+    free(odd);
+}
+
+// harness cases on the generated int list: 0..size-1 in order
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    IntNode* head;
+} BenchState;
+
+static void* bench_setup(int size) {
+    int* arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) arr[i] = i;
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->head = Int_create_nodes_from_array(arr, size);
+    bench_common_init(&state->common);
+    free(arr);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    Int_free_all(((BenchState*)state)->head);
+    free(state);
+}
+
+static long long bench_int_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->common.sink += Int_search(b->head, (int)(bench_random(&b->common.seed) % (uint32_t)size))->data;
+    return 1;
+}
+
+static long long bench_int_find_kth(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->common.sink += Int_find_kth(b->head, (int)(bench_random(&b->common.seed) % (uint32_t)size))->data;
+    return 1;
+}
+
+static void bench_random_data(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    IntNode* n = b->head;
+    for (int i = 0; i < size; i++, n = n->next) n->data = (int)(bench_random(&b->common.seed) >> 1);
+}
+
+static long long bench_int_merge_sort(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->head = Int_merge_sort(b->head);
+    return size;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"Int_search", bench_setup, NULL, bench_int_search, bench_teardown},
+    {"Int_find_kth", bench_setup, NULL, bench_int_find_kth, bench_teardown},
+    {"Int_merge_sort (random)", bench_setup, bench_random_data, bench_int_merge_sort, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_int_list();
+        test_i64_list();
+        test_point_list();
+        test_str_list();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_generated_vs_hand_written();
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+- DEFINE_LIST(name, T, cmp) generates a singly linked list of T: the type name##Node and the functions name##_*
+- cmp(a, b) takes two T and returns < 0, 0 or > 0 like strcmp; it is a macro or a static inline function that is
+  expanded into each generated function, so the comparisons are inlined like the == and <= on ints of
+  singly_linked_list.h (no call through a function pointer)
+- LIST_CMP_SCALAR compares any arithmetic type, strcmp works as is for const char* lists
+- generated functions, same behaviour as their int counterparts in 1_singly_linked_list.c and the tricks:
+  create_node, create_nodes_from_array, free_all, length, insert_after, delete_after, search, find_kth,
+  merge_two_sorted (stable), merge_sort (stable, top-down on the list) and reverse_sublist (1-indexed, inclusive)
+- every instance is static inline: define each list once per translation unit
+*/
+
+#ifndef SINGLY_GENERIC_LIST
+#define SINGLY_GENERIC_LIST
+
+#include <stdlib.h>
+
+#define LIST_CMP_SCALAR(a, b) (((a) > (b)) - ((a) < (b)))
+
+#define DEFINE_LIST(name, T, cmp) \
+    typedef struct name##Node { \
+        T data; \
+        struct name##Node* next; \
+    } name##Node; \
+\
+    static inline name##Node* name##_create_node(T data) { \
+        name##Node* node = (name##Node*)malloc(sizeof(*node)); \
+        node->data = data; \
+        node->next = NULL; \
+        return node; \
+    } \
+\
+    static inline name##Node* name##_create_nodes_from_array(const T a[], int size) { \
+        name##Node sentinel = {.next = NULL}; \
+        name##Node* node = &sentinel; \
+        for (int i = 0; i < size; i++) { \
+            node->next = name##_create_node(a[i]); \
+            node = node->next; \
+        } \
+        return sentinel.next; \
+    } \
+\
+    static inline void name##_free_all(name##Node* head) { \
+        while (head != NULL) { \
+            name##Node* next = head->next; \
+            free(head); \
+            head = next; \
+        } \
+    } \
+\
+    static inline int name##_length(const name##Node* head) { \
+        int length = 0; \
+        for (; head != NULL; head = head->next) length++; \
+        return length; \
+    } \
+\
+    static inline void name##_insert_after(name##Node* node, name##Node* new_node) { \
+        new_node->next = node->next; \
+        node->next = new_node; \
+    } \
+\
+    /* returns the unlinked successor of node (NULL if node is the tail) */ \
+    static inline name##Node* name##_delete_after(name##Node* node) { \
+        name##Node* removed = node->next; \
+        if (removed != NULL) node->next = removed->next; \
+        return removed; \
+    } \
+\
+    static inline name##Node* name##_search(name##Node* head, T key) { \
+        for (name##Node* n = head; n != NULL; n = n->next) { \
+            if (cmp(n->data, key) == 0) return n; \
+        } \
+        return NULL; \
+    } \
+\
+    /* k from 0, assumes that the list has more than k nodes */ \
+    static inline name##Node* name##_find_kth(name##Node* head, int k) { \
+        name##Node* node = head; \
+        for (int i = 0; i < k; i++) node = node->next; \
+        return node; \
+    } \
+\
+    static inline name##Node* name##_merge_two_sorted(name##Node* head1, name##Node* head2) { \
+        name##Node sentinel; \
+        name##Node* n = &sentinel; \
+        while (head1 && head2) { \
+            if (cmp(head1->data, head2->data) <= 0) { \
+                n->next = head1; \
+                head1 = head1->next; \
+            } else { \
+                n->next = head2; \
+                head2 = head2->next; \
+            } \
+            n = n->next; \
+        } \
+        n->next = head1 ? head1 : head2; \
+        return sentinel.next; \
+    } \
+\
+    static inline name##Node* name##_merge_sort(name##Node* head) { \
+        if (head == NULL || head->next == NULL) return head; \
+        name##Node* slow = head; \
+        for (name##Node* fast = head->next; fast->next && fast->next->next; fast = fast->next->next) \
+            slow = slow->next; \
+        name##Node* second = slow->next; \
+        slow->next = NULL; \
+        return name##_merge_two_sorted(name##_merge_sort(head), name##_merge_sort(second)); \
+    } \
+\
+    static inline name##Node* name##_reverse_sublist(name##Node* head, int s, int k) { \
+        name##Node sentinel = {.next = head}; \
+        name##Node* s_node_prev = &sentinel; \
+        for (int i = 1; i < s; i++) s_node_prev = s_node_prev->next; \
+        name##Node* sublist_head = NULL; \
+        name##Node* sublist_tail = s_node_prev->next; \
+        name##Node* sec = s_node_prev->next; \
+        for (int i = s; i <= k; i++) { \
+            name##Node* next_sec = sec->next; \
+            sec->next = sublist_head; \
+            sublist_head = sec; \
+            sec = next_sec; \
+        } \
+        s_node_prev->next = sublist_head; \
+        sublist_tail->next = sec; \
+        return sentinel.next; \
+    }
+
+#endif
@@ -0,0 +1,316 @@
+/*
+- tests and benchmarks of the intrusive singly list (slink_* in singly_linked_list.h)
+- the records embed their SLink, container_of turns a link back into its record
+- the benchmark builds and searches lists of 32-byte records: intrusive (one allocation per record) against
+  what a Node-based list needs for the same records (a node pointing at a separately allocated record)
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "singly_linked_list.h"
+#include "test_helper.h"
+
+typedef struct Record {
+    long id;
+    double score;
+    SLink link;  // deliberately not first, container_of must subtract its offset
+    int tag;
+} Record;
+
+static Record* records_create(int size) {
+    Record* records = (Record*)malloc(sizeof(Record) * size);
+    for (int i = 0; i < size; i++) records[i] = (Record){i, 0.5 * i, {NULL}, 0};
+    return records;
+}
+
+// links records[0..size) in order, returns the head
+static SLink* records_link(Record* records, int size) {
+    for (int i = 0; i + 1 < size; i++) records[i].link.next = &records[i + 1].link;
+    if (size > 0) records[size - 1].link.next = NULL;
+    return size > 0 ? &records[0].link : NULL;
+}
+
+static void assert_ids(SLink* head, const long* expected, int size) {
+    int i = 0;
+    slink_foreach_entry(r, head, Record, link) {
+        assert(i < size && r->id == expected[i]);
+        i++;
+    }
+    assert(i == size);
+}
+
+static int compare_by_id(const SLink* a, const SLink* b) {
+    long x = container_of(a, Record, link)->id, y = container_of(b, Record, link)->id;
+    return (x > y) - (x < y);
+}
+
+void test_slink_container_of() {
+    print_test_func_name();
+
+    Record r = {7, 1.5, {NULL}, 3};
+    SLink* link = &r.link;
+    assert(container_of(link, Record, link) == &r);
+    assert(container_of(link, Record, link)->tag == 3);
+    assert(slink_entry_or_null((SLink*)NULL, Record, link) == NULL);
+
+    passed();
+}
+
+void test_slink_insert_and_delete() {
+    print_test_func_name();
+
+    Record* records = records_create(6);
+    SLink* head = records_link(records, 3);  // 0 1 2
+
+    slink_insert_after(&records[0].link, &records[3].link);  // 0 3 1 2
+    slink_insert_after(&records[2].link, &records[4].link);  // 0 3 1 2 4
+    assert_ids(head, (long[]){0, 3, 1, 2, 4}, 5);
+
+    assert(slink_delete_after(&records[3].link) == &records[1].link);  // 0 3 2 4
+    assert(slink_delete_after(&records[4].link) == NULL);
+    head = slink_delete(head, &records[0].link);  // 3 2 4
+    assert(head == &records[3].link);
+    head = slink_delete(head, &records[4].link);  // 3 2
+    assert_ids(head, (long[]){3, 2}, 2);
+
+    int count = 0;
+    slink_foreach(link, head) count++;
+    assert(count == 2);
+
+    free(records);
+    passed();
+}
+
+void test_slink_splice_after() {
+    print_test_func_name();
+
+    Record* records = records_create(6);
+    SLink* head = records_link(records, 3);       // 0 1 2
+    SLink* other = records_link(records + 3, 3);  // 3 4 5
+    slink_splice_after(&records[0].link, other, &records[5].link);
+    assert_ids(head, (long[]){0, 3, 4, 5, 1, 2}, 6);
+
+    free(records);
+    passed();
+}
+
+void test_slink_merge_two_sorted() {
+    print_test_func_name();
+
+    Record* records = records_create(7);
+    records[0].link.next = &records[2].link;  // 0 2 4 6 and 1 3 5
+    records[2].link.next = &records[4].link;
+    records[4].link.next = &records[6].link;
+    records[6].link.next = NULL;
+    records[1].link.next = &records[3].link;
+    records[3].link.next = &records[5].link;
+    records[5].link.next = NULL;
+
+    SLink* head = slink_merge_two_sorted(&records[0].link, &records[1].link, compare_by_id);
+    assert_ids(head, (long[]){0, 1, 2, 3, 4, 5, 6}, 7);
+    assert(slink_merge_two_sorted(NULL, &records[0].link, compare_by_id) == &records[0].link);
+    assert(slink_merge_two_sorted(NULL, NULL, compare_by_id) == NULL);
+
+    // equal ids: the record of the first list goes first
+    Record a = {1, 0, {NULL}, 1}, b = {1, 0, {NULL}, 2};
+    head = slink_merge_two_sorted(&a.link, &b.link, compare_by_id);
+    assert(head == &a.link && a.link.next == &b.link);
+
+    free(records);
+    passed();
+}
+
+void test_slink_reverse_sublist() {
+    print_test_func_name();
+
+    Record* records = records_create(7);
+    SLink* head = records_link(records, 7);
+    head = slink_reverse_sublist(head, 2, 5);
+    assert_ids(head, (long[]){0, 4, 3, 2, 1, 5, 6}, 7);
+    head = slink_reverse_sublist(head, 1, 7);
+    assert_ids(head, (long[]){6, 5, 1, 2, 3, 4, 0}, 7);
+    head = slink_reverse_sublist(head, 3, 3);
+    assert_ids(head, (long[]){6, 5, 1, 2, 3, 4, 0}, 7);
+
+    free(records);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_RECORDS 1000000
+#define BENCH_SEARCHES 20
+
+// the non-intrusive layout: the list owns small nodes, each pointing at a record allocated on its own
+typedef struct BoxedRecord {
+    long id;
+    double score;
+    int tag;
+} BoxedRecord;
+
+typedef struct BoxNode {
+    BoxedRecord* record;
+    struct BoxNode* next;
+} BoxNode;
+
+void bench_intrusive_vs_boxed() {
+    print_test_func_name();
+
+    int* order = (int*)malloc(sizeof(int) * BENCH_RECORDS);
+    for (int i = 0; i < BENCH_RECORDS; i++) order[i] = i;
+    uint32_t seed = BENCH_RANDOM_SEED;
+    bench_shuffle(order, BENCH_RECORDS, &seed);
+    void** allocated = (void**)malloc(sizeof(void*) * BENCH_RECORDS);
+    long checksum = 0;
+
+    // intrusive: one malloc per record
+    long long start = now_ns();
+    for (int i = 0; i < BENCH_RECORDS; i++) {
+        Record* r = (Record*)malloc(sizeof(*r));
+        *r = (Record){i, 0.5 * i, {NULL}, 0};
+        allocated[i] = r;
+    }
+    SLink* head = NULL;
+    for (int i = 0; i < BENCH_RECORDS; i++) {
+        Record* r = (Record*)allocated[order[i]];
+        r->link.next = head;
+        head = &r->link;
+    }
+    long long end = now_ns();
+    print_bench_result("intrusive build", end - start, BENCH_RECORDS);
+
+    start = now_ns();
+    for (int s = 0; s < BENCH_SEARCHES; s++) {
+        slink_foreach_entry(r, head, Record, link) {
+            if (r->id == -s) checksum++;  // only id 0 in the first round: a full traversal touching every record
+        }
+    }
+    end = now_ns();
+    print_bench_result("intrusive search (per node)", end - start, (long long)BENCH_SEARCHES * BENCH_RECORDS);
+
+    start = now_ns();
+    while (head != NULL) {
+        SLink* next = head->next;
+        free(container_of(head, Record, link));
+        head = next;
+    }
+    end = now_ns();
+    print_bench_result("intrusive free", end - start, BENCH_RECORDS);
+
+    // boxed: a node and a record per element, the search follows two pointers per element
+    start = now_ns();
+    for (int i = 0; i < BENCH_RECORDS; i++) {
+        BoxedRecord* r = (BoxedRecord*)malloc(sizeof(*r));
+        *r = (BoxedRecord){i, 0.5 * i, 0};
+        BoxNode* node = (BoxNode*)malloc(sizeof(*node));
+        *node = (BoxNode){r, NULL};
+        allocated[i] = node;
+    }
+    BoxNode* box_head = NULL;
+    for (int i = 0; i < BENCH_RECORDS; i++) {
+        BoxNode* node = (BoxNode*)allocated[order[i]];
+        node->next = box_head;
+        box_head = node;
+    }
+    end = now_ns();
+    print_bench_result("boxed build", end - start, BENCH_RECORDS);
+
+    start = now_ns();
+    for (int s = 0; s < BENCH_SEARCHES; s++) {
+        for (BoxNode* n = box_head; n != NULL; n = n->next) {
+            if (n->record->id == -s) checksum++;
+        }
+    }
+    end = now_ns();
+    print_bench_result("boxed search (per node)", end - start, (long long)BENCH_SEARCHES * BENCH_RECORDS);
+
+    start = now_ns();
+    while (box_head != NULL) {
+        BoxNode* next = box_head->next;
+        free(box_head->record);
+        free(box_head);
+        box_head = next;
+    }
+    end = now_ns();
+    print_bench_result("boxed free", end - start, BENCH_RECORDS);
+
+    assert(checksum == 2);
+    free(allocated);
+    free(order);
+}
+
+// harness cases: records 0..size-1 in one array, linked in order
+#define BENCH_CHURN_OPS 1000
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    Record* records;
+    SLink* head;
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->records = records_create(size);
+    state->head = records_link(state->records, size);
+    bench_common_init(&state->common);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    free(((BenchState*)state)->records);
+    free(state);
+}
+
+static long long bench_slink_search(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    long id = (long)(bench_random(&b->common.seed) % (uint32_t)size);
+    slink_foreach_entry(r, b->head, Record, link) {
+        if (r->id == id) {
+            b->common.sink += r->tag;
+            break;
+        }
+    }
+    return 1;
+}
+
+// unlinks a record after the head and links it back, the records never move
+static long long bench_slink_delete_and_insert_after(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    if (size < 2) return 1;
+    for (int i = 0; i < BENCH_CHURN_OPS; i++) slink_insert_after(b->head, slink_delete_after(b->head));
+    return BENCH_CHURN_OPS;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"slink search by id", bench_setup, NULL, bench_slink_search, bench_teardown},
+    {"slink_delete_after+insert_after", bench_setup, NULL, bench_slink_delete_and_insert_after, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_slink_container_of();
+        test_slink_insert_and_delete();
+        test_slink_splice_after();
+        test_slink_merge_two_sorted();
+        test_slink_reverse_sublist();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_intrusive_vs_boxed();
+    }
+
+    return 0;
+}
@@ -2,12 +2,20 @@
 - a basic singly linked list setup with only basic methods
 - to see a full (basic) implementation see: data-structures/1_singly_linked_list.c
 - this implementation uses NULL as an indicator of head and tail
+- the pool_* functions take their nodes from a NodePool (see node_pool.h), a NULL pool falls back to malloc
+- the bulk_* functions keep every node of a list built from an array in one contiguous block
+- the List handle stores head, tail and size, so list_append and list_length are O(1)
+- the slink_* functions are the intrusive version: an SLink embedded in any struct, recovered with container_of
 */
 
 #ifndef SINGLY_LINKED_LIST
 #define SINGLY_LINKED_LIST
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+#include "node_pool.h"
+
 typedef struct Node {
     int data;
     struct Node* next;
@@ -29,11 +37,20 @@ static inline Node* create_node(int data) {
     return node;
 }
 
-static inline Node* create_nodes_from_array(int a[], int size) {
+static inline Node* pool_create_node(NodePool* pool, int data) {
+    if (pool == NULL) return create_node(data);
+
+    Node* node = (Node*)pool_alloc_node(pool);
+    node->data = data;
+    node->next = NULL;
+    return node;
+}
+
+static inline Node* pool_create_nodes_from_array(NodePool* pool, int a[], int size) {
     Node* head = NULL;
     Node* node = NULL;
     for (int i = 0; i < size; i++) {
-        Node* n = create_node(a[i]);
+        Node* n = pool_create_node(pool, a[i]);
         if (i == 0) {
             head = n;
             node = n;
@@ -45,4 +62,172 @@ static inline Node* create_nodes_from_array(int a[], int size) {
     return head;
 }
 
-#endif
\ No newline at end of file
+static inline Node* create_nodes_from_array(int a[], int size) {
+    return pool_create_nodes_from_array(NULL, a, size);
+}
+
+typedef struct NodeBlock {
+    Node* nodes;  // every node built by bulk_create_nodes_from_array, in array order
+    int size;
+} NodeBlock;
+
+static inline int block_owns(const NodeBlock* block, const Node* node) {
+    uintptr_t addr = (uintptr_t)node;
+    uintptr_t start = (uintptr_t)block->nodes;
+    return addr >= start && addr < start + sizeof(Node) * block->size;
+}
+
+static inline Node* bulk_create_nodes_from_array(NodeBlock* block, int a[], int size) {
+    block->nodes = size > 0 ? (Node*)malloc(sizeof(Node) * size) : NULL;
+    block->size = size;
+    for (int i = 0; i < size; i++) {
+        block->nodes[i].data = a[i];
+        block->nodes[i].next = i + 1 < size ? &block->nodes[i + 1] : NULL;
+    }
+    return block->nodes;
+}
+
+// pass a NULL head when no node was inserted from outside the block: O(1)
+static inline void bulk_free_all(NodeBlock* block, Node* head) {
+    Node* node = head;
+    while (node != NULL) {
+        Node* prev_node = node;
+        node = node->next;
+        if (!block_owns(block, prev_node)) free(prev_node);
+    }
+    free(block->nodes);
+    block->nodes = NULL;
+    block->size = 0;
+}
+
+typedef struct List {
+    Node* head;
+    Node* tail;
+    int size;
+} List;
+
+static inline List* list_create() {
+    List* list = (List*)malloc(sizeof(*list));
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+    return list;
+}
+
+static inline void list_free_all(List* list) {
+    free_all(list->head);
+    free(list);
+}
+
+static inline int list_length(const List* list) {
+    return list->size;
+}
+
+static inline void list_append(List* list, Node* new_node) {
+    if (list->tail == NULL)
+        list->head = new_node;
+    else
+        list->tail->next = new_node;
+    list->tail = new_node;
+    list->size++;
+}
+
+static inline List* list_create_from_array(int a[], int size) {
+    List* list = list_create();
+    for (int i = 0; i < size; i++) {
+        list_append(list, create_node(a[i]));
+    }
+    return list;
+}
+
+#ifndef container_of
+#define container_of(ptr, type, member) ((type*)((char*)(ptr) - offsetof(type, member)))
+#endif
+
+// intrusive singly list: the link lives inside the caller's struct, so a record and its link are one allocation
+// and one cache miss; NULL ends the list, the caller owns (and frees) the records
+typedef struct SLink {
+    struct SLink* next;
+} SLink;
+
+// link must not be unlinked inside the loop
+#define slink_foreach(link, head) for (SLink* link = (head); link != NULL; link = link->next)
+
+#define slink_entry_or_null(link, type, member) ((link) != NULL ? container_of((link), type, member) : NULL)
+
+#define slink_foreach_entry(entry, head, type, member) \
+    for (type* entry = slink_entry_or_null((head), type, member); entry != NULL; \
+         entry = slink_entry_or_null(entry->member.next, type, member))
+
+static inline void slink_insert_after(SLink* link, SLink* new_link) {
+    new_link->next = link->next;
+    link->next = new_link;
+}
+
+// returns the unlinked successor of link, NULL if link is the tail
+static inline SLink* slink_delete_after(SLink* link) {
+    SLink* removed = link->next;
+    if (removed != NULL) link->next = removed->next;
+    return removed;
+}
+
+// returns the new head; O(n), it has to find the predecessor
+static inline SLink* slink_delete(SLink* head, SLink* link) {
+    if (head == link) return head->next;
+    SLink* n = head;
+    while (n->next != link) n = n->next;
+    n->next = link->next;
+    return head;
+}
+
+// inserts the chain first..last after link: O(1)
+static inline void slink_splice_after(SLink* link, SLink* first, SLink* last) {
+    last->next = link->next;
+    link->next = first;
+}
+
+// cmp returns <= 0 when a goes first, ties are taken from head1 first: merging is stable
+// cmp is a compile-time constant at every call site, so the compiler inlines it into the loop
+static inline SLink* slink_merge_two_sorted(SLink* head1, SLink* head2, int (*cmp)(const SLink*, const SLink*)) {
+    SLink sentinel;
+
+    SLink* n = &sentinel;
+    while (head1 && head2) {
+        if (cmp(head1, head2) <= 0) {
+            n->next = head1;
+            head1 = head1->next;
+        } else {
+            n->next = head2;
+            head2 = head2->next;
+        }
+        n = n->next;
+    }
+
+    n->next = head1 ? head1 : head2;
+
+    return sentinel.next;
+}
+
+// reverses the links s to k inclusive (1-indexed) in one pass, returns the new head
+static inline SLink* slink_reverse_sublist(SLink* head, int s, int k) {
+    SLink sentinel = {head};
+    SLink* s_link_prev = &sentinel;
+    for (int i = 1; i < s; i++) s_link_prev = s_link_prev->next;
+
+    SLink* sublist_head = NULL;
+    SLink* sublist_tail = s_link_prev->next;  // the s-th link will become the tail
+    SLink* sec = s_link_prev->next;
+    for (int i = s; i <= k; i++) {
+        SLink* next_sec = sec->next;
+        sec->next = sublist_head;
+        sublist_head = sec;
+        sec = next_sec;
+    }
+
+    s_link_prev->next = sublist_head;
+    sublist_tail->next = sec;  // sec is the (k+1)-th link
+
+    return sentinel.next;
+}
+
+#endif
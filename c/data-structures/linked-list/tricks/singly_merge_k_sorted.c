@@ -0,0 +1,300 @@
+/*
+- This trick merges k SORTED lists at once with a tournament (loser) tree: O(n*log(k))
+- Chaining merge_two_sorted k-1 times re-walks the growing result every time: O(n*k)
+- The tree is an array of k list indices: tree[0] holds the overall winner, every inner node the loser of its match
+- After emitting the winner only its path to the root is replayed: ceil(log2(k)) comparisons per node
+- Ties go to the list with the lower index, so the merge is stable; nodes are relinked, never allocated
+- For a few lists chaining is cheaper, it has no tree to replay: in bench_merge_k_sorted chaining wins up to k = 8,
+  the two are even at k = 16 and the tree wins from k = 32 on (at k = 1024 by more than 100x)
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "singly_merge_two_sorted.h"
+#include "test_helper.h"
+
+// does list a win against list b? exhausted lists lose against everything
+static inline int beats(Node** heads, int a, int b) {
+    if (heads[a] == NULL) return 0;
+    if (heads[b] == NULL) return 1;
+    return heads[a]->data < heads[b]->data || (heads[a]->data == heads[b]->data && a < b);
+}
+
+// consumes the lists: every heads[i] is NULL afterwards, returns the merged head
+Node* merge_k_sorted(Node** heads, int k) {
+    if (k <= 0) return NULL;
+
+    // leaves are the lists, at positions k..2k-1 of a complete binary tree
+    int* tree = (int*)malloc(sizeof(int) * k);
+    int* winners = (int*)malloc(sizeof(int) * 2 * k);
+    for (int i = 0; i < k; i++) winners[k + i] = i;
+    for (int p = k - 1; p >= 1; p--) {
+        int a = winners[2 * p], b = winners[2 * p + 1];
+        int a_wins = beats(heads, a, b);
+        winners[p] = a_wins ? a : b;
+        tree[p] = a_wins ? b : a;
+    }
+    tree[0] = winners[1];
+    free(winners);
+
+    Node sentinel = {0, NULL};
+    Node* tail = &sentinel;
+    for (;;) {
+        int winner = tree[0];
+        if (heads[winner] == NULL) break;  // the best list is exhausted: all of them are
+
+        tail->next = heads[winner];
+        tail = tail->next;
+        heads[winner] = heads[winner]->next;
+
+        for (int p = (winner + k) / 2; p >= 1; p /= 2) {  // replay the winner's path
+            if (beats(heads, tree[p], winner)) {
+                int loser = winner;
+                winner = tree[p];
+                tree[p] = loser;
+            }
+        }
+        tree[0] = winner;
+    }
+    tail->next = NULL;
+
+    free(tree);
+    return sentinel.next;
+}
+
+static void assert_sorted(Node* head, int size) {
+    int count = 0;
+    for (Node* n = head; n != NULL; n = n->next) {
+        count++;
+        if (n->next != NULL) assert(n->data <= n->next->data);
+    }
+    assert(count == size);
+}
+
+void test_merge_k_sorted() {
+    print_test_func_name();
+
+    int arr1[] = {1, 4, 7, 10};
+    int arr2[] = {2, 5, 8};
+    int arr3[] = {0, 3, 6, 9, 11};
+    Node* heads[] = {
+        create_nodes_from_array(arr1, 4),
+        create_nodes_from_array(arr2, 3),
+        NULL,  // empty lists are fine
+        create_nodes_from_array(arr3, 5),
+    };
+
+    Node* head = merge_k_sorted(heads, 4);
+
+    Node* n = head;
+    for (int i = 0; i <= 11; i++, n = n->next) assert(n->data == i);
+    assert(n == NULL);
+    for (int i = 0; i < 4; i++) assert(heads[i] == NULL);
+
+    free_all(head);
+    passed();
+}
+
+void test_merge_k_sorted_edge_cases() {
+    print_test_func_name();
+
+    assert(merge_k_sorted(NULL, 0) == NULL);
+
+    Node* empty[] = {NULL, NULL, NULL};
+    assert(merge_k_sorted(empty, 3) == NULL);
+
+    int arr[] = {1, 2, 3};
+    Node* single[] = {create_nodes_from_array(arr, 3)};
+    Node* head = merge_k_sorted(single, 1);
+    assert_sorted(head, 3);
+    free_all(head);
+
+    passed();
+}
+
+// equal values must come out ordered by list index, then by position in their list
+void test_merge_k_sorted_is_stable() {
+    print_test_func_name();
+
+    enum { K = 13, LENGTH = 40 };
+    Node* heads[K];
+    Node* nodes[K][LENGTH];
+    srand(9);
+    for (int l = 0; l < K; l++) {
+        int arr[LENGTH];
+        int value = 0;
+        for (int i = 0; i < LENGTH; i++) arr[i] = value += rand() % 2;  // lots of equal values
+        heads[l] = create_nodes_from_array(arr, LENGTH);
+        Node* n = heads[l];
+        for (int i = 0; i < LENGTH; i++, n = n->next) nodes[l][i] = n;
+    }
+
+    Node* head = merge_k_sorted(heads, K);
+    assert_sorted(head, K * LENGTH);
+
+    int prev_list = -1, prev_pos = -1;
+    for (Node* n = head; n->next != NULL; n = n->next) {
+        int list = 0, pos = 0;
+        while (nodes[list][pos] != n->next) {
+            if (++pos == LENGTH) {
+                pos = 0;
+                list++;
+            }
+        }
+        if (n->data == n->next->data && prev_list >= 0) {
+            assert(prev_list < list || (prev_list == list && prev_pos < pos));
+        }
+        prev_list = list;
+        prev_pos = pos;
+    }
+
+    free_all(head);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_MERGE_SIZE (1 << 20)
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// k sorted segments of one contiguous block, cut into k lists
+static Node* build_shards(NodeBlock* block, int* arr, Node** heads, int k) {
+    Node* head = bulk_create_nodes_from_array(block, arr, BENCH_MERGE_SIZE);
+    int length = BENCH_MERGE_SIZE / k;
+    for (int l = 0; l < k; l++) {
+        heads[l] = &block->nodes[l * length];
+        block->nodes[(l + 1) * length - 1].next = NULL;
+    }
+    return head;
+}
+
+void bench_merge_k_sorted() {
+    print_test_func_name();
+
+    int* arr = (int*)malloc(sizeof(int) * BENCH_MERGE_SIZE);
+    Node** heads = (Node**)malloc(sizeof(Node*) * 1024);
+    char label[64];
+    srand(2);
+
+    for (int k = 2; k <= 1024; k *= 2) {
+        int length = BENCH_MERGE_SIZE / k;
+        for (int i = 0; i < BENCH_MERGE_SIZE; i++) arr[i] = rand();
+        for (int l = 0; l < k; l++) qsort(arr + l * length, length, sizeof(int), compare_ints);
+
+        NodeBlock block;
+        build_shards(&block, arr, heads, k);
+        long long start = now_ns();
+        Node* head = heads[0];
+        for (int l = 1; l < k; l++) head = merge_two_sorted(head, heads[l]);
+        long long end = now_ns();
+        snprintf(label, sizeof(label), "k=%d chained merge_two_sorted", k);
+        print_bench_result(label, end - start, BENCH_MERGE_SIZE);
+        assert_sorted(head, BENCH_MERGE_SIZE);
+        bulk_free_all(&block, NULL);
+
+        build_shards(&block, arr, heads, k);
+        start = now_ns();
+        head = merge_k_sorted(heads, k);
+        end = now_ns();
+        snprintf(label, sizeof(label), "k=%d merge_k_sorted", k);
+        print_bench_result(label, end - start, BENCH_MERGE_SIZE);
+        assert_sorted(head, BENCH_MERGE_SIZE);
+        bulk_free_all(&block, NULL);
+    }
+
+    free(heads);
+    free(arr);
+}
+
+// harness cases: size random values cut into k sorted lists of one block, rebuilt before every run
+static const int BENCH_SIZES[] = {1024, 131072, 1048576};
+
+typedef struct BenchState {
+    int k;
+    int* arr;
+    Node** heads;
+    NodeBlock block;
+} BenchState;
+
+static void* bench_setup_k(int size, int k) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->k = k < size ? k : size;
+    state->arr = (int*)malloc(sizeof(int) * size);
+    state->heads = (Node**)malloc(sizeof(Node*) * state->k);
+    uint32_t seed = BENCH_RANDOM_SEED;
+    for (int i = 0; i < size; i++) state->arr[i] = (int)(bench_random(&seed) >> 1);
+    for (int l = 0; l < state->k; l++) {
+        int start = (int)((long long)size * l / state->k), end = (int)((long long)size * (l + 1) / state->k);
+        qsort(state->arr + start, end - start, sizeof(int), compare_ints);
+    }
+    state->block.nodes = NULL;
+    return state;
+}
+
+static void* bench_setup_k4(int size) {
+    return bench_setup_k(size, 4);
+}
+
+static void* bench_setup_k64(int size) {
+    return bench_setup_k(size, 64);
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    if (b->block.nodes != NULL) bulk_free_all(&b->block, NULL);
+    free(b->heads);
+    free(b->arr);
+    free(b);
+}
+
+static void bench_build_lists(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    if (b->block.nodes != NULL) bulk_free_all(&b->block, NULL);
+    bulk_create_nodes_from_array(&b->block, b->arr, size);
+    for (int l = 0; l < b->k; l++) {
+        int start = (int)((long long)size * l / b->k), end = (int)((long long)size * (l + 1) / b->k);
+        b->heads[l] = &b->block.nodes[start];
+        b->block.nodes[end - 1].next = NULL;
+    }
+}
+
+static long long bench_merge_k_sorted_run(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    merge_k_sorted(b->heads, b->k);
+    return size;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"merge_k_sorted (k=4)", bench_setup_k4, bench_build_lists, bench_merge_k_sorted_run, bench_teardown},
+    {"merge_k_sorted (k=64)", bench_setup_k64, bench_build_lists, bench_merge_k_sorted_run, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_merge_k_sorted();
+        test_merge_k_sorted_edge_cases();
+        test_merge_k_sorted_is_stable();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_merge_k_sorted();
+    }
+
+    return 0;
+}
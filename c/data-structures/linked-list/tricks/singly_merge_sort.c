@@ -0,0 +1,252 @@
+/*
+- This trick sorts a list without dumping it into an array: bottom-up merge sort on top of merge_two_sorted
+- See singly_merge_sort.h for the algorithm, this file holds its tests and benchmarks
+- The naive approach copies the list into an array, sorts it and rebuilds the list: O(n) extra memory
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "singly_merge_sort.h"
+#include "test_helper.h"
+
+// checks the order and that no node was lost
+static void assert_sorted(Node* head, int size) {
+    int count = 0;
+    for (Node* n = head; n != NULL; n = n->next) {
+        count++;
+        if (n->next != NULL) assert(n->data <= n->next->data);
+    }
+    assert(count == size);
+}
+
+void test_merge_sort() {
+    print_test_func_name();
+
+    int arr[] = {5, 1, 4, 2, 8, 0, 2, 9, 7, 3};
+    int size = sizeof(arr) / sizeof(*arr);
+    Node* head = create_nodes_from_array(arr, size);
+
+    head = merge_sort(head);
+
+    int expected[] = {0, 1, 2, 2, 3, 4, 5, 7, 8, 9};
+    Node* n = head;
+    for (int i = 0; i < size; i++, n = n->next) assert(n->data == expected[i]);
+    assert(n == NULL);
+
+    free_all(head);
+    passed();
+}
+
+void test_merge_sort_edge_cases() {
+    print_test_func_name();
+
+    assert(merge_sort(NULL) == NULL);
+
+    Node* one = create_node(1);
+    assert(merge_sort(one) == one && one->next == NULL);
+    free_all(one);
+
+    int sorted[] = {1, 2, 2, 3, 4};
+    Node* head = create_nodes_from_array(sorted, 5);
+    Node* second = head->next;
+    head = merge_sort(head);
+    assert(head->next == second);  // a single run: nothing is relinked
+    assert_sorted(head, 5);
+    free_all(head);
+
+    int reversed[] = {5, 4, 3, 2, 1};
+    head = create_nodes_from_array(reversed, 5);
+    head = merge_sort(head);
+    assert(head->data == 1);
+    assert_sorted(head, 5);
+    free_all(head);
+
+    passed();
+}
+
+// equal keys must keep their relative order, the node addresses tell them apart
+void test_merge_sort_is_stable() {
+    print_test_func_name();
+
+    int arr[] = {3, 1, 3, 2, 1, 3, 2, 2, 1};  // also contains short decreasing runs: 3 1, 3 2 1, 2 1
+    int size = sizeof(arr) / sizeof(*arr);
+    Node* head = create_nodes_from_array(arr, size);
+    Node* original[9];
+    Node* n = head;
+    for (int i = 0; i < size; i++, n = n->next) original[i] = n;
+
+    head = merge_sort(head);
+
+    int last_index[4] = {-1, -1, -1, -1};
+    for (n = head; n != NULL; n = n->next) {
+        int index = 0;
+        while (original[index] != n) index++;
+        assert(index > last_index[n->data]);
+        last_index[n->data] = index;
+    }
+    assert_sorted(head, size);
+
+    free_all(head);
+    passed();
+}
+
+void test_list_merge_sort() {
+    print_test_func_name();
+
+    int arr[] = {9, 3, 7, 1};
+    List* list = list_create_from_array(arr, 4);
+
+    list_merge_sort(list);
+
+    assert(list->head->data == 1 && list->tail->data == 9 && list->tail->next == NULL);
+    assert_sorted(list->head, list_length(list));
+
+    list_free_all(list);
+    passed();
+}
+
+void test_random_lists() {
+    print_test_func_name();
+
+    srand(11);
+    for (int round = 0; round < 200; round++) {
+        int size = rand() % 300;
+        int arr[300];
+        for (int i = 0; i < size; i++) arr[i] = rand() % 50;
+        Node* head = merge_sort(create_nodes_from_array(arr, size));
+        assert_sorted(head, size);
+        free_all(head);
+    }
+
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_SORT_SIZE 1000000
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// what we did before: dump to an array, qsort, write back (a rebuild that reuses the nodes)
+static void array_sort(Node* head, int size) {
+    int* arr = (int*)malloc(sizeof(int) * size);
+    int i = 0;
+    for (Node* n = head; n != NULL; n = n->next) arr[i++] = n->data;
+    qsort(arr, size, sizeof(int), compare_ints);
+    i = 0;
+    for (Node* n = head; n != NULL; n = n->next) n->data = arr[i++];
+    free(arr);
+}
+
+void bench_merge_sort() {
+    print_test_func_name();
+
+    const char* names[] = {"random", "sorted", "nearly sorted", "reversed"};
+    int* arr = (int*)malloc(sizeof(int) * BENCH_SORT_SIZE);
+    char label[64];
+    srand(1);
+
+    for (int kind = 0; kind < 4; kind++) {
+        for (int i = 0; i < BENCH_SORT_SIZE; i++) {
+            if (kind == 0) arr[i] = rand();
+            if (kind == 1) arr[i] = i;
+            if (kind == 2) arr[i] = rand() % 100 == 0 ? rand() : i;  // 1% out of place
+            if (kind == 3) arr[i] = BENCH_SORT_SIZE - i;
+        }
+
+        // both start from the same contiguous layout, so neither pays for a fragmented heap
+        NodeBlock block;
+        Node* head = bulk_create_nodes_from_array(&block, arr, BENCH_SORT_SIZE);
+        long long start = now_ns();
+        array_sort(head, BENCH_SORT_SIZE);
+        long long end = now_ns();
+        snprintf(label, sizeof(label), "%s array+qsort+rebuild", names[kind]);
+        print_bench_result(label, end - start, BENCH_SORT_SIZE);
+        bulk_free_all(&block, NULL);
+
+        head = bulk_create_nodes_from_array(&block, arr, BENCH_SORT_SIZE);
+        start = now_ns();
+        head = merge_sort(head);
+        end = now_ns();
+        snprintf(label, sizeof(label), "%s merge_sort", names[kind]);
+        print_bench_result(label, end - start, BENCH_SORT_SIZE);
+        bulk_free_all(&block, NULL);
+    }
+
+    free(arr);
+}
+
+// harness cases: the reset writes new values into the nodes in their current order, the sort reuses the nodes
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    Node* head;
+} BenchState;
+
+static void* bench_setup(int size) {
+    int* arr = (int*)calloc(size, sizeof(int));
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->head = create_nodes_from_array(arr, size);
+    bench_common_init(&state->common);
+    free(arr);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    free_all(((BenchState*)state)->head);
+    free(state);
+}
+
+static void bench_random_data(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    Node* n = b->head;
+    for (int i = 0; i < size; i++, n = n->next) n->data = (int)(bench_random(&b->common.seed) >> 1);
+}
+
+static void bench_sorted_data(void* state, int size) {
+    Node* n = ((BenchState*)state)->head;
+    for (int i = 0; i < size; i++, n = n->next) n->data = i;
+}
+
+static long long bench_merge_sort_run(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->head = merge_sort(b->head);
+    return size;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"merge_sort (random)", bench_setup, bench_random_data, bench_merge_sort_run, bench_teardown},
+    {"merge_sort (sorted)", bench_setup, bench_sorted_data, bench_merge_sort_run, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_merge_sort();
+        test_merge_sort_edge_cases();
+        test_merge_sort_is_stable();
+        test_list_merge_sort();
+        test_random_lists();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_merge_sort();
+    }
+
+    return 0;
+}
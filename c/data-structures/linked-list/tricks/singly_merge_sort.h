@@ -0,0 +1,74 @@
+/*
+- an in-place, stable, bottom-up merge sort built on merge_two_sorted: O(n*log(n)), O(1) extra memory
+- no recursion: runs are merged through a fixed array of 64 pending lists (the scheme of the Linux list_sort)
+- runs are detected timsort-style: a non-decreasing run is taken as is, a strictly decreasing run is reversed
+  (strictly, so reversing never swaps equal values and the sort stays stable)
+- a list made of r natural runs costs O(n*log(r)), so an already sorted (or reversed) list costs one walk: O(n)
+*/
+
+#ifndef SINGLY_MERGE_SORT
+#define SINGLY_MERGE_SORT
+
+#include "singly_merge_two_sorted.h"
+
+// detaches the natural run starting at *rest, returns its head and advances *rest past it
+static inline Node* take_run(Node** rest) {
+    Node* head = *rest;
+    Node* n = head;
+
+    if (n->next != NULL && n->next->data < n->data) {  // strictly decreasing: reverse while detaching
+        Node* reversed = NULL;
+        while (n != NULL && (reversed == NULL || n->data < reversed->data)) {
+            Node* next = n->next;
+            n->next = reversed;
+            reversed = n;
+            n = next;
+        }
+        *rest = n;
+        return reversed;
+    }
+
+    while (n->next != NULL && n->next->data >= n->data) {
+        n = n->next;
+    }
+    *rest = n->next;
+    n->next = NULL;
+    return head;
+}
+
+#define MERGE_SORT_SLOTS 64
+
+// returns the new head, the nodes are relinked, never copied
+static inline Node* merge_sort(Node* head) {
+    // pending[i] holds the merge of 2^i runs, like the digits of a binary counter
+    // merging as soon as two slots collide keeps the merged nodes hot in cache, unlike full passes over the list
+    Node* pending[MERGE_SORT_SLOTS] = {NULL};
+    Node* rest = head;
+
+    while (rest != NULL) {
+        Node* run = take_run(&rest);
+        int i = 0;
+        while (i < MERGE_SORT_SLOTS - 1 && pending[i] != NULL) {
+            run = merge_two_sorted(pending[i], run);  // pending[i] holds earlier nodes: ties stay in order
+            pending[i] = NULL;
+            i++;
+        }
+        pending[i] = run;
+    }
+
+    Node* sorted = NULL;
+    for (int i = 0; i < MERGE_SORT_SLOTS; i++) {
+        if (pending[i] != NULL) sorted = merge_two_sorted(pending[i], sorted);
+    }
+    return sorted;
+}
+
+// the sort relinks every node, so the tail is looked up again: one more O(n) walk
+static inline void list_merge_sort(List* list) {
+    list->head = merge_sort(list->head);
+    Node* n = list->head;
+    while (n != NULL && n->next != NULL) n = n->next;
+    list->tail = n;
+}
+
+#endif
@@ -2,36 +2,19 @@
 - This trick allows us to merge two SORTED linked lists in one iteration: O(n)
 - A naive approach would simply append the lists before sorting it
 - Appending runs in O(1) time but sorting runs in O(n*log(n)) time
+- merge_two_sorted lives in singly_merge_two_sorted.h so that other tricks can reuse it as a kernel
+- the sentinel is a local variable: no allocation, nothing to free
 */
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
 #include <assert.h>
+#include <stdlib.h>
 
-#include "singly_linked_list.h"
+#include "singly_merge_two_sorted.h"
 #include "test_helper.h"
 
-Node* merge_two_sorted(Node* head1, Node* head2) {
-    Node* sentinel = create_node(0);
-
-    Node* n = sentinel;
-    while (head1 && head2) {
-        if (head1->data <= head2->data) {
-            n->next = head1;
-            head1 = head1->next;
-        } else {
-            n->next = head2;
-            head2 = head2->next;
-        }
-        n = n->next;
-    }
-
-    n->next = head1 ? head1 : head2;
-
-    Node* real_head = sentinel->next;
-    free(sentinel);  // free sentinel because free_all(head) does not do this for singly
-
-    return real_head;
-}
-
 void test_merge_two_sorted() {
     print_test_func_name();
 
@@ -44,9 +27,11 @@ void test_merge_two_sorted() {
 
     assert(head);
 
-    while (head) {
-        printf("%d ", head->data);
-        head = head->next;
+    Node* n = head;
+    while (n) {
+        printf("%d ", n->data);
+        if (n->next) assert(n->data <= n->next->data);
+        n = n->next;
     }
     printf("\n");
 
@@ -54,11 +39,70 @@ void test_merge_two_sorted() {
     passed();
 }
 
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+// the evens and the odds: the two lists interleave, the worst case for the branch predictor
+typedef struct BenchState {
+    int* even;
+    int* odd;
+    Node* head1;
+    Node* head2;
+    Node* merged;
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->even = (int*)malloc(sizeof(int) * size);
+    state->odd = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) {
+        state->even[i] = 2 * i;
+        state->odd[i] = 2 * i + 1;
+    }
+    state->merged = NULL;
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    free_all(b->merged);
+    free(b->even);
+    free(b->odd);
+    free(b);
+}
+
+// untimed: the merge consumes both lists
+static void bench_build_lists(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    free_all(b->merged);
+    b->head1 = create_nodes_from_array(b->even, size);
+    b->head2 = create_nodes_from_array(b->odd, size);
+}
+
+static long long bench_merge_two_sorted(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->merged = merge_two_sorted(b->head1, b->head2);
+    return 2 * size;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"merge_two_sorted (interleaved)", bench_setup, bench_build_lists, bench_merge_two_sorted, bench_teardown},
+};
+
 int main(int argc, char** argv) {
     int should_run_tests = has_test_flag(argc, argv);
 
     if (should_run_tests)
         test_merge_two_sorted();
 
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,32 @@
+/*
+- the merge kernel of singly_merge_two_sorted.c, shared with the tricks that build on it (merge sort, ...)
+- the sentinel lives on the stack, so merging allocates nothing
+- ties are taken from head1 first: merging is stable
+*/
+
+#ifndef SINGLY_MERGE_TWO_SORTED
+#define SINGLY_MERGE_TWO_SORTED
+
+#include "singly_linked_list.h"
+
+static inline Node* merge_two_sorted(Node* head1, Node* head2) {
+    Node sentinel;
+
+    Node* n = &sentinel;
+    while (head1 && head2) {
+        if (head1->data <= head2->data) {
+            n->next = head1;
+            head1 = head1->next;
+        } else {
+            n->next = head2;
+            head2 = head2->next;
+        }
+        n = n->next;
+    }
+
+    n->next = head1 ? head1 : head2;
+
+    return sentinel.next;
+}
+
+#endif
@@ -0,0 +1,274 @@
+/*
+- This trick sorts a big list on several cores with pthreads
+- One traversal cuts the list into `threads` chunks of (almost) equal length, the length must be known (List handle)
+- Every chunk is sorted by its own worker with merge_sort (singly_merge_sort.h)
+- The sorted chunks are merged pairwise with merge_two_sorted, each round runs its merges in parallel:
+  threads chunks -> threads/2 -> ... -> 1, i.e. ceil(log2(threads)) rounds
+- The result is stable: chunks keep their list order and merge_two_sorted prefers the earlier chunk on ties
+- Compile with -pthread
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "singly_merge_sort.h"
+#include "test_helper.h"
+
+#define PARALLEL_SORT_MAX_THREADS 64
+
+typedef struct SortTask {
+    Node* head;   // sort: the chunk, merge: the earlier list
+    Node* other;  // merge only: the later list
+    Node* result;
+} SortTask;
+
+static void* sort_worker(void* arg) {
+    SortTask* task = (SortTask*)arg;
+    task->result = merge_sort(task->head);
+    return NULL;
+}
+
+static void* merge_worker(void* arg) {
+    SortTask* task = (SortTask*)arg;
+    task->result = merge_two_sorted(task->head, task->other);
+    return NULL;
+}
+
+// runs worker on every task, task 0 on the calling thread; a task whose thread cannot be created (e.g. EAGAIN) also
+// runs on the calling thread, so the sort is slower but still complete
+static void run_parallel(void* (*worker)(void*), SortTask tasks[], int count) {
+    pthread_t ids[PARALLEL_SORT_MAX_THREADS];
+    int started[PARALLEL_SORT_MAX_THREADS];
+    for (int i = 1; i < count; i++) started[i] = pthread_create(&ids[i], NULL, worker, &tasks[i]) == 0;
+    worker(&tasks[0]);
+    for (int i = 1; i < count; i++) {
+        if (started[i])
+            pthread_join(ids[i], NULL);
+        else
+            worker(&tasks[i]);
+    }
+}
+
+// size is the length of the list, returns the new head
+Node* parallel_merge_sort(Node* head, int size, int threads) {
+    if (threads > PARALLEL_SORT_MAX_THREADS) threads = PARALLEL_SORT_MAX_THREADS;
+    if (threads > size / 2) threads = size / 2;  // a chunk of one node is not worth a thread
+    if (threads <= 1) return merge_sort(head);
+
+    // one traversal: cut after every chunk, the first size % threads chunks get one extra node
+    SortTask tasks[PARALLEL_SORT_MAX_THREADS];
+    Node* n = head;
+    for (int t = 0; t < threads; t++) {
+        int length = size / threads + (t < size % threads);
+        tasks[t].head = n;
+        for (int i = 1; i < length; i++) n = n->next;
+        Node* next = n->next;
+        n->next = NULL;
+        n = next;
+    }
+
+    run_parallel(sort_worker, tasks, threads);
+
+    int lists = threads;
+    while (lists > 1) {
+        SortTask merges[PARALLEL_SORT_MAX_THREADS];
+        int pairs = lists / 2;
+        for (int i = 0; i < pairs; i++) {
+            merges[i].head = tasks[2 * i].result;
+            merges[i].other = tasks[2 * i + 1].result;
+        }
+        run_parallel(merge_worker, merges, pairs);
+
+        for (int i = 0; i < pairs; i++) tasks[i].result = merges[i].result;
+        if (lists % 2 == 1) tasks[pairs].result = tasks[lists - 1].result;  // odd one out waits a round
+        lists = pairs + lists % 2;
+    }
+
+    return tasks[0].result;
+}
+
+void list_parallel_merge_sort(List* list, int threads) {
+    list->head = parallel_merge_sort(list->head, list->size, threads);
+    Node* n = list->head;
+    while (n != NULL && n->next != NULL) n = n->next;
+    list->tail = n;
+}
+
+/*
+###############################
+###          tests          ###
+###############################
+*/
+static void assert_sorted(Node* head, int size) {
+    int count = 0;
+    for (Node* n = head; n != NULL; n = n->next) {
+        count++;
+        if (n->next != NULL) assert(n->data <= n->next->data);
+    }
+    assert(count == size);
+}
+
+void test_parallel_merge_sort() {
+    print_test_func_name();
+
+    int arr[] = {5, 1, 4, 2, 8, 0, 2, 9, 7, 3, 6};
+    int size = sizeof(arr) / sizeof(*arr);
+    for (int threads = 1; threads <= 8; threads++) {
+        Node* head = create_nodes_from_array(arr, size);
+        head = parallel_merge_sort(head, size, threads);
+        assert(head->data == 0);
+        assert_sorted(head, size);
+        free_all(head);
+    }
+
+    assert(parallel_merge_sort(NULL, 0, 4) == NULL);
+
+    passed();
+}
+
+// equal keys must keep their order even when they end up in different chunks
+void test_parallel_merge_sort_is_stable() {
+    print_test_func_name();
+
+    enum { SIZE = 1000 };
+    int arr[SIZE];
+    srand(3);
+    for (int i = 0; i < SIZE; i++) arr[i] = rand() % 10;
+    Node* head = create_nodes_from_array(arr, SIZE);
+    Node* original[SIZE];
+    Node* n = head;
+    for (int i = 0; i < SIZE; i++, n = n->next) original[i] = n;
+
+    head = parallel_merge_sort(head, SIZE, 7);
+
+    assert_sorted(head, SIZE);
+    int ties = 0;
+    for (n = head; n->next != NULL; n = n->next) {
+        if (n->data != n->next->data) continue;
+        int a = 0, b = 0;
+        while (original[a] != n) a++;
+        while (original[b] != n->next) b++;
+        assert(a < b);
+        ties++;
+    }
+    assert(ties > 0);
+
+    free_all(head);
+    passed();
+}
+
+void test_list_parallel_merge_sort() {
+    print_test_func_name();
+
+    int arr[] = {9, 3, 7, 1, 8, 2};
+    List* list = list_create_from_array(arr, 6);
+
+    list_parallel_merge_sort(list, 3);
+
+    assert(list->head->data == 1 && list->tail->data == 9 && list->tail->next == NULL);
+    assert_sorted(list->head, list_length(list));
+
+    list_free_all(list);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_SORT_SIZE 5000000
+
+static void bench_sort_threads(int* arr, int threads) {
+    char label[64];
+    NodeBlock block;
+    Node* head = bulk_create_nodes_from_array(&block, arr, BENCH_SORT_SIZE);
+
+    long long start = now_ns();
+    head = parallel_merge_sort(head, BENCH_SORT_SIZE, threads);
+    long long end = now_ns();
+    snprintf(label, sizeof(label), "threads=%d", threads);
+    print_bench_result(label, end - start, BENCH_SORT_SIZE);
+
+    bulk_free_all(&block, NULL);
+}
+
+// threads double up to the number of online cores (at least 2, at most PARALLEL_SORT_MAX_THREADS)
+void bench_parallel_merge_sort() {
+    print_test_func_name();
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("online cores: %ld\n", cores);  // scaling flattens past this
+    int* arr = (int*)malloc(sizeof(int) * BENCH_SORT_SIZE);
+    srand(1);
+    for (int i = 0; i < BENCH_SORT_SIZE; i++) arr[i] = rand();
+
+    int max_threads = cores < 2 ? 2 : cores > PARALLEL_SORT_MAX_THREADS ? PARALLEL_SORT_MAX_THREADS : (int)cores;
+    int threads = 1;
+    for (; threads < max_threads; threads *= 2) bench_sort_threads(arr, threads);
+    bench_sort_threads(arr, max_threads);
+
+    free(arr);
+}
+
+// harness cases: random values rewritten into the nodes before every run, sorted with one thread per online core
+static const int BENCH_SIZES[] = {100000, 1000000};
+
+typedef struct BenchState {
+    BenchCommon common;
+    Node* head;
+} BenchState;
+
+static void* bench_setup(int size) {
+    int* arr = (int*)calloc(size, sizeof(int));
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->head = create_nodes_from_array(arr, size);
+    bench_common_init(&state->common);
+    free(arr);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    free_all(((BenchState*)state)->head);
+    free(state);
+}
+
+static void bench_random_data(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    Node* n = b->head;
+    for (int i = 0; i < size; i++, n = n->next) n->data = (int)(bench_random(&b->common.seed) >> 1);
+}
+
+static long long bench_parallel_merge_sort_run(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    b->head = parallel_merge_sort(b->head, size, (int)sysconf(_SC_NPROCESSORS_ONLN));
+    return size;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"parallel_merge_sort (random)", bench_setup, bench_random_data, bench_parallel_merge_sort_run, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_parallel_merge_sort();
+        test_parallel_merge_sort_is_stable();
+        test_list_parallel_merge_sort();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_parallel_merge_sort();
+    }
+
+    return 0;
+}
@@ -3,16 +3,20 @@
 - Sublist from s to k inclusive, 1-indexed
 */
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "singly_linked_list.h"
 #include "test_helper.h"
 
 Node* reverse_sublist(Node* head, int s, int k) {
-    Node* sentinel = create_node(0);
-    sentinel->next = head;
-    Node* s_node_prev = sentinel;
+    Node sentinel;  // on the stack, nothing to free
+    sentinel.next = head;
+    Node* s_node_prev = &sentinel;
     for (int i = 1; i < s; i++) {
         s_node_prev = s_node_prev->next;
     }
@@ -32,7 +36,7 @@ Node* reverse_sublist(Node* head, int s, int k) {
     s_node_prev->next = sublist_head;
     sublist_tail->next = sec;  // sec is the (k+1)-th node
 
-    return sentinel->next;
+    return sentinel.next;
 }
 
 void test_reverse_sublist() {
@@ -58,13 +62,57 @@ void test_reverse_sublist() {
         n = n->next;
     }
     printf("\n");
+
+    free_all(head);
 }
 
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+static const int BENCH_SIZES[] = {1000, 100000, 1000000};
+
+typedef struct BenchState {
+    Node* head;
+} BenchState;
+
+static void* bench_setup(int size) {
+    int* arr = (int*)malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++) arr[i] = i;
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->head = create_nodes_from_array(arr, size);
+    free(arr);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    free_all(((BenchState*)state)->head);
+    free(state);
+}
+
+// the middle half, one op per node up to k (the walk to s included)
+static long long bench_reverse_sublist(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    int s = size / 4 + 1, k = size - size / 4;
+    b->head = reverse_sublist(b->head, s, k);
+    return k;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"reverse_sublist (middle half)", bench_setup, NULL, bench_reverse_sublist, bench_teardown},
+};
+
 int main(int argc, char** argv) {
     int should_run_tests = has_test_flag(argc, argv);
 
     if (should_run_tests)
         test_reverse_sublist();
 
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,286 @@
+/*
+- This trick runs many independent searches (each on its own list) at once to hide memory latency: AMAC style
+- A loop of search waits for one cache miss per node: n = n->next cannot start before the previous load is done
+- search_batch keeps a group of lookups in flight as small state machines {query, node}; each step compares one
+  node of one lookup, prefetches its next node and moves to the next lookup of the group, so by the time a lookup
+  comes around again its node is (hopefully) in cache: up to group misses overlap on a single core
+- A finished lookup writes its result and its slot takes the next query right away, so the group stays full until
+  the queries run out; results do not depend on the group size or on the order of completion
+- The group size is a tuning knob: it should cover the memory latency divided by the work per step, 8 to 16 on
+  most machines
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "singly_linked_list.h"
+#include "test_helper.h"
+
+#define SEARCH_BATCH_GROUP 12
+#define SEARCH_BATCH_MAX_GROUP 64
+
+Node* search(Node* head, int key) {
+    for (Node* n = head; n != NULL; n = n->next) {
+        if (n->data == key) return n;
+    }
+    return NULL;
+}
+
+typedef struct SearchSlot {
+    int query;  // index into keys and out, -1 once the queries have run out
+    Node* node;
+} SearchSlot;
+
+// out[i] = search(heads[i], keys[i]) for every i < n, with up to group lookups in flight
+void search_batch_group(Node** heads, const int* keys, Node** out, int n, int group) {
+    SearchSlot slots[SEARCH_BATCH_MAX_GROUP];
+    if (group < 1) group = 1;
+    if (group > SEARCH_BATCH_MAX_GROUP) group = SEARCH_BATCH_MAX_GROUP;
+
+    int next_query = 0;
+    int active = 0;
+    for (int s = 0; s < group; s++) {
+        slots[s].query = next_query < n ? next_query++ : -1;
+        if (slots[s].query < 0) continue;
+        slots[s].node = heads[slots[s].query];
+        __builtin_prefetch(slots[s].node);
+        active++;
+    }
+
+    while (active > 0) {
+        for (int s = 0; s < group; s++) {
+            SearchSlot* slot = &slots[s];
+            if (slot->query < 0) continue;
+
+            Node* node = slot->node;
+            if (node != NULL && node->data != keys[slot->query]) {
+                slot->node = node->next;
+                __builtin_prefetch(slot->node);
+                continue;
+            }
+
+            out[slot->query] = node;
+            if (next_query < n) {
+                slot->query = next_query++;
+                slot->node = heads[slot->query];
+                __builtin_prefetch(slot->node);
+            } else {
+                slot->query = -1;
+                active--;
+            }
+        }
+    }
+}
+
+void search_batch(Node** heads, int* keys, Node** out, int n) {
+    search_batch_group(heads, keys, out, n, SEARCH_BATCH_GROUP);
+}
+
+/*
+###############################
+###          tests          ###
+###############################
+*/
+void test_search_batch() {
+    print_test_func_name();
+
+    int a[] = {1, 2, 3};
+    int b[] = {4, 5};
+    int c[] = {6};
+    Node* heads[] = {create_nodes_from_array(a, 3), create_nodes_from_array(b, 2), create_nodes_from_array(c, 1), NULL};
+    Node* queried[] = {heads[0], heads[1], heads[2], heads[3], heads[0], heads[0]};
+    int keys[] = {3, 4, 7, 1, 9, 1};
+    Node* out[6];
+    for (int i = 0; i < 6; i++) out[i] = (Node*)&out;  // every slot must be written
+
+    search_batch(queried, keys, out, 6);
+    assert(out[0] == heads[0]->next->next && out[1] == heads[1]);
+    assert(out[2] == NULL && out[3] == NULL && out[4] == NULL);  // a miss, an empty list, a miss
+    assert(out[5] == heads[0]);
+
+    search_batch(queried, keys, out, 0);  // nothing to do
+    for (int i = 0; i < 3; i++) free_all(heads[i]);
+    passed();
+}
+
+// every group size, including 1 and more than the queries, against a loop of search
+void test_search_batch_matches_search() {
+    print_test_func_name();
+
+    enum { LISTS = 50, QUERIES = 300 };
+    Node* lists[LISTS];
+    int values[40];
+    uint32_t seed = 11;
+    for (int l = 0; l < LISTS; l++) {
+        int length = (int)(bench_random(&seed) % 40);
+        for (int i = 0; i < length; i++) values[i] = (int)(bench_random(&seed) % 30);
+        lists[l] = create_nodes_from_array(values, length);
+    }
+
+    Node* heads[QUERIES];
+    int keys[QUERIES];
+    Node* out[QUERIES];
+    for (int q = 0; q < QUERIES; q++) {
+        heads[q] = lists[bench_random(&seed) % LISTS];
+        keys[q] = (int)(bench_random(&seed) % 40);  // some keys are missing from every list
+    }
+
+    int groups[] = {1, 2, 7, 12, 64, 1000};
+    for (int g = 0; g < 6; g++) {
+        search_batch_group(heads, keys, out, QUERIES, groups[g]);
+        for (int q = 0; q < QUERIES; q++) assert(out[q] == search(heads[q], keys[q]));
+    }
+
+    for (int l = 0; l < LISTS; l++) free_all(lists[l]);
+    passed();
+}
+
+/*
+###############################
+###       benchmarks        ###
+###############################
+*/
+#define BENCH_LISTS 65536
+#define BENCH_LIST_LENGTH 256  // 16M nodes allocated one by one, much more than the LLC
+#define BENCH_QUERIES 65536
+
+// lists 0..lists-1 of length nodes with values 0..length-1, their nodes are scattered over the whole heap
+static Node** create_scattered_lists(int lists, int length) {
+    int total = lists * length;
+    Node** nodes = (Node**)malloc(sizeof(Node*) * total);
+    for (int i = 0; i < total; i++) nodes[i] = create_node(0);
+    uint32_t seed = BENCH_RANDOM_SEED;
+    Node* n = (Node*)bench_link_scattered((void**)nodes, total, offsetof(Node, next), &seed);
+    free(nodes);
+
+    // one scattered list of all nodes, cut into lists
+    Node** heads = (Node**)malloc(sizeof(Node*) * lists);
+    for (int l = 0; l < lists; l++) {
+        heads[l] = n;
+        for (int i = 0; i < length; i++) {
+            n->data = i;
+            Node* next = n->next;
+            if (i + 1 == length) n->next = NULL;
+            n = next;
+        }
+    }
+    return heads;
+}
+
+static void free_lists(Node** heads, int lists) {
+    for (int l = 0; l < lists; l++) free_all(heads[l]);
+    free(heads);
+}
+
+// random lists, random keys that are present: half a list walked per query on average
+void bench_search_batch() {
+    print_test_func_name();
+
+    Node** lists = create_scattered_lists(BENCH_LISTS, BENCH_LIST_LENGTH);
+    Node** heads = (Node**)malloc(sizeof(Node*) * BENCH_QUERIES);
+    int* keys = (int*)malloc(sizeof(int) * BENCH_QUERIES);
+    Node** out = (Node**)malloc(sizeof(Node*) * BENCH_QUERIES);
+    uint32_t seed = 3;
+    for (int q = 0; q < BENCH_QUERIES; q++) {
+        heads[q] = lists[bench_random(&seed) % BENCH_LISTS];
+        keys[q] = (int)(bench_random(&seed) % BENCH_LIST_LENGTH);
+    }
+    char label[64];
+
+    long long start = now_ns();
+    for (int q = 0; q < BENCH_QUERIES; q++) out[q] = search(heads[q], keys[q]);
+    print_bench_result("loop of search (per query)", now_ns() - start, BENCH_QUERIES);
+    for (int q = 0; q < BENCH_QUERIES; q++) assert(out[q]->data == keys[q]);
+
+    int groups[] = {1, 2, 4, 8, 12, 16, 32, 64};
+    for (int g = 0; g < 8; g++) {
+        start = now_ns();
+        search_batch_group(heads, keys, out, BENCH_QUERIES, groups[g]);
+        snprintf(label, sizeof(label), "search_batch group=%d (per query)", groups[g]);
+        print_bench_result(label, now_ns() - start, BENCH_QUERIES);
+        for (int q = 0; q < BENCH_QUERIES; q++) assert(out[q]->data == keys[q]);
+    }
+
+    free(out);
+    free(keys);
+    free(heads);
+    free_lists(lists, BENCH_LISTS);
+}
+
+// harness cases: size nodes scattered over lists of 64, one batch of 1024 random lookups per repetition
+#define BENCH_CASE_LIST_LENGTH 64
+#define BENCH_CASE_QUERIES 1024
+static const int BENCH_SIZES[] = {65536, 1048576, 8388608};
+
+typedef struct BenchState {
+    BenchCommon common;
+    Node** lists;
+    int list_count;
+    Node* heads[BENCH_CASE_QUERIES];
+    int keys[BENCH_CASE_QUERIES];
+    Node* out[BENCH_CASE_QUERIES];
+} BenchState;
+
+static void* bench_setup(int size) {
+    BenchState* state = (BenchState*)malloc(sizeof(*state));
+    state->list_count = size / BENCH_CASE_LIST_LENGTH > 0 ? size / BENCH_CASE_LIST_LENGTH : 1;
+    state->lists = create_scattered_lists(state->list_count, BENCH_CASE_LIST_LENGTH);
+    bench_common_init(&state->common);
+    return state;
+}
+
+static void bench_teardown(void* state) {
+    BenchState* b = (BenchState*)state;
+    free_lists(b->lists, b->list_count);
+    free(b);
+}
+
+static void bench_new_queries(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    (void)size;
+    for (int q = 0; q < BENCH_CASE_QUERIES; q++) {
+        b->heads[q] = b->lists[bench_random(&b->common.seed) % (uint32_t)b->list_count];
+        b->keys[q] = (int)(bench_random(&b->common.seed) % BENCH_CASE_LIST_LENGTH);
+    }
+}
+
+static long long bench_search_loop(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    (void)size;
+    for (int q = 0; q < BENCH_CASE_QUERIES; q++) b->out[q] = search(b->heads[q], b->keys[q]);
+    return BENCH_CASE_QUERIES;
+}
+
+static long long bench_search_batch_run(void* state, int size) {
+    BenchState* b = (BenchState*)state;
+    (void)size;
+    search_batch(b->heads, b->keys, b->out, BENCH_CASE_QUERIES);
+    return BENCH_CASE_QUERIES;
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"loop of search (per query)", bench_setup, bench_new_queries, bench_search_loop, bench_teardown},
+    {"search_batch (per query)", bench_setup, bench_new_queries, bench_search_batch_run, bench_teardown},
+};
+
+int main(int argc, char** argv) {
+    int should_run_tests = has_test_flag(argc, argv);
+
+    if (should_run_tests) {
+        test_search_batch();
+        test_search_batch_matches_search();
+    }
+
+    if (has_bench_flag(argc, argv)) {
+        BenchOptions options = bench_options(argc, argv, BENCH_SIZES, sizeof(BENCH_SIZES) / sizeof(*BENCH_SIZES));
+        bench_run(&options, BENCH_CASES, sizeof(BENCH_CASES) / sizeof(*BENCH_CASES));
+        if (options.format == BENCH_FORMAT_TEXT) bench_search_batch();
+    }
+
+    return 0;
+}